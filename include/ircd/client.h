@@ -52,6 +52,8 @@ struct ircd::client
 	size_t head_length {0};
 	size_t content_consumed {0};
 	resource::request request;
+	std::shared_ptr<http2::connection> h2;
+	uint32_t h2_stream {0};
 
 	size_t write_all(const net::const_buffers &);
 	size_t write_all(const const_buffer &);
@@ -64,11 +66,14 @@ struct ircd::client
 	void discard_unconsumed(const http::request::head &);
 	bool resource_request(const http::request::head &);
 	bool handle_request(parse::capstan &pc);
+	void h2_dispatch(http2::stream &);
+	bool h2_main();
 	bool main();
 
 	static char *read(client &, char *&start, char *const &stop); //TODO: XXX
 	static parse::read_closure read_closure(client &); //TODO: XXX
 	static void handle_requests(std::shared_ptr<client>);
+	static void handle_h2_stream(std::shared_ptr<client>);
 	static void handle_ready(std::shared_ptr<client>, const error_code &ec);
 	bool async();
 
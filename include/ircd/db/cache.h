@@ -33,6 +33,14 @@ namespace ircd::db
 	void capacity(rocksdb::Cache &, const size_t &);
 	bool capacity(rocksdb::Cache *const &, const size_t &);
 
+	// Get capacity of the compressed secondary tier (zero if none)
+	size_t secondary_capacity(const rocksdb::Cache &);
+	size_t secondary_capacity(const rocksdb::Cache *const &);
+
+	// Set capacity of the compressed secondary tier
+	bool secondary_capacity(rocksdb::Cache &, const size_t &);
+	bool secondary_capacity(rocksdb::Cache *const &, const size_t &);
+
 	// Get usage
 	size_t usage(const rocksdb::Cache &);
 	size_t usage(const rocksdb::Cache *const &);
@@ -180,6 +188,23 @@ ircd::db::capacity(const rocksdb::Cache *const &cache)
 		0UL;
 }
 
+inline bool
+ircd::db::secondary_capacity(rocksdb::Cache *const &cache,
+                             const size_t &cap)
+{
+	return cache?
+		secondary_capacity(*cache, cap):
+		false;
+}
+
+inline size_t
+ircd::db::secondary_capacity(const rocksdb::Cache *const &cache)
+{
+	return cache?
+		secondary_capacity(*cache):
+		0UL;
+}
+
 inline uint64_t
 ircd::db::ticker(const rocksdb::Cache *const &cache,
                  const uint32_t &ticker_id)
@@ -88,6 +88,12 @@ struct ircd::db::descriptor
 	// replaced by the string in the ircd.db.compression.default conf item.
 	std::string compression {"default"};
 
+	/// Maximum size of the compression dictionary trained from samples of
+	/// each bottommost-level SST; zero disables dictionaries. Effective for
+	/// small blocks of repetitive values (keys, server names, signatures)
+	/// which otherwise compress poorly on their own.
+	size_t compression_dict {0};
+
 	/// User given compaction callback surface.
 	db::compactor compactor {};
 
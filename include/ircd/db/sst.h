@@ -35,6 +35,7 @@ struct ircd::db::database::sst::info
 	std::string merge_operator;
 	std::string prefix_extractor;
 	std::string compression;
+	std::string compression_opts;
 	std::string checksum;
 	std::string checksum_func;
 	uint64_t id {0};
@@ -57,6 +58,7 @@ struct ircd::db::database::sst::info
 	uint64_t entries {0};
 	uint64_t range_deletes {0};
 	uint64_t fixed_key_len {0};
+	uint64_t compression_dict {0};  // max_dict_bytes when written
 	uint64_t min_seq {0};
 	uint64_t max_seq {0};
 	std::string min_key;
@@ -25,6 +25,11 @@ namespace ircd::ed25519
 	struct pk;
 	struct sk;
 	struct sig;
+
+	// Verify many signatures at once; each result is set in the first
+	// argument and the number of valid signatures is returned. Large batches
+	// are conducted on an offload thread (see ircd::ctx::ole).
+	size_t verify(const vector_view<bool> &, const vector_view<const const_buffer> &msg, const vector_view<const sig> &, const vector_view<const pk> &);
 }
 
 class ircd::ed25519::sk
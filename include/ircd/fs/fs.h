@@ -45,6 +45,7 @@ namespace ircd::fs
 #include "write.h"
 #include "sync.h"
 #include "aio.h"
+#include "iou.h"
 #include "select.h"
 #include "stdin.h"
 #include "support.h"
@@ -0,0 +1,59 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2022 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_FS_IOU_H
+
+/// io_uring(7) interface. Requests are submitted through the io_uring
+/// instance driving the core asio event loop; submissions made during the
+/// same ios tick are flushed to the kernel together and completions are
+/// reaped from the shared ring without additional system calls. The same
+/// read_op/read_opts/write_opts interface as fs::aio is offered, and the
+/// backend is selected at runtime: when disabled (or unavailable) requests
+/// fall through to fs::aio and then to synchronous system calls.
+namespace ircd::fs::iou
+{
+	struct stats;
+
+	extern conf::item<bool> enable;
+	extern struct stats stats;
+
+	bool available() noexcept;
+	string_view backend() noexcept;
+}
+
+struct ircd::fs::iou::stats
+{
+	using item = ircd::stats::item<uint64_t *>;
+
+	uint64_t value[24];
+	size_t items;
+
+	item requests;             ///< count of requests created
+	item complete;             ///< count of requests completed successfully
+	item batches;              ///< count of vectored submissions
+	item cancel;               ///< count of requests canceled
+	item errors;               ///< count of response errcodes
+	item reads;                ///< count of read complete
+	item writes;               ///< count of write complete
+
+	item bytes_requests;       ///< total bytes for requests created
+	item bytes_complete;       ///< total bytes for requests completed
+	item bytes_read;           ///< total bytes for read completed
+	item bytes_write;          ///< total bytes for write completed
+
+	item cur_reads;            ///< pending reads
+	item cur_writes;           ///< pending writes
+	item max_reads;            ///< maximum observed pending reads
+	item max_writes;           ///< maximum observed pending writes
+	item max_batch;            ///< maximum observed vectored submission
+
+	stats();
+};
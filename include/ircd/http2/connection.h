@@ -0,0 +1,88 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_HTTP2_CONNECTION_H
+
+namespace ircd::http2
+{
+	struct connection;
+
+	extern conf::item<bool> enable;
+}
+
+/// Server side of an HTTP/2 connection. The connection reads and demuxes
+/// frames from the socket; once a stream has received its complete request
+/// it is handed to the dispatch closure as an HTTP/1.1 request (see:
+/// request()) to be conducted on its own context. The handler's HTTP/1.1
+/// response is written through write() which translates it to HEADERS and
+/// DATA frames on the stream, waiting on flow control as required.
+///
+/// All members are used from contexts on the main thread; writes to the
+/// socket are serialized by the write_mutex.
+struct ircd::http2::connection
+{
+	using dispatch = std::function<void (stream &)>;
+
+	static log::log log;
+	static conf::item<size_t> max_streams;
+	static conf::item<size_t> window_size;
+	static conf::item<size_t> header_max;
+	static conf::item<size_t> content_max;
+	static conf::item<milliseconds> stall_timeout;
+
+	std::shared_ptr<net::socket> sock;
+	struct settings ours, theirs;
+	hpack::decoder decoder;
+	std::map<uint32_t, std::shared_ptr<stream>> streams;
+	unique_buffer<mutable_buffer> in;
+	size_t in_len {0};
+	int64_t window {65535};
+	int64_t recv_window {65535};
+	size_t recv_unacked {0};
+	uint32_t last_id {0};
+	uint32_t continuation {0};
+	bool preface {false};
+	bool closing {false};
+	ctx::mutex write_mutex;
+	ctx::dock dock;
+
+  private:
+	void write_frame(const frame::type &, const uint8_t &flags, const uint32_t &id, const const_buffer &payload = {});
+	void write_data(stream &, const const_buffer &, const bool &eos);
+	void write_head(stream &);
+	size_t write_body(stream &, const const_buffer &);
+	void goaway(const enum error::code &);
+	void rst(stream &, const enum error::code &);
+
+	void handle_headers(const frame::header &, const_buffer, const dispatch &);
+	void handle_continuation(const frame::header &, const const_buffer &, const dispatch &);
+	void handle_data(const frame::header &, const_buffer, const dispatch &);
+	void handle_settings(const frame::header &, const const_buffer &);
+	void handle_window_update(const frame::header &, const const_buffer &);
+	void handle_rst_stream(const frame::header &, const const_buffer &);
+	void handle_ping(const frame::header &, const const_buffer &);
+	void handle_goaway(const frame::header &, const const_buffer &);
+	void handle_frame(const frame::header &, const const_buffer &, const dispatch &);
+	void ready(stream &, const dispatch &);
+
+  public:
+	stream *find(const uint32_t &id);
+	unique_buffer<mutable_buffer> request(stream &);
+	size_t write(stream &, const const_buffer &);
+	void cancel(const uint32_t &id);
+	void finish(const uint32_t &id);
+	bool handle(const dispatch &);
+
+	connection(std::shared_ptr<net::socket>);
+	connection(connection &&) = delete;
+	connection(const connection &) = delete;
+	~connection() noexcept;
+};
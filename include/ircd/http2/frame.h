@@ -14,6 +14,20 @@
 namespace ircd::http2
 {
 	struct frame;
+
+	uint32_t parse32(const const_buffer &);
+	const_buffer write32(const mutable_buffer &, const uint32_t &);
+}
+
+/// Frame header flags; the meaning of each bit depends on the frame type.
+namespace ircd::http2::flag
+{
+	constexpr uint8_t
+	END_STREAM   {0x01},
+	ACK          {0x01},
+	END_HEADERS  {0x04},
+	PADDED       {0x08},
+	PRIORITY     {0x20};
 }
 
 struct ircd::http2::frame
@@ -21,8 +35,13 @@ struct ircd::http2::frame
 	struct header;
 	struct settings;
 	enum type :uint8_t;
+	using sink = std::function<void (const const_buffer &header, const const_buffer &payload)>;
 
 	static string_view reflect(const type &);
+	static header read(const const_buffer &);
+	static const_buffer payload(const header &, const_buffer);
+	static void write(const mutable_buffer &, const size_t &len, const type &, const uint8_t &flags, const uint32_t &id);
+	static void write_block(const const_buffer &block, const uint32_t &id, const size_t &max_frame, const bool &eos, const sink &);
 };
 
 struct ircd::http2::frame::header
@@ -0,0 +1,50 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_HTTP2_HPACK_H
+
+/// RFC 7541 header compression. The decoder is complete, including the
+/// dynamic table and Huffman coded strings. The encoder is stateless: it
+/// refers to the static table where it can and otherwise emits literals
+/// without indexing, so it never requires the peer to maintain any state
+/// on our behalf.
+namespace ircd::http2::hpack
+{
+	struct table;
+	struct decoder;
+	using header = std::pair<string_view, string_view>;
+	using closure = std::function<void (const header &)>;
+
+	extern const header static_table[61];
+
+	size_t huffman_decode(const mutable_buffer &out, const const_buffer &in);
+	size_t encode(const mutable_buffer &out, const header &);
+}
+
+/// Dynamic table (RFC 7541 2.3.2)
+struct ircd::http2::hpack::table
+{
+	std::deque<std::pair<std::string, std::string>> entry;
+	size_t bytes {0};
+	size_t max {4096};
+
+	header at(const size_t &index) const;
+	void resize(const size_t &max);
+	void add(const header &);
+};
+
+struct ircd::http2::hpack::decoder
+{
+	table dynamic;
+	size_t max_size {4096};
+
+	void operator()(const const_buffer &block, const closure &);
+};
@@ -21,8 +21,12 @@ struct ircd::http2::frame::settings
 	enum code :uint16_t;
 	enum flag :decltype(frame::header::flags);
 	struct param;
+	using closure = std::function<void (const code &, const uint32_t &)>;
 
 	vector_view<const struct param> param;
+
+	static bool read(const header &, const const_buffer &, const closure &);
+	static const_buffer write(const mutable_buffer &, const vector_view<const struct param> &);
 };
 
 struct ircd::http2::frame::settings::param
@@ -62,5 +66,8 @@ struct ircd::http2::settings
 	using code = frame::settings::code;
 	using array_type = std::array<uint32_t, num_of<code>()>;
 
+	uint32_t &operator[](const code &c)              { return array_type::operator[](uint16_t(c) - 1); }
+	const uint32_t &operator[](const code &c) const  { return array_type::operator[](uint16_t(c) - 1); }
+
 	settings();
 };
@@ -16,12 +16,34 @@ namespace ircd::http2
 	struct stream;
 }
 
+namespace ircd::ctx
+{
+	struct ctx;
+}
+
 struct ircd::http2::stream
 {
 	enum class state :uint8_t;
 
+	uint32_t id {0};
 	enum state state;
+	int64_t window {0};                // send window
+	int64_t recv_window {0};           // receive window
+	bool reset {false};                // RST_STREAM sent or received
+	bool cancelled {false};            // RST_STREAM to be sent at finish
+	bool dispatched {false};           // request handed off
+	std::string block;                 // header block fragments
+	std::string head;                  // request head; then response head
+	std::string content;               // request content
+	ctx::ctx *context {nullptr};       // context handling the request
+
+	// Translation of the HTTP/1.1 response written by the handler.
+	std::string chunk;                 // chunk size line until complete
+	size_t remain {0};                 // content-length or chunk remaining
+	size_t sent {0};                   // DATA payload bytes sent
+	uint8_t phase {0};                 // response translation phase
 
+	stream(const uint32_t &id);
 	stream();
 };
 
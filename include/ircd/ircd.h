@@ -91,7 +91,6 @@
 #include "openssl.h"
 #include "pbc.h"
 #include "http.h"
-#include "http2/http2.h"
 #include "conf.h"
 #include "magic.h"
 #include "stats.h"
@@ -106,9 +105,11 @@
 #include "js.h"
 #include "mods/mods.h"
 #include "net/net.h"
+#include "http2/http2.h"
 #include "server/server.h"
 #include "rest.h"
 #include "png.h"
+#include "zstd.h"
 #include "beep.h"
 #include "magick.h"
 #include "resource/resource.h"
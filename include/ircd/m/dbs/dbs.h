@@ -59,6 +59,12 @@ namespace ircd::m::dbs::appendix
 #include "room_state_space.h"       // room_id | type, state_key, depth, event_idx
 #include "room_joined.h"            // room_id | origin, member => event_idx
 #include "room_head.h"              // room_id | event_id => event_idx
+#include "room_unread.h"            // room_id | user_id => counts
+#include "room_search.h"            // term | room_id, event_idx
+#include "room_threads.h"           // room_id | root => latest, count
+#include "media_block.h"            // room_id | offset => (binary)
+#include "media_thumbnail.h"        // room_id | method, width, height => (binary)
+#include "fed_queue.h"              // remote | event_idx => ()
 #include "init.h"
 #include "opts.h"
 
@@ -36,6 +36,7 @@ namespace ircd::m::dbs
 namespace ircd::m::dbs::desc
 {
 	extern conf::item<std::string> _event__comp;
+	extern conf::item<size_t> _event__comp__dict__size;
 	extern conf::item<size_t> _event__bloom__bits;
 
 	extern conf::item<std::string> content__comp;
@@ -21,6 +21,7 @@ namespace ircd::m::dbs
 namespace ircd::m::dbs::desc
 {
 	extern conf::item<std::string> event_idx__comp;
+	extern conf::item<size_t> event_idx__comp__dict__size;
 	extern conf::item<size_t> event_idx__block__size;
 	extern conf::item<size_t> event_idx__meta_block__size;
 	extern conf::item<size_t> event_idx__cache__size;
@@ -42,6 +42,7 @@ namespace ircd::m::dbs
 namespace ircd::m::dbs::desc
 {
 	extern conf::item<std::string> event_sender__comp;
+	extern conf::item<size_t> event_sender__comp__dict__size;
 	extern conf::item<size_t> event_sender__block__size;
 	extern conf::item<size_t> event_sender__meta_block__size;
 	extern conf::item<size_t> event_sender__cache__size;
@@ -0,0 +1,43 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_FED_QUEUE_H
+
+namespace ircd::m::dbs
+{
+	constexpr size_t FED_QUEUE_KEY_MAX_SIZE
+	{
+		rfc3986::DOMAIN_BUFSIZE + 1 + 8
+	};
+
+	string_view fed_queue_key(const mutable_buffer &out, const string_view &remote, const event::idx &);
+	string_view fed_queue_key(const mutable_buffer &out, const string_view &remote);
+	event::idx fed_queue_key(const string_view &amalgam);
+
+	// remote | event_idx => ()
+	//
+	// N.B. This column is not written by the event transaction; it is
+	// maintained by the federation sender.
+	extern db::domain fed_queue;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<std::string> fed_queue__comp;
+	extern conf::item<size_t> fed_queue__comp__dict__size;
+	extern conf::item<size_t> fed_queue__block__size;
+	extern conf::item<size_t> fed_queue__meta_block__size;
+	extern conf::item<size_t> fed_queue__cache__size;
+	extern conf::item<size_t> fed_queue__cache_comp__size;
+	extern conf::item<size_t> fed_queue__bloom__bits;
+	extern const db::prefix_transform fed_queue__pfx;
+	extern const db::descriptor fed_queue;
+}
@@ -0,0 +1,43 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_MEDIA_BLOCK_H
+
+namespace ircd::m::dbs
+{
+	constexpr size_t MEDIA_BLOCK_KEY_MAX_SIZE
+	{
+		id::MAX_SIZE + 1 + 8
+	};
+
+	string_view media_block_key(const mutable_buffer &out, const id::room &, const size_t &offset);
+	string_view media_block_key(const mutable_buffer &out, const id::room &);
+	size_t media_block_key(const string_view &amalgam);
+
+	// room_id | offset => (binary)
+	//
+	// N.B. This column is not written by the event transaction; it is
+	// maintained by m::media::file (see: m/media.h).
+	extern db::domain media_block;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<std::string> media_block__comp;
+	extern conf::item<size_t> media_block__comp__dict__size;
+	extern conf::item<size_t> media_block__block__size;
+	extern conf::item<size_t> media_block__meta_block__size;
+	extern conf::item<size_t> media_block__cache__size;
+	extern conf::item<size_t> media_block__cache_comp__size;
+	extern conf::item<size_t> media_block__bloom__bits;
+	extern const db::prefix_transform media_block__pfx;
+	extern const db::descriptor media_block;
+}
@@ -0,0 +1,42 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_MEDIA_THUMBNAIL_H
+
+namespace ircd::m::dbs
+{
+	constexpr size_t MEDIA_THUMBNAIL_KEY_MAX_SIZE
+	{
+		id::MAX_SIZE + 1 + 1 + 4 + 4
+	};
+
+	string_view media_thumbnail_key(const mutable_buffer &out, const id::room &, const char &method, const pair<size_t> &dimension);
+	string_view media_thumbnail_key(const mutable_buffer &out, const id::room &);
+
+	// room_id | method, width, height => (binary)
+	//
+	// N.B. This column is not written by the event transaction; it is
+	// maintained by the media thumbnail resource.
+	extern db::domain media_thumbnail;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<std::string> media_thumbnail__comp;
+	extern conf::item<size_t> media_thumbnail__comp__dict__size;
+	extern conf::item<size_t> media_thumbnail__block__size;
+	extern conf::item<size_t> media_thumbnail__meta_block__size;
+	extern conf::item<size_t> media_thumbnail__cache__size;
+	extern conf::item<size_t> media_thumbnail__cache_comp__size;
+	extern conf::item<size_t> media_thumbnail__bloom__bits;
+	extern const db::prefix_transform media_thumbnail__pfx;
+	extern const db::descriptor media_thumbnail;
+}
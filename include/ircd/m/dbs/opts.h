@@ -142,4 +142,8 @@ enum ircd::m::dbs::appendix::index
 
 	/// Take branch to handle room redaction events.
 	ROOM_REDACT,
+
+	/// Involves room_search table. Redaction events remove the postings
+	/// of their target.
+	ROOM_SEARCH,
 };
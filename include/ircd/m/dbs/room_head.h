@@ -31,6 +31,7 @@ namespace ircd::m::dbs
 namespace ircd::m::dbs::desc
 {
 	extern conf::item<std::string> room_head__comp;
+	extern conf::item<size_t> room_head__comp__dict__size;
 	extern conf::item<size_t> room_head__block__size;
 	extern conf::item<size_t> room_head__meta_block__size;
 	extern conf::item<size_t> room_head__cache__size;
@@ -0,0 +1,62 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_ROOM_SEARCH_H
+
+namespace ircd::m::dbs
+{
+	using room_search_tuple = std::tuple<string_view, event::idx>;
+	using room_search_closure = util::function_bool<const string_view &>;
+
+	constexpr size_t ROOM_SEARCH_TERM_MAX_SIZE
+	{
+		48
+	};
+
+	constexpr size_t ROOM_SEARCH_KEY_MAX_SIZE
+	{
+		ROOM_SEARCH_TERM_MAX_SIZE      // term
+		+ 1                            // \0
+		+ id::MAX_SIZE                 // room_id
+		+ 1                            // \0
+		+ 8                            // u64
+	};
+
+	bool room_search_terms(const string_view &text, const room_search_closure &);
+
+	room_search_tuple
+	room_search_key(const string_view &amalgam);
+
+	string_view
+	room_search_key(const mutable_buffer &out,
+	                const string_view &term,
+	                const id::room & = {},
+	                const event::idx & = -1);
+
+	void _index_room_search(db::txn &, const event &, const opts &);
+
+	// term | room_id, event_idx
+	extern db::domain room_search;
+}
+
+namespace ircd::m::dbs::desc
+{
+	// room full-text search
+	extern conf::item<std::string> room_search__comp;
+	extern conf::item<size_t> room_search__comp__dict__size;
+	extern conf::item<size_t> room_search__block__size;
+	extern conf::item<size_t> room_search__meta_block__size;
+	extern conf::item<size_t> room_search__cache__size;
+	extern conf::item<size_t> room_search__cache_comp__size;
+	extern const db::prefix_transform room_search__pfx;
+	extern const db::comparator room_search__cmp;
+	extern const db::descriptor room_search;
+}
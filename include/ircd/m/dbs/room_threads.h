@@ -0,0 +1,56 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_ROOM_THREADS_H
+
+namespace ircd::m::dbs
+{
+	using room_threads_tuple = std::tuple<event::idx, event::idx>;
+
+	constexpr size_t ROOM_THREADS_KEY_MAX_SIZE
+	{
+		id::MAX_SIZE                   // room_id
+		+ 1                            // \0
+		+ 1                            // kind
+		+ 8                            // u64
+		+ 8                            // u64
+		+ id::MAX_SIZE                 // user_id
+	};
+
+	// room_id | R, root => latest, count
+	string_view room_threads_root_key(const mutable_buffer &out, const id::room &, const event::idx &root);
+
+	// room_id | A, latest, root
+	string_view room_threads_latest_key(const mutable_buffer &out, const id::room &, const event::idx &latest = -1, const event::idx &root = -1);
+	room_threads_tuple room_threads_latest_key(const string_view &amalgam);
+
+	// room_id | P, root, user_id
+	string_view room_threads_user_key(const mutable_buffer &out, const id::room &, const event::idx &root, const id::user &);
+
+	// room_id | kind, ...
+	//
+	// N.B. This column is not written by the event transaction; it is
+	// maintained by m::room::threads (see: m/room/threads.h).
+	extern db::domain room_threads;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<std::string> room_threads__comp;
+	extern conf::item<size_t> room_threads__comp__dict__size;
+	extern conf::item<size_t> room_threads__block__size;
+	extern conf::item<size_t> room_threads__meta_block__size;
+	extern conf::item<size_t> room_threads__cache__size;
+	extern conf::item<size_t> room_threads__cache_comp__size;
+	extern conf::item<size_t> room_threads__bloom__bits;
+	extern const db::prefix_transform room_threads__pfx;
+	extern const db::descriptor room_threads;
+}
@@ -0,0 +1,42 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_DBS_ROOM_UNREAD_H
+
+namespace ircd::m::dbs
+{
+	constexpr size_t ROOM_UNREAD_KEY_MAX_SIZE
+	{
+		id::MAX_SIZE + 1 + id::MAX_SIZE
+	};
+
+	string_view room_unread_key(const mutable_buffer &out, const id::room &, const id::user &);
+	string_view room_unread_key(const mutable_buffer &out, const id::room &);
+
+	// room_id | user_id => notification_count, highlight_count
+	//
+	// N.B. This column is not written by the event transaction; it is
+	// maintained by m::user::unread (see: m/user/unread.h).
+	extern db::domain room_unread;
+}
+
+namespace ircd::m::dbs::desc
+{
+	extern conf::item<std::string> room_unread__comp;
+	extern conf::item<size_t> room_unread__comp__dict__size;
+	extern conf::item<size_t> room_unread__block__size;
+	extern conf::item<size_t> room_unread__meta_block__size;
+	extern conf::item<size_t> room_unread__cache__size;
+	extern conf::item<size_t> room_unread__cache_comp__size;
+	extern conf::item<size_t> room_unread__bloom__bits;
+	extern const db::prefix_transform room_unread__pfx;
+	extern const db::descriptor room_unread;
+}
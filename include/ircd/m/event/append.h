@@ -42,6 +42,7 @@ struct ircd::m::event::append
 	bool is_excluded(const event &, const opts &) const;
 
 	bool bundle_replace(json::stack::object &, const event &, const opts &);
+	bool bundle_thread(json::stack::object &, const event &, const opts &);
 	void _relations(json::stack::object &, const event &, const opts &);
 	void _age(json::stack::object &, const event &, const opts &);
 	void _txnid(json::stack::object &, const event &, const opts &);
@@ -76,6 +77,7 @@ struct ircd::m::event::append::opts
 	bool query_visible {false};
 	bool bundle_all {false};
 	bool bundle_replace {false};
+	bool bundle_thread {false};
 };
 
 inline
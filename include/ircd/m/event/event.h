@@ -55,6 +55,7 @@ namespace ircd::m
 	bool verify(const event &, const string_view &origin, const string_view &pkid); // io/yield
 	bool verify(const event &, const string_view &origin); // io/yield
 	bool verify(const event &); // io/yield
+	size_t verify(const vector_view<bool> &, const vector_view<const event *const> &); // io/yield
 
 	sha256::buf hash(const event &);
 	ed25519::sig sign(const event &, const ed25519::sk &);
@@ -48,6 +48,7 @@ struct ircd::m::event::fetch
 	using views_closure = std::function<void (const vector_view<const string_view> &)>;
 
 	static const opts default_opts;
+	static const size_t batch_max;
 
 	const opts *fopts {&default_opts};
 	idx event_idx {0};
@@ -112,3 +113,12 @@ struct ircd::m::event::fetch::opts
 	opts(const db::gopts &, const event::keys::selection & = {});
 	opts() noexcept;
 };
+
+namespace ircd::m
+{
+	using seek_closure = util::function_bool<const event::idx &, const event &>;
+
+	// Vectored seek; the closure is invoked in order for each event found.
+	size_t seek(std::nothrow_t, const vector_view<const event::idx> &, const event::fetch::opts &, const seek_closure &);
+	size_t seek(std::nothrow_t, const vector_view<const event::idx> &, const seek_closure &);
+}
@@ -32,6 +32,7 @@ namespace ircd::m::media::file
 	room::id room_id(room::id::buf &out, const mxc &);
 	room::id::buf room_id(const mxc &);
 
+	size_t read(const room &, const size_t &offset, const size_t &length, const closure &);
 	size_t read(const room &, const closure &);
 	size_t write(const room &, const user::id &, const const_buffer &content, const string_view &content_type, const string_view &name = {});
 
@@ -31,6 +31,8 @@ struct ircd::m::room::purge
 
 	bool match(const event::idx &, const event &) const;
 	bool match(const uint64_t &, const event::idx &) const;
+	bool whole() const;
+	void media();
 	void timeline();
 	void state();
 	void commit();
@@ -76,6 +78,10 @@ struct ircd::m::room::purge::opts
 	/// if other options permit.
 	bool timeline {true};
 
+	/// Set to false to keep the content of a media room. The content is
+	/// only purged when the whole room is purged.
+	bool media {true};
+
 	/// Log an INFO message for the final transaction; takes precedence
 	/// if both debuglog and infolog are true.
 	bool infolog_txn {false};
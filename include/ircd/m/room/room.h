@@ -131,6 +131,7 @@ struct ircd::m::room
 	struct messages;
 	struct bootstrap;
 	struct purge;
+	struct threads;
 
 	using id = m::id::room;
 	using alias = m::id::room_alias;
@@ -221,6 +222,7 @@ struct ircd::m::room
 #include "messages.h"
 #include "bootstrap.h"
 #include "purge.h"
+#include "threads.h"
 
 inline
 ircd::m::room::room(const id &room_id,
@@ -0,0 +1,57 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_ROOM_THREADS_H
+
+/// Interface to the threads of a room. A summary of each thread root is
+/// maintained as m.thread relations are evaluated (see: dbs::room_threads),
+/// so listing the threads by activity and bundling a thread's aggregation
+/// with its root are bounded reads rather than walks of the relations.
+struct ircd::m::room::threads
+{
+	struct summary;
+	using closure = util::function_bool<const event::idx &, const summary &>;
+
+	m::room room;
+
+  private:
+	summary _rebuild(const event::idx &root) const;
+
+  public:
+	// Thread roots by most recent reply, from below `latest`.
+	bool for_each(const event::idx &latest, const closure &) const;
+	bool for_each(const closure &) const;
+
+	bool get(std::nothrow_t, const event::idx &root, summary &) const;
+	bool participated(const event::idx &root, const id::user &) const;
+	bool has(const event::idx &root) const;
+
+	summary add(const event::idx &root, const event::idx &reply, const id::user &sender) const;
+
+	// Recount from the m.thread relations of the root(s); for replies which
+	// predate the column or arrived before their root.
+	summary rebuild(const event::idx &root) const;
+	size_t rebuild() const;
+
+	threads(const m::room &room) noexcept;
+};
+
+struct ircd::m::room::threads::summary
+{
+	event::idx latest {0};
+	uint64_t count {0};
+};
+
+inline
+ircd::m::room::threads::threads(const m::room &room)
+noexcept
+:room{room}
+{}
@@ -54,13 +54,16 @@ struct ircd::m::search::query
 {
 	user::id user_id;
 	size_t batch {-1UL};
+	event::idx batch_idx {-1UL};
 	search::room_events room_events;
 	room_event_filter filter;
 	string_view search_term;
+	vector_view<const string_view> terms;
 	size_t limit {-1UL};
 	ushort before_limit {0};
 	ushort after_limit {0};
 	bool case_sensitive {false};
+	bool order_rank {true};
 };
 
 struct ircd::m::search::result
@@ -72,6 +75,8 @@ struct ircd::m::search::result
 	size_t matched {0};
 	size_t appends {0};
 	size_t count {0};
+	size_t total {0};
 	event::idx event_idx {0UL};
 	long rank {0L};
+	std::string next_batch;
 };
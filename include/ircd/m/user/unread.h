@@ -0,0 +1,51 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_M_USER_UNREAD_H
+
+/// Materialized unread counters for a user in a room. These are incremented
+/// by the push rule evaluator as notifications are generated, and recounted
+/// from the user's notifications whenever their read marker advances. Reading
+/// them is a point lookup in dbs::room_unread; a room without an entry (e.g.
+/// one which predates the column) is recounted on its first read.
+struct ircd::m::user::unread
+{
+	struct counts;
+
+	m::user user;
+
+  public:
+	bool get(std::nothrow_t, const room::id &, counts &) const;
+	counts get(const room::id &) const; // rebuilt when none
+
+	void incr(const room::id &, const bool &highlight) const;
+	counts reset(const room::id &, const event::idx &marker) const;
+
+	// Recount from the user's current read marker; for counters which
+	// predate the column or otherwise drifted.
+	event::idx marker(const room::id &) const;
+	counts rebuild(const room::id &) const;
+	size_t rebuild() const; // all joined rooms
+
+	unread(const m::user &user) noexcept;
+};
+
+struct ircd::m::user::unread::counts
+{
+	uint64_t notification {0};  // includes highlights
+	uint64_t highlight {0};
+};
+
+inline
+ircd::m::user::unread::unread(const m::user &user)
+noexcept
+:user{user}
+{}
@@ -49,6 +49,7 @@ struct ircd::m::user
 	struct pushrules;
 	struct pushers;
 	struct notifications;
+	struct unread;
 	struct tokens;
 	struct devices;
 	struct reading;
@@ -107,6 +108,7 @@ const
 #include "pushrules.h"
 #include "pushers.h"
 #include "notifications.h"
+#include "unread.h"
 #include "tokens.h"
 #include "devices.h"
 #include "reading.h"
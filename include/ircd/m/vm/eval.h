@@ -69,6 +69,7 @@ struct ircd::m::vm::eval
 	hook::base *hook {nullptr};
 	vm::phase phase {vm::phase(0)};
 	bool room_internal {false};
+	bool verified {false};
 
   public:
 	operator const event::id::buf &() const
@@ -111,6 +111,11 @@ struct ircd::m::vm::opts
 	/// perform a parallel/mass fetch before proceeding with the evals.
 	bool mfetch_keys {true};
 
+	/// Whether to verify the signatures of an input vector of events together
+	/// (see: ed25519::verify()) before proceeding with the evals. Events which
+	/// fail the batch are verified individually during their eval.
+	bool mverify {true};
+
 	/// Whether to launch prefetches for all event_id's (found at standard
 	/// locations) from the input vector, in addition to some other related
 	/// local db prefetches. Disabled by default because it operates prior
@@ -37,6 +37,8 @@ ircd::net::acceptor
 	IRCD_EXCEPTION(listener::error, error)
 	IRCD_EXCEPTION(error, sni_warning)
 
+	struct ticket_key;
+
 	static constexpr bool debug_alpn {false};
 
 	static log::log log;
@@ -48,6 +50,13 @@ ircd::net::acceptor
 	static conf::item<std::string> ssl_curve_list;
 	static conf::item<std::string> ssl_cipher_list;
 	static conf::item<std::string> ssl_cipher_blacklist;
+	static conf::item<size_t> ssl_session_cache_size;
+	static conf::item<seconds> ssl_session_timeout;
+	static conf::item<bool> ssl_ticket_enable;
+	static conf::item<seconds> ssl_ticket_rotate;
+	static stats::item<uint64_t> handshake_full;
+	static stats::item<uint64_t> handshake_resumed;
+	static std::deque<ticket_key> ticket_keys;
 
 	std::string name;
 	std::string opts;
@@ -73,12 +82,15 @@ ircd::net::acceptor
 	void configure_flags(const json::object &);
 	void configure_password(const json::object &);
 	void configure_sni(const json::object &);
+	void configure_session(const json::object &);
 	bool configure(const json::object &opts);
 
 	// Completion stack
 	void accepted(const std::shared_ptr<socket> &);
 
 	// Handshake stack
+	static const ticket_key *find_ticket_key(const const_buffer &name);
+	static const ticket_key &rotate_ticket_key();
 	bool handle_sni(socket &, int &ad);
 	string_view handle_alpn(socket &, const vector_view<const string_view> &in);
 	void check_handshake_error(const error_code &ec, socket &) const;
@@ -107,3 +119,14 @@ ircd::net::acceptor
 
 	~acceptor() noexcept;
 };
+
+/// Key material for the session tickets issued by all listeners. The newest
+/// key encrypts new tickets; older keys still decrypt tickets issued before
+/// a rotation until they expire.
+struct ircd::net::acceptor::ticket_key
+{
+	char name[16];
+	char aes[32];
+	char hmac[32];
+	system_point created;
+};
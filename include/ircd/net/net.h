@@ -60,6 +60,8 @@ namespace ircd::net
 	ipport remote_ipport(const socket &) noexcept;
 	std::pair<size_t, size_t> bytes(const socket &) noexcept; // <in, out>
 	std::pair<size_t, size_t> calls(const socket &) noexcept; // <in, out>
+	std::shared_ptr<openssl::SSL_SESSION> session(const socket &) noexcept;
+	bool resumed(const socket &) noexcept;
 
 	const_buffer peer_cert_der(const mutable_buffer &, const socket &);
 	const_buffer peer_cert_der_sha256(const mutable_buffer &, const socket &);
@@ -116,6 +116,16 @@ struct ircd::net::open_opts
 
 	/// Option to allow expired certificates.
 	bool allow_expired { default_allow_expired };
+
+	/// Application protocols offered in the ClientHello in order of
+	/// preference (ALPN). The protocol selected by the remote, if any, is
+	/// found in socket::alpn after the handshake.
+	vector_view<const string_view> alpn;
+
+	/// Session from a prior connection to the same remote which is offered
+	/// for resumption in the ClientHello. If the remote declines it a full
+	/// handshake is conducted. See net::session() to obtain one.
+	std::shared_ptr<openssl::SSL_SESSION> session;
 };
 
 /// Constructor intended to provide implicit conversions (no-brackets required)
@@ -57,6 +57,8 @@ ircd::net::socket
 	static stats::item<uint64_t> total_bytes_out;
 	static stats::item<uint64_t> total_calls_in;
 	static stats::item<uint64_t> total_calls_out;
+	static stats::item<uint64_t> total_handshake_full;
+	static stats::item<uint64_t> total_handshake_resumed;
 	static ios::descriptor desc_connect;
 	static ios::descriptor desc_handshake;
 	static ios::descriptor desc_disconnect;
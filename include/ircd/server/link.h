@@ -15,8 +15,14 @@
 ///
 struct ircd::server::link
 {
+	struct mux;
+
 	static conf::item<size_t> tag_max_default;
 	static conf::item<size_t> tag_commit_max_default;
+	static conf::item<bool> h2_enable;
+	static conf::item<size_t> h2_streams_max;
+	static conf::item<size_t> h2_window_size;
+	static const string_view h2_alpn[2];
 	static uint64_t ids;
 
 	uint64_t id {++ids};                         ///< unique identifier of link.
@@ -33,6 +39,7 @@ struct ircd::server::link
 	bool op_write {false};                       ///< async operation state
 	bool op_read {false};                        ///< async operation state
 	bool exclude {false};                        ///< link is excluded
+	std::unique_ptr<mux> h2;                     ///< HTTP/2 state if negotiated
 
 	template<class F> size_t accumulate_tags(F&&) const;
 
@@ -50,6 +57,16 @@ struct ircd::server::link
 	void handle_writable(const error_code &) noexcept;
 	void wait_writable();
 
+	void h2_frame(const http2::frame::header &, const_buffer);
+	void h2_headers(const uint32_t &id, const bool &eos);
+	void h2_data(const http2::frame::header &, const_buffer);
+	void h2_goaway(const uint32_t &last_id, const uint32_t &code);
+	void h2_readable();
+	bool h2_commit(tag &);
+	void h2_content(tag &);
+	void h2_writable();
+	void h2_open();
+
 	void handle_close(std::exception_ptr);
 	void handle_open(std::exception_ptr);
 	void cleanup_canceled();
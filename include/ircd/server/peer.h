@@ -32,6 +32,7 @@ struct ircd::server::peer
 	static conf::item<ssize_t> sock_read_lowat;
 	static conf::item<ssize_t> sock_write_bufsz;
 	static conf::item<ssize_t> sock_write_lowat;
+	static conf::item<bool> session_reuse;
 	static uint64_t ids;
 
 	uint64_t id {++ids};
@@ -39,7 +40,7 @@ struct ircd::server::peer
 	std::string hostcanon;        // hostname:service[:port]
 	net::ipport remote;
 	system_point remote_expires;
-	net::open_opts open_opts;
+	net::open_opts open_opts;     // includes the TLS session to resume
 	std::list<link> links;
 	std::unique_ptr<err> e;
 	std::string server_version;
@@ -39,6 +39,8 @@ struct ircd::server::tag
 		size_t chunk_read {0};         // content read after last chunk head
 		size_t chunk_length {0};       // -1 for chunk header mode
 		http::code status {(http::code)0};
+		uint32_t stream {0};           // HTTP/2 stream identifier
+		int64_t window {0};            // HTTP/2 stream send window
 	}
 	state;
 	ctx::promise<http::code> p;
@@ -0,0 +1,29 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_ZSTD_H
+
+/// Zstandard; wrappers a la carte. When the library is not available the
+/// compression functions throw and available() is false; bound() is always
+/// safe to call.
+namespace ircd::zstd
+{
+	IRCD_EXCEPTION(ircd::error, error)
+
+	bool available() noexcept;
+	size_t bound(const size_t &) noexcept;
+	size_t content_size(const const_buffer &);
+
+	const_buffer compress(const mutable_buffer &, const const_buffer &, const int &level = 3);
+	const_buffer decompress(const mutable_buffer &, const const_buffer &);
+
+	extern const info::versions version_api, version_abi;
+}
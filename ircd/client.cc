@@ -534,6 +534,53 @@ catch(const std::exception &e)
 	};
 }
 
+/// A request received on an HTTP/2 stream is conducted here on its own
+/// ircd::ctx. The stream's client shares the connection's socket; its
+/// head_buffer holds the request composed by the connection, which is
+/// handled once as with any HTTP/1.1 request. Output is written through
+/// the connection as frames on the stream (see: client::write_all()).
+void
+ircd::client::handle_h2_stream(std::shared_ptr<client> client)
+try
+{
+	assert(ctx::current);
+	assert(client->h2);
+	assert(client->h2_stream);
+	auto *const stream
+	{
+		client->h2->find(client->h2_stream)
+	};
+
+	const unwind finish{[&client]
+	{
+		client->reqctx = nullptr;
+		client->h2->finish(client->h2_stream);
+		if(pool.avail() <= 1)
+			dock.notify_all();
+	}};
+
+	if(!stream || stream->reset)
+		return;
+
+	client->reqctx = ctx::current;
+	client->ready_count++;
+	stream->context = ctx::current;
+
+	parse::buffer pb{const_buffer{client->head_buffer}};
+	parse::capstan pc{pb};
+	client->handle_request(pc);
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "%s stream:%u :%s",
+		loghead(*client),
+		client->h2_stream,
+		e.what()
+	};
+}
+
 bool
 ircd::handle_ec(client &client,
                 const error_code &ec)
@@ -645,6 +692,12 @@ ircd::handle_ec_timeout(client &client)
 try
 {
 	assert(bool(client.sock));
+
+	// The connection is not idle while its HTTP/2 streams are in progress;
+	// it proceeds to main() which finds nothing to read and re-arms.
+	if(client.h2 && !client.h2->streams.empty())
+		return true;
+
 	log::debug
 	{
 		client::log, "%s disconnecting after inactivity timeout",
@@ -749,6 +802,9 @@ bool
 ircd::client::main()
 try
 {
+	if(string_view(sock->alpn) == "h2"_sv)
+		return h2_main();
+
 	parse::buffer pb{head_buffer};
 	parse::capstan pc{pb, read_closure(*this)}; do
 	{
@@ -799,6 +855,39 @@ catch(const ctx::terminated &)
 	throw;
 }
 
+/// HTTP/2 connection main.
+///
+/// Frames available on the socket are read and handled by the connection.
+/// Each stream with a complete request is paired with its own client which
+/// is dispatched to the request pool like any other. Once no more data is
+/// available this returns true to put the connection back into async mode.
+bool
+ircd::client::h2_main()
+{
+	if(!h2)
+		h2 = std::make_shared<http2::connection>(sock);
+
+	return h2->handle([this](http2::stream &stream)
+	{
+		h2_dispatch(stream);
+	});
+}
+
+void
+ircd::client::h2_dispatch(http2::stream &stream)
+{
+	auto client
+	{
+		std::make_shared<ircd::client>(sock)
+	};
+
+	client->conf = conf;
+	client->h2 = h2;
+	client->h2_stream = stream.id;
+	client->head_buffer = h2->request(stream);
+	pool(std::bind(client::handle_h2_stream, std::move(client)));
+}
+
 /// Handle a single request within the client main() loop.
 ///
 /// This function returns false if the main() loop should exit
@@ -817,11 +906,14 @@ try
 
 	// This timeout covers the reception of a complete HTTP head. If the
 	// head was fragmented and has not entirely arrived yet this function
-	// will block this request context below. The timeout limits that.
-	net::scope_timeout timeout
-	{
-		*sock, conf->request_timeout
-	};
+	// will block this request context below. The timeout limits that. An
+	// HTTP/2 stream's request is already complete and its socket is shared.
+	net::scope_timeout timeout;
+	if(likely(!h2_stream))
+		timeout = net::scope_timeout
+		{
+			*sock, conf->request_timeout
+		};
 
 	// This is the first read off the wire. The headers are entirely read and
 	// the tape is advanced.
@@ -1066,6 +1158,19 @@ ircd::client::close(const net::dc type)
 ircd::ctx::future<void>
 ircd::client::close(const net::close_opts &opts)
 {
+	// An HTTP/2 stream is reset rather than closing the connection.
+	if(h2_stream)
+	{
+		h2->cancel(h2_stream);
+		return ctx::already;
+	}
+
+	if(h2)
+	{
+		h2->closing = true;
+		h2->dock.notify_all();
+	}
+
 	return likely(sock) && !sock->fini?
 		net::close(*sock, opts):
 		ctx::already;
@@ -1090,6 +1195,18 @@ ircd::client::close(const net::close_opts &opts,
 	if(!sock)
 		return;
 
+	if(h2_stream)
+	{
+		h2->cancel(h2_stream);
+		return callback({});
+	}
+
+	if(h2)
+	{
+		h2->closing = true;
+		h2->dock.notify_all();
+	}
+
 	if(sock->fini)
 		return callback({});
 
@@ -1111,5 +1228,25 @@ ircd::client::write_all(const net::const_buffers &bufs)
 			make_error_code(std::errc::not_connected)
 		};
 
+	if(h2_stream)
+	{
+		auto *const stream
+		{
+			h2->find(h2_stream)
+		};
+
+		if(unlikely(!stream))
+			throw std::system_error
+			{
+				make_error_code(std::errc::not_connected)
+			};
+
+		size_t ret(0);
+		for(const auto &buf : bufs)
+			ret += h2->write(*stream, buf);
+
+		return ret;
+	}
+
 	return net::write_all(*sock, bufs);
 }
@@ -100,6 +100,7 @@ ircd::ctx::ctx::~ctx()
 noexcept
 {
 	assert(yc == nullptr); // Check that the context isn't active.
+	assert(expires == 0);  // Check that the context isn't in the timer wheel.
 }
 
 /// Internal wrapper for asio::spawn; never call directly.
@@ -491,6 +492,335 @@ const noexcept
 	return started() && yc == nullptr;
 }
 
+//
+// ctx::wheel
+//
+
+[[clang::always_destroy]]
+decltype(ircd::ctx::wheel::ios_desc)
+ircd::ctx::wheel::ios_desc
+{
+	"ircd.ctx.wheel"
+};
+
+/// The timer only exists while the wheel has entries, so none outlives the
+/// io_context at shutdown.
+decltype(ircd::ctx::wheel::timer)
+ircd::ctx::wheel::timer;
+
+decltype(ircd::ctx::wheel::slot)
+ircd::ctx::wheel::slot;
+
+decltype(ircd::ctx::wheel::used)
+ircd::ctx::wheel::used;
+
+decltype(ircd::ctx::wheel::tick)
+ircd::ctx::wheel::tick;
+
+decltype(ircd::ctx::wheel::armed)
+ircd::ctx::wheel::armed;
+
+decltype(ircd::ctx::wheel::count)
+ircd::ctx::wheel::count;
+
+/// Link the context into the wheel to be woken at `expires`. The context
+/// must be removed with del() after it resumes for any reason.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::add(ctx &c,
+                      const steady_point &expires)
+{
+	assert(c.expires == 0);
+	const auto now
+	{
+		uint64_t(duration_cast<milliseconds>(ircd::now<steady_point>().time_since_epoch()).count())
+	};
+
+	// While empty the wheel isn't advanced; catch up in constant time.
+	if(!count)
+		tick = now;
+
+	// Rounded up so a context is never woken before its deadline.
+	c.expires = std::max
+	(
+		uint64_t(std::chrono::ceil<milliseconds>(expires.time_since_epoch()).count()),
+		tick + 1
+	);
+
+	link(c);
+	++count;
+	if(!armed || c.expires < armed)
+		arm();
+}
+
+/// Unlink the context from the wheel if it's still linked. This is a no-op
+/// after the wheel expired the context.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::del(ctx &c)
+noexcept
+{
+	if(!c.expires)
+		return;
+
+	auto &head
+	{
+		slot[c.wheel_level][c.wheel_slot]
+	};
+
+	if(c.wheel_prev)
+		c.wheel_prev->wheel_next = c.wheel_next;
+	else
+		head = c.wheel_next;
+
+	if(c.wheel_next)
+		c.wheel_next->wheel_prev = c.wheel_prev;
+
+	if(!head)
+		used[c.wheel_level] &= ~(1UL << c.wheel_slot);
+
+	c.wheel_next = nullptr;
+	c.wheel_prev = nullptr;
+	c.expires = 0;
+
+	assert(count > 0);
+	if(--count)
+		return;
+
+	armed = 0;
+	timer.reset();
+}
+
+/// Place the context in the slot of the lowest level spanning its
+/// expiration. Expirations beyond the span of the wheel are placed in the
+/// last slot to come due and redistributed from there.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::link(ctx &c)
+noexcept
+{
+	assert(c.expires >= tick);
+	const uint64_t delta
+	{
+		c.expires - tick
+	};
+
+	size_t level(0);
+	while(level < LEVELS - 1 && delta >= (1UL << (SLOT_BITS * (level + 1))))
+		++level;
+
+	const uint64_t position
+	{
+		delta < (1UL << (SLOT_BITS * LEVELS))?
+			c.expires:
+			tick + (1UL << (SLOT_BITS * LEVELS)) - 1
+	};
+
+	const size_t idx
+	{
+		(position >> (SLOT_BITS * level)) & (SLOTS - 1)
+	};
+
+	auto &head
+	{
+		slot[level][idx]
+	};
+
+	c.wheel_level = level;
+	c.wheel_slot = idx;
+	c.wheel_prev = nullptr;
+	c.wheel_next = head;
+	if(head)
+		head->wheel_prev = &c;
+
+	head = &c;
+	used[level] |= 1UL << idx;
+}
+
+/// Detach and return the list of contexts in a slot.
+[[gnu::visibility("hidden")]]
+ircd::ctx::ctx *
+ircd::ctx::wheel::take(const size_t &level,
+                       const size_t &idx)
+noexcept
+{
+	auto *const ret
+	{
+		slot[level][idx]
+	};
+
+	slot[level][idx] = nullptr;
+	used[level] &= ~(1UL << idx);
+	return ret;
+}
+
+/// Redistribute the contexts of a higher level slot which came due.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::cascade(const size_t &level,
+                          const size_t &idx)
+noexcept
+{
+	for(auto *c(take(level, idx)); c; )
+	{
+		auto *const next(c->wheel_next);
+		link(*c);
+		c = next;
+	}
+}
+
+/// Wake the contexts of the level zero slot for the current tick.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::expire(const size_t &idx)
+noexcept
+{
+	for(auto *c(take(0, idx)); c; )
+	{
+		auto *const next(c->wheel_next);
+		c->wheel_next = nullptr;
+		c->wheel_prev = nullptr;
+		if(likely(c->expires <= tick))
+		{
+			c->expires = 0;
+			--count;
+			c->wake();
+		}
+		else link(*c);
+
+		c = next;
+	}
+}
+
+/// Process every tick with work up to and including `now`.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::advance(const uint64_t &now)
+noexcept
+{
+	while(count)
+	{
+		const auto t
+		{
+			next()
+		};
+
+		if(t > now)
+			break;
+
+		tick = t;
+		for(size_t level(LEVELS - 1); level > 0; --level)
+		{
+			const auto shift
+			{
+				SLOT_BITS * level
+			};
+
+			if((t & ((1UL << shift) - 1)) == 0)
+				cascade(level, (t >> shift) & (SLOTS - 1));
+		}
+
+		expire(t & (SLOTS - 1));
+	}
+
+	tick = std::max(tick, now);
+}
+
+/// The next tick at which a level zero slot expires or a higher level slot
+/// is redistributed; UINT64_MAX if empty.
+[[gnu::visibility("hidden")]]
+uint64_t
+ircd::ctx::wheel::next()
+noexcept
+{
+	uint64_t ret(-1UL);
+	for(size_t level(0); level < LEVELS; ++level)
+	{
+		if(!used[level])
+			continue;
+
+		const auto shift
+		{
+			SLOT_BITS * level
+		};
+
+		const uint64_t base
+		{
+			(tick >> shift) + 1
+		};
+
+		const auto rotated
+		{
+			std::rotr(used[level], base & (SLOTS - 1))
+		};
+
+		const uint64_t t
+		{
+			(base + std::countr_zero(rotated)) << shift
+		};
+
+		ret = std::min(ret, t);
+	}
+
+	return ret;
+}
+
+/// Set the timer for the next tick with work. Setting the timer cancels any
+/// previous wait on it.
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::arm()
+{
+	assert(count);
+	const auto t
+	{
+		next()
+	};
+
+	if(t == armed)
+		return;
+
+	if(!timer)
+		timer = std::make_unique<boost::asio::steady_timer>(ios::get());
+
+	const auto handler{[](const boost::system::error_code &ec) noexcept
+	{
+		handle(ec);
+	}};
+
+	armed = t;
+	timer->expires_at(steady_point{TICK * t});
+	timer->async_wait(ios::handle(ios_desc, handler));
+}
+
+[[gnu::visibility("hidden")]]
+void
+ircd::ctx::wheel::handle(const boost::system::error_code &ec)
+noexcept try
+{
+	if(ec == boost::system::errc::operation_canceled)
+		return;
+
+	const auto now
+	{
+		uint64_t(duration_cast<milliseconds>(ircd::now<steady_point>().time_since_epoch()).count())
+	};
+
+	armed = 0;
+	advance(now);
+	if(count)
+		arm();
+	else
+		timer.reset();
+}
+catch(const std::exception &e)
+{
+	log::critical
+	{
+		log, "ctx::wheel: %s", e.what()
+	};
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // ctx/ctx.h
@@ -525,13 +855,11 @@ ircd::ctx::yield(ctx &ctx)
 
 	//ctx.jump();
 	// !!! TODO !!!
-	// XXX: We can't jump directly to a context if it's waiting on its alarm, and
-	// we don't know whether it's waiting on its alarm. We can add another flag to
-	// inform us of that, but most contexts are usually waiting on their alarm anyway.
-	//
-	// Perhaps a better way to do this would be to centralize the alarms into a single
-	// context with the sole job of waiting on a single alarm. Then it can schedule
-	// things allowing for more direct jumps until all work is complete.
+	// XXX: Timed waits are now scheduled by ctx::wheel so a suspended context
+	// is only ever waiting on its alarm as a semaphore; `ctx.expires` tells
+	// whether it also has a deadline pending. The remaining obstacle to a
+	// direct jump is that the suspension is still an asio completion handler
+	// which must be resumed by the ios; see ctx::jump().
 	// !!! TODO !!!
 
 	ctx.note();
@@ -792,23 +1120,45 @@ ircd::microseconds
 ircd::ctx::this_ctx::wait(const microseconds &duration,
                           const std::nothrow_t &)
 {
-	const boost::posix_time::microseconds ptime_duration
+	auto &c(cur());
+
+	// Waits shorter than a tick of the wheel are left to the alarm itself.
+	if(duration < wheel::TICK)
 	{
-		duration.count()
-	};
+		const boost::posix_time::microseconds ptime_duration
+		{
+			duration.count()
+		};
 
-	auto &c(cur());
-	c.alarm.expires_from_now(ptime_duration);
-	c.wait(); // now you're yielding with portals
-	const auto &ret
+		c.alarm.expires_from_now(ptime_duration);
+		c.wait(); // now you're yielding with portals
+		const auto &ret
+		{
+			c.alarm.expires_from_now()
+		};
+
+		return microseconds(ret.total_microseconds());
+	}
+
+	const auto expires
 	{
-		c.alarm.expires_from_now()
+		now<steady_point>() + duration
 	};
 
+	// The alarm is only a semaphore here; the wheel cancels it on expiration.
+	c.alarm.expires_at(boost::posix_time::pos_infin);
+	wheel::add(c, expires);
+	const unwind remove{[&c]() noexcept
+	{
+		wheel::del(c);
+	}};
+
+	c.wait(); // now you're yielding with portals
+
 	// return remaining duration.
 	// this is > 0 if notified
-	// this is unchanged if a note prevented any wait at all
-	return microseconds(ret.total_microseconds());
+	// this is <= 0 if the full duration elapsed
+	return duration_cast<microseconds>(expires - now<steady_point>());
 }
 
 /// Yield the currently running context until notified or `time_point`.
@@ -821,28 +1171,10 @@ ircd::ctx::this_ctx::wait_until(const system_point &tp,
 {
 	const auto &diff
 	{
-		tp - now<system_point>()
-	};
-
-	const boost::posix_time::microseconds duration
-	{
-		duration_cast<microseconds>(diff).count()
-	};
-
-	const auto &expires_at
-	{
-		boost::posix_time::microsec_clock::universal_time() + duration
-	};
-
-	auto &c(cur());
-	c.alarm.expires_at(expires_at);
-	c.wait(); // now you're yielding with portals
-	const auto &ret
-	{
-		c.alarm.expires_from_now()
+		duration_cast<microseconds>(tp - now<system_point>())
 	};
 
-	return ret <= boost::posix_time::microseconds(0);
+	return wait(diff, std::nothrow) <= microseconds(0);
 }
 
 /// Yield the currently running context until notified.
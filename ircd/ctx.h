@@ -23,6 +23,11 @@ namespace ircd::ctx::prof
 	static void mark(const event &);
 }
 
+namespace ircd::ctx
+{
+	struct wheel;
+}
+
 /// Internal context implementation
 ///
 struct ircd::ctx::ctx
@@ -43,6 +48,11 @@ struct ircd::ctx::ctx
 	int8_t ionice {0};                           // IO priority nice-value (defaults for fs::opts)
 	int32_t notes {0};                           // norm: 0 = asleep; 1 = awake; inc by others; dec by self
 	boost::asio::deadline_timer alarm;           // acting semaphore (64B)
+	uint64_t expires {0};                        // timer wheel tick; 0 when not timed
+	ctx *wheel_next {nullptr};                   // timer wheel slot linkage
+	ctx *wheel_prev {nullptr};                   // timer wheel slot linkage
+	uint8_t wheel_level {0};                     // timer wheel level of slot
+	uint8_t wheel_slot {0};                      // timer wheel slot of level
 	boost::asio::yield_context *yc {nullptr};    // boost interface
 	continuation *cont {nullptr};                // valid when asleep; invalid when awake
 	list::node node;                             // node for ctx::list
@@ -76,6 +86,42 @@ struct ircd::ctx::ctx
 	~ctx() noexcept;
 };
 
+/// Hierarchical timer wheel for context alarms (internal)
+///
+/// A timed wait links the context into a slot of the wheel in constant time
+/// and suspends on its alarm without an expiration; the alarm is then only a
+/// semaphore. A single asio timer is armed for the next tick with any work,
+/// and when it fires every expired context is woken as a batch. Each level
+/// spans SLOTS times the level below it; entries are redistributed down from
+/// a higher level when their slot comes due.
+struct ircd::ctx::wheel
+{
+	static constexpr size_t LEVELS {4};
+	static constexpr size_t SLOT_BITS {6};
+	static constexpr size_t SLOTS {1UL << SLOT_BITS};
+	static constexpr milliseconds TICK {1};
+
+	static ios::descriptor ios_desc;
+	static std::unique_ptr<boost::asio::steady_timer> timer;
+	static std::array<std::array<ctx *, SLOTS>, LEVELS> slot;
+	static std::array<uint64_t, LEVELS> used;    // bitmask of non-empty slots
+	static uint64_t tick;                        // last tick processed
+	static uint64_t armed;                       // tick the timer is set for
+	static size_t count;                         // contexts in the wheel
+
+	static uint64_t next() noexcept;
+	static void link(ctx &) noexcept;
+	static ctx *take(const size_t &level, const size_t &slot) noexcept;
+	static void cascade(const size_t &level, const size_t &slot) noexcept;
+	static void expire(const size_t &slot) noexcept;
+	static void advance(const uint64_t &now) noexcept;
+	static void handle(const boost::system::error_code &) noexcept;
+	static void arm();
+
+	static void add(ctx &, const steady_point &expires);
+	static void del(ctx &) noexcept;
+};
+
 template<>
 decltype(ircd::ctx::ctx::list)
 ircd::util::instance_list<ircd::ctx::ctx>::list;
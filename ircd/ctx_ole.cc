@@ -32,7 +32,7 @@ decltype(ircd::ctx::ole::thread_max)
 ircd::ctx::ole::thread_max
 {
 	{ "name",     "ircd.ctx.ole.thread.max"  },
-	{ "default",  int64_t(1)                 },
+	{ "default",  int64_t(2)                 },
 };
 
 [[gnu::visibility("internal"), clang::always_destroy]]
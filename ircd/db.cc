@@ -1582,6 +1582,38 @@ ircd::db::txn::append::append(txn &t,
 	});
 }
 
+ircd::db::txn::append::append(txn &t,
+                              const txn &other)
+{
+	const txn *others[]
+	{
+		&other
+	};
+
+	append
+	{
+		t, vector_view<const txn *>(others)
+	};
+}
+
+ircd::db::txn::append::append(txn &t,
+                              const vector_view<const txn *> &others)
+{
+	assert(bool(t.wb));
+	const rocksdb::WriteBatch *batch[others.size()];
+	std::transform(begin(others), end(others), batch, []
+	(const txn *const &other)
+	{
+		assert(other && other->wb);
+		return other->wb.get();
+	});
+
+	db::append(*t.wb, vector_view<const rocksdb::WriteBatch *>
+	{
+		batch, others.size()
+	});
+}
+
 ircd::db::txn::append::append(txn &t,
                               const delta &delta)
 {
@@ -4278,6 +4310,33 @@ ircd::db::capacity(const rocksdb::Cache &cache)
 	return cache.GetCapacity();
 }
 
+bool
+ircd::db::secondary_capacity(rocksdb::Cache &cache,
+                             const size_t &cap)
+{
+	auto *const c
+	{
+		dynamic_cast<database::cache *>(&cache)
+	};
+
+	return c?
+		c->secondary_capacity(cap):
+		false;
+}
+
+size_t
+ircd::db::secondary_capacity(const rocksdb::Cache &cache)
+{
+	const auto *const c
+	{
+		dynamic_cast<const database::cache *>(&cache)
+	};
+
+	return c?
+		c->secondary_capacity():
+		0UL;
+}
+
 const uint64_t &
 ircd::db::ticker(const rocksdb::Cache &cache,
                  const uint32_t &ticker_id)
@@ -4688,6 +4747,54 @@ ircd::db::append(rocksdb::WriteBatch &batch,
 	}
 }
 
+/// Concatenate the updates of each batch in the vector onto the first
+/// argument. This is equivalent to WriteBatchInternal::Append() which is not
+/// exposed by rocksdb; the representation is a header of a fixed64 sequence
+/// and a fixed32 count followed by the records, so the records are copied
+/// once in a single pass and the count is summed.
+void
+ircd::db::append(rocksdb::WriteBatch &batch,
+                 const vector_view<const rocksdb::WriteBatch *> &others)
+{
+	static constexpr size_t header_size
+	{
+		sizeof(uint64_t) + sizeof(uint32_t)
+	};
+
+	size_t bytes(batch.GetDataSize());
+	uint32_t count(batch.Count());
+	for(const auto *const &other : others)
+	{
+		assert(other);
+		assert(other->GetDataSize() >= header_size);
+		bytes += other->GetDataSize() - header_size;
+		count += other->Count();
+	}
+
+	if(count == uint32_t(batch.Count()))
+		return;
+
+	std::string rep;
+	rep.reserve(bytes);
+	rep.append(batch.Data());
+	for(const auto *const &other : others)
+		rep.append(other->Data(), header_size, std::string::npos);
+
+	assert(rep.size() == bytes);
+	assert(rep.size() >= header_size);
+
+	// fixed32 is always little-endian.
+	for(size_t i(0); i < sizeof(uint32_t); ++i)
+		rep[sizeof(uint64_t) + i] = char(count >> (i * 8));
+
+	batch = rocksdb::WriteBatch
+	{
+		std::move(rep)
+	};
+
+	assert(uint32_t(batch.Count()) == count);
+}
+
 void
 ircd::db::commit(database &d,
                  rocksdb::WriteBatch &batch,
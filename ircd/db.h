@@ -64,6 +64,9 @@
 #if __has_include(<rocksdb/advanced_cache.h>)
 #include <rocksdb/advanced_cache.h>
 #endif
+#if __has_include(<rocksdb/secondary_cache.h>)
+#include <rocksdb/secondary_cache.h>
+#endif
 #pragma clang attribute pop
 
 #include "db_has.h"
@@ -151,6 +154,7 @@ namespace ircd::db
 	void commit(database &, rocksdb::WriteBatch &, const sopts &);
 	void append(rocksdb::WriteBatch &, column &, const column::delta &delta);
 	void append(rocksdb::WriteBatch &, const cell::delta &delta);
+	void append(rocksdb::WriteBatch &, const vector_view<const rocksdb::WriteBatch *> &);
 
 	const descriptor &describe(const database::column &);
 	const std::string &name(const database::column &);
@@ -211,11 +215,16 @@ ircd::db::database::cache final
 	static const int DEFAULT_SHARD_BITS;
 	static const double DEFAULT_HI_PRIO;
 	static const bool DEFAULT_STRICT;
+	static conf::item<std::string> secondary_compression;
 
 	database *d;
 	std::string name;
 	std::shared_ptr<struct database::stats> stats;
 	std::shared_ptr<struct database::allocator> allocator;
+	#ifdef IRCD_DB_HAS_SECONDARY_CACHE
+	std::shared_ptr<rocksdb::SecondaryCache> sc;
+	#endif
+	size_t sc_capacity {0};
 	std::shared_ptr<rocksdb::Cache> c;
 
 	const char *Name() const noexcept override;
@@ -269,11 +278,15 @@ ircd::db::database::cache final
 	Handle *CreateStandalone(const Slice &, ObjectPtr, const CacheItemHelper *, size_t, bool) noexcept override;
 	#endif
 
+	bool secondary_capacity(const size_t &) noexcept;
+	size_t secondary_capacity() const noexcept;
+
 	cache(database *const &,
 	      std::shared_ptr<struct database::stats>,
 	      std::shared_ptr<struct database::allocator>,
 	      std::string name,
-	      const ssize_t &initial_capacity = -1);
+	      const ssize_t &initial_capacity = -1,
+	      const ssize_t &secondary_capacity = 0);
 
 	~cache() noexcept override;
 };
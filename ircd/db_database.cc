@@ -2005,6 +2005,15 @@ ircd::db::database::column::column(database &d,
 	if(this->options.bottommost_compression == rocksdb::kZSTD)
 		this->options.bottommost_compression_opts.level = 0;
 
+	// Dictionary compression is only applied at the bottommost level where
+	// the bulk of the data resides and the training cost is paid once.
+	if(this->descriptor->compression_dict)
+	{
+		auto &opts(this->options.bottommost_compression_opts);
+		opts.max_dict_bytes = this->descriptor->compression_dict;
+		opts.zstd_max_train_bytes = opts.max_dict_bytes * 100; // zstd recommended
+	}
+
 	//
 	// Table options
 	//
@@ -2053,10 +2062,12 @@ ircd::db::database::column::column(database &d,
 	table_opts.pin_l0_filter_and_index_blocks_in_cache = false;
 	table_opts.partition_filters = true;
 
-	// Setup the cache for assets.
+	// Setup the cache for assets. The size for compressed blocks is given
+	// to a secondary tier of this cache holding its evictions.
 	const auto &cache_size(this->descriptor->cache_size);
+	const auto &cache_size_comp(this->descriptor->cache_size_comp);
 	if(cache_size != 0)
-		table_opts.block_cache = std::make_shared<database::cache>(this->d, this->stats, this->allocator, this->name, cache_size);
+		table_opts.block_cache = std::make_shared<database::cache>(this->d, this->stats, this->allocator, this->name, cache_size, cache_size_comp);
 
 	// RocksDB will create an 8_MiB block_cache if we don't create our own.
 	// To honor the user's desire for a zero-size cache, this must be set.
@@ -2066,11 +2077,6 @@ ircd::db::database::column::column(database &d,
 		table_opts.cache_index_and_filter_blocks = false; // MBZ or error w/o block_cache
 	}
 
-	// Setup the cache for compressed assets.
-	const auto &cache_size_comp(this->descriptor->cache_size_comp);
-	if(cache_size_comp != 0)
-		; //table_opts.block_cache_compressed = std::make_shared<database::cache>(this->d, this->stats, this->allocator, this->name, cache_size_comp);
-
 	// Setup the bloom filter.
 	const auto &bloom_bits(this->descriptor->bloom_bits);
 	if(bloom_bits)
@@ -2143,7 +2149,7 @@ ircd::db::database::column::column(database &d,
 		this->cmp.Name(),
 		this->options.prefix_extractor? this->prefix.Name() : "none",
 		table_opts.block_cache? "YES": "NO",
-		"NO", //table_opts.block_cache_compressed? "YES": "NO",
+		table_opts.block_cache && this->descriptor->cache_size_comp? "YES": "NO",
 		this->descriptor->bloom_bits,
 		int(this->options.compression),
 		this->descriptor->name
@@ -3217,6 +3223,14 @@ ircd::db::database::cache::DEFAULT_HI_PRIO
 	0.25
 };
 
+decltype(ircd::db::database::cache::secondary_compression)
+ircd::db::database::cache::secondary_compression
+{
+	{ "name",     "ircd.db.cache.secondary.compression"      },
+	{ "default",  "kLZ4Compression;kSnappyCompression;kZSTD" },
+	{ "help",     "Compression for the secondary block cache tier; read at open." },
+};
+
 //
 // cache::cache
 //
@@ -3225,7 +3239,8 @@ ircd::db::database::cache::cache(database *const &d,
                                  std::shared_ptr<struct database::stats> stats,
                                  std::shared_ptr<struct database::allocator> allocator,
                                  std::string name,
-                                 const ssize_t &initial_capacity)
+                                 const ssize_t &initial_capacity,
+                                 const ssize_t &secondary_capacity)
 #ifdef IRCD_DB_HAS_ALLOCATOR
 :rocksdb::Cache{allocator}
 ,d{d}
@@ -3235,16 +3250,53 @@ ircd::db::database::cache::cache(database *const &d,
 ,name{std::move(name)}
 ,stats{std::move(stats)}
 ,allocator{std::move(allocator)}
-,c{rocksdb::NewLRUCache(rocksdb::LRUCacheOptions
-{
-	size_t(std::max(initial_capacity, ssize_t(0)))
-	,DEFAULT_SHARD_BITS
-	,DEFAULT_STRICT
-	,DEFAULT_HI_PRIO
+#ifdef IRCD_DB_HAS_SECONDARY_CACHE
+,sc{[this, &secondary_capacity]
+() -> std::shared_ptr<rocksdb::SecondaryCache>
+{
+	// A negative value creates the tier empty for its capacity to be set
+	// later; zero disables it for the life of this cache.
+	if(secondary_capacity == 0)
+		return {};
+
+	rocksdb::CompressedSecondaryCacheOptions opts;
+	opts.capacity = size_t(std::max(secondary_capacity, ssize_t(0)));
+	opts.num_shard_bits = DEFAULT_SHARD_BITS;
+	opts.strict_capacity_limit = DEFAULT_STRICT;
+	opts.compression_type = find_supported_compression(string_view{secondary_compression});
 	#ifdef IRCD_DB_HAS_ALLOCATOR
-	,this->allocator
+	opts.memory_allocator = this->allocator;
+	#endif
+	return rocksdb::NewCompressedSecondaryCache(opts);
+}()}
+#endif
+,sc_capacity
+{
+	size_t(std::max(secondary_capacity, ssize_t(0)))
+}
+,c{[this, &initial_capacity]
+{
+	rocksdb::LRUCacheOptions opts
+	{
+		size_t(std::max(initial_capacity, ssize_t(0)))
+		,DEFAULT_SHARD_BITS
+		,DEFAULT_STRICT
+		,DEFAULT_HI_PRIO
+		#ifdef IRCD_DB_HAS_ALLOCATOR
+		,this->allocator
+		#endif
+	};
+
+	// Blocks evicted from this cache are offered to the compressed tier
+	// rather than dropped, and are promoted back on a hit there. The tier
+	// admits a block on its second eviction; the first leaves only a
+	// placeholder, so blocks read once never displace re-referenced ones.
+	#ifdef IRCD_DB_HAS_SECONDARY_CACHE
+	opts.secondary_cache = this->sc;
 	#endif
-})}
+
+	return rocksdb::NewLRUCache(opts);
+}()}
 {
 	assert(bool(c));
 	#ifdef IRCD_DB_HAS_ALLOCATOR
@@ -3363,9 +3415,9 @@ noexcept
 	auto *const &ret
 	{
 		#if defined(IRCD_DB_HAS_CACHE_ASYNC)
-		c->Lookup(key, helper, cc, pri, statistics)
+		c->Lookup(key, helper, cc, pri, s)
 		#elif defined(IRCD_DB_HAS_CACHE_ITEMHELPER)
-		c->Lookup(key, helper, cc, pri, wait, statistics)
+		c->Lookup(key, helper, cc, pri, wait, s)
 		#else
 		c->Lookup(key, s)
 		#endif
@@ -3468,6 +3520,46 @@ const noexcept
 	return c->GetCapacity();
 }
 
+bool
+ircd::db::database::cache::secondary_capacity(const size_t &capacity)
+noexcept
+{
+	#if defined(IRCD_DB_HAS_SECONDARY_CACHE_CAPACITY)
+	if(!sc)
+		return false;
+
+	const rocksdb::Status status
+	{
+		sc->SetCapacity(capacity)
+	};
+
+	if(!status.ok())
+		return false;
+
+	sc_capacity = capacity;
+	return true;
+	#else
+	return false;
+	#endif
+}
+
+size_t
+ircd::db::database::cache::secondary_capacity()
+const noexcept
+{
+	#if defined(IRCD_DB_HAS_SECONDARY_CACHE_CAPACITY)
+	size_t ret(0);
+	if(sc && sc->GetCapacity(ret).ok())
+		return ret;
+	#endif
+
+	#if defined(IRCD_DB_HAS_SECONDARY_CACHE)
+	return sc? sc_capacity: 0UL;
+	#else
+	return 0UL;
+	#endif
+}
+
 size_t
 ircd::db::database::cache::GetUsage()
 const noexcept
@@ -4244,6 +4336,9 @@ ircd::db::database::sst::info::operator=(rocksdb::TableProperties &&tp)
 	merge_operator = std::move(tp.merge_operator_name);
 	prefix_extractor = std::move(tp.prefix_extractor_name);
 	compression = std::move(tp.compression_name);
+	#if ROCKSDB_MAJOR > 5
+	compression_opts = std::move(tp.compression_options);
+	#endif
 	format = std::move(tp.format_version);
 	cfid = std::move(tp.column_family_id);
 	data_size = std::move(tp.data_size);
@@ -4283,6 +4378,20 @@ ircd::db::database::sst::info::operator=(rocksdb::TableProperties &&tp)
 		100 - 100.0L * (data_size / (long double)blocks_size):
 		0.0;
 
+	tokens(compression_opts, ';', [this]
+	(const string_view &token)
+	{
+		const auto &[key, val]
+		{
+			split(lstrip(token, ' '), '=')
+		};
+
+		if(key == "max_dict_bytes")
+			compression_dict = lex_castable<uint64_t>(val)?
+				lex_cast<uint64_t>(val):
+				0UL;
+	});
+
 	return *this;
 }
 
@@ -164,6 +164,12 @@
 	#define IRCD_DB_HAS_SECONDARY_CACHE
 #endif
 
+#if ROCKSDB_MAJOR > 7 \
+|| (ROCKSDB_MAJOR == 7 && ROCKSDB_MINOR > 6) \
+|| (ROCKSDB_MAJOR == 7 && ROCKSDB_MINOR == 6 && ROCKSDB_PATCH >= 0)
+	#define IRCD_DB_HAS_SECONDARY_CACHE_CAPACITY
+#endif
+
 #if ROCKSDB_MAJOR > 7 \
 || (ROCKSDB_MAJOR == 7 && ROCKSDB_MINOR > 7) \
 || (ROCKSDB_MAJOR == 7 && ROCKSDB_MINOR == 7 && ROCKSDB_PATCH >= 2)
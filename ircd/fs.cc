@@ -70,6 +70,12 @@ ircd::fs::init_dump_info()
 		{
 			log, "Filesystem IO is degraded to synchronous system calls."
 		};
+	else
+		log::debug
+		{
+			log, "Filesystem IO backend is %s.",
+			iou::backend(),
+		};
 }
 
 #if defined(HAVE_SYS_RESOURCE_H) && defined(RLIMIT_NOFILE)
@@ -900,7 +906,7 @@ ircd::fs::read(const vector_view<read_op> &op)
 	}
 
 	if constexpr(IRCD_USE_ASIO_READ)
-		if(likely(support::iou && aio && !all))
+		if(likely(iou::available() && aio && !all))
 			return _read_asio(op);
 
 	if constexpr(IRCD_USE_AIO)
@@ -944,18 +950,54 @@ ircd::fs::_read_asio(const vector_view<read_op> &op)
 		d[i].emplace(ios::get(), int(*op[i].fd));
 	}
 
+	// Update stats
+	const scope_count cur_reads
+	{
+		static_cast<uint64_t &>(iou::stats.cur_reads), ops
+	};
+
+	iou::stats.max_reads = std::max
+	(
+		uint64_t(iou::stats.max_reads), uint64_t(iou::stats.cur_reads)
+	);
+
+	iou::stats.max_batch = std::max
+	(
+		uint64_t(iou::stats.max_batch), uint64_t(ops)
+	);
+
+	iou::stats.batches++;
+	iou::stats.requests += ops;
+	for(uint i(0); i < ops; ++i)
+		iou::stats.bytes_requests += buffers::size(op[i].bufs);
+
+	// All requests are issued in this same ios tick so asio flushes their
+	// submission queue entries to the kernel with a single io_uring_enter().
 	size_t ret {0};
 	ctx::latch latch {ops};
 	for(uint i(0); i < ops; ++i)
 		d[i]->async_read_some_at(op[i].opts->offset, op[i].bufs, [i, &op, &ret, &latch]
 		(const auto &ec, const size_t &bytes)
 		{
-			if(ec && ec != eof)
-				op[i].eptr = make_system_eptr(ec);
+			const unwind count_down{[&latch]
+			{
+				latch.count_down();
+			}};
 
 			op[i].ret = bytes;
 			ret += bytes;
-			latch.count_down();
+			if(unlikely(ec && ec != eof))
+			{
+				op[i].eptr = make_system_eptr(ec);
+				iou::stats.errors += ec != boost::asio::error::operation_aborted;
+				iou::stats.cancel += ec == boost::asio::error::operation_aborted;
+				return;
+			}
+
+			iou::stats.complete++;
+			iou::stats.bytes_complete += bytes;
+			iou::stats.bytes_read += bytes;
+			iou::stats.reads++;
 		});
 
 	latch.wait();
@@ -1033,7 +1075,7 @@ ircd::fs::_read(const fd &fd,
 	assert(opts.op == op::READ);
 
 	if constexpr(IRCD_USE_ASIO_READ)
-		if(likely(support::iou && opts.aio))
+		if(likely(iou::available() && opts.aio))
 			return _read_asio(fd, iov, opts);
 
 	if constexpr(IRCD_USE_AIO)
@@ -1080,6 +1122,19 @@ ircd::fs::_read_asio(const fd &fd,
 			d.cancel();
 	}};
 
+	const scope_count cur_reads
+	{
+		static_cast<uint64_t &>(iou::stats.cur_reads)
+	};
+
+	iou::stats.max_reads = std::max
+	(
+		uint64_t(iou::stats.max_reads), uint64_t(iou::stats.cur_reads)
+	);
+
+	iou::stats.requests++;
+	iou::stats.bytes_requests += bytes(iov);
+
 	boost::system::error_code ec;
 	size_t ret {0}; continuation
 	{
@@ -1093,8 +1148,16 @@ ircd::fs::_read_asio(const fd &fd,
 	assert(ret <= bytes(iov));
 	assert(ret || ec == eof || !bytes(iov));
 	if(unlikely(ec && ec != eof))
+	{
+		iou::stats.errors += ec != boost::asio::error::operation_aborted;
+		iou::stats.cancel += ec == boost::asio::error::operation_aborted;
 		throw_system_error(ec);
+	}
 
+	iou::stats.complete++;
+	iou::stats.bytes_complete += ret;
+	iou::stats.bytes_read += ret;
+	iou::stats.reads++;
 	return ret;
 }
 #endif
@@ -1462,7 +1525,7 @@ ircd::fs::_write(const fd &fd,
 	assert(opts.op == op::WRITE);
 
 	if constexpr(IRCD_USE_ASIO_WRITE)
-		if(likely(support::iou && opts.aio))
+		if(likely(iou::available() && opts.aio))
 			return _write_asio(fd, iov, opts);
 
 	if constexpr(IRCD_USE_AIO)
@@ -1510,6 +1573,19 @@ ircd::fs::_write_asio(const fd &fd,
 			d.cancel();
 	}};
 
+	const scope_count cur_writes
+	{
+		static_cast<uint64_t &>(iou::stats.cur_writes)
+	};
+
+	iou::stats.max_writes = std::max
+	(
+		uint64_t(iou::stats.max_writes), uint64_t(iou::stats.cur_writes)
+	);
+
+	iou::stats.requests++;
+	iou::stats.bytes_requests += bytes(iov);
+
 	boost::system::error_code ec;
 	size_t ret {0}; continuation
 	{
@@ -1521,8 +1597,16 @@ ircd::fs::_write_asio(const fd &fd,
 	};
 
 	if(unlikely(ec))
+	{
+		iou::stats.errors += ec != boost::asio::error::operation_aborted;
+		iou::stats.cancel += ec == boost::asio::error::operation_aborted;
 		throw_system_error(ec);
+	}
 
+	iou::stats.complete++;
+	iou::stats.bytes_complete += ret;
+	iou::stats.bytes_write += ret;
+	iou::stats.writes++;
 	return ret;
 }
 #endif
@@ -1964,6 +2048,174 @@ ircd::fs::aio::stats::stats()
 	assert(items <= (sizeof(value) / sizeof(value[0])));
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// fs/iou.h
+//
+
+/// Conf item to control whether io_uring is used for file requests. This
+/// allows switching between the io_uring and AIO backends at runtime for
+/// comparison; when disabled requests are made through fs::aio instead.
+decltype(ircd::fs::iou::enable)
+ircd::fs::iou::enable
+{
+	{ "name",     "ircd.fs.iou.enable"  },
+	{ "default",  true                  },
+	{ "persist",  false                 },
+};
+
+/// Global stats structure
+decltype(ircd::fs::iou::stats)
+ircd::fs::iou::stats;
+
+ircd::string_view
+ircd::fs::iou::backend()
+noexcept
+{
+	if(IRCD_USE_ASIO_READ && available())
+		return "io_uring";
+
+	if(IRCD_USE_AIO && aio::system)
+		return "aio";
+
+	#ifdef HAVE_PREADV2
+	if(support::preadv2)
+		return "preadv2";
+	#endif
+
+	return "preadv";
+}
+
+bool
+ircd::fs::iou::available()
+noexcept
+{
+	return support::iou && enable;
+}
+
+//
+// stats
+//
+
+ircd::fs::iou::stats::stats()
+:value{0}
+,items{0}
+,requests
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.requests" },
+	}
+}
+,complete
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.complete" },
+	}
+}
+,batches
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.batches" },
+	}
+}
+,cancel
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.cancel" },
+	}
+}
+,errors
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.errors" },
+	}
+}
+,reads
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.reads" },
+	}
+}
+,writes
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.writes" },
+	}
+}
+,bytes_requests
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.bytes.requests" },
+	}
+}
+,bytes_complete
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.bytes.complete" },
+	}
+}
+,bytes_read
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.bytes.read" },
+	}
+}
+,bytes_write
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.bytes.write" },
+	}
+}
+,cur_reads
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.cur.reads" },
+	}
+}
+,cur_writes
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.cur.writes" },
+	}
+}
+,max_reads
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.max.reads" },
+	}
+}
+,max_writes
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.max.writes" },
+	}
+}
+,max_batch
+{
+	value + items++,
+	{
+		{ "name", "ircd.fs.iou.max.batch" },
+	}
+}
+{
+	assert(items <= (sizeof(value) / sizeof(value[0])));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // fs/map.h
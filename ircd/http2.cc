@@ -27,6 +27,18 @@ ircd::http2::stream::stream()
 {
 }
 
+ircd::http2::stream::stream(const uint32_t &id)
+:id
+{
+	id
+}
+,state
+{
+	state::IDLE
+}
+{
+}
+
 ircd::string_view
 ircd::http2::reflect(const enum stream::state &state)
 {
@@ -64,6 +76,90 @@ ircd::http2::settings::settings()
 {
 }
 
+/// Validates a SETTINGS frame and calls the closure for each parameter of a
+/// known code. Returns false for an acknowledgement, which has none.
+bool
+ircd::http2::frame::settings::read(const header &header,
+                                   const const_buffer &payload,
+                                   const closure &closure)
+{
+	if(unlikely(header.stream_id))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "SETTINGS on stream %u",
+			uint32_t(header.stream_id),
+		};
+
+	if(unlikely(size(payload) % 6 || (header.flags & flag::ACK && !empty(payload))))
+		throw error
+		{
+			error::FRAME_SIZE_ERROR, "invalid SETTINGS length %zu",
+			size(payload),
+		};
+
+	if(header.flags & flag::ACK)
+		return false;
+
+	for(size_t i(0); i < size(payload); i += 6)
+	{
+		const auto code
+		{
+			static_cast<enum code>(uint8_t(payload[i]) << 8 | uint8_t(payload[i + 1]))
+		};
+
+		const uint32_t value
+		{
+			parse32(const_buffer{data(payload) + i + 2, 4})
+		};
+
+		// Unknown settings are ignored (RFC 7540 6.5.2)
+		if(!code || code >= code::_NUM_)
+			continue;
+
+		if(unlikely(code == code::INITIAL_WINDOW_SIZE && value > 0x7fffffffU))
+			throw error
+			{
+				error::FLOW_CONTROL_ERROR, "INITIAL_WINDOW_SIZE %u", value
+			};
+
+		if(unlikely(code == code::MAX_FRAME_SIZE && (value < 16384 || value > 16777215)))
+			throw error
+			{
+				error::PROTOCOL_ERROR, "MAX_FRAME_SIZE %u", value
+			};
+
+		if(unlikely(code == code::ENABLE_PUSH && value > 1))
+			throw error
+			{
+				error::PROTOCOL_ERROR, "ENABLE_PUSH %u", value
+			};
+
+		closure(code, value);
+	}
+
+	return true;
+}
+
+ircd::const_buffer
+ircd::http2::frame::settings::write(const mutable_buffer &out,
+                                    const vector_view<const struct param> &params)
+{
+	assert(size(out) >= params.size() * 6);
+	size_t len(0);
+	for(const auto &param : params)
+	{
+		data(out)[len++] = param.id >> 8;
+		data(out)[len++] = param.id;
+		write32(out + len, param.value);
+		len += 4;
+	}
+
+	return const_buffer
+	{
+		data(out), len
+	};
+}
+
 ircd::string_view
 ircd::http2::reflect(const frame::settings::code &code)
 {
@@ -91,6 +187,136 @@ static_assert
     sizeof(ircd::http2::frame::header) == 9
 );
 
+void
+ircd::http2::frame::write(const mutable_buffer &out,
+                          const size_t &len,
+                          const type &type,
+                          const uint8_t &flags,
+                          const uint32_t &id)
+{
+	assert(size(out) >= sizeof(frame::header));
+	assert(len < (1UL << 24));
+	data(out)[0] = len >> 16;
+	data(out)[1] = len >> 8;
+	data(out)[2] = len;
+	data(out)[3] = type;
+	data(out)[4] = flags;
+	data(out)[5] = (id >> 24) & 0x7f;
+	data(out)[6] = id >> 16;
+	data(out)[7] = id >> 8;
+	data(out)[8] = id;
+}
+
+ircd::http2::frame::header
+ircd::http2::frame::read(const const_buffer &in)
+{
+	assert(size(in) >= sizeof(frame::header));
+	const auto *const p
+	{
+		reinterpret_cast<const uint8_t *>(data(in))
+	};
+
+	frame::header ret;
+	ret.len = uint32_t(p[0]) << 16 | uint32_t(p[1]) << 8 | p[2];
+	ret.type = frame::type(p[3]);
+	ret.flags = p[4];
+	ret.stream_id = parse32(in + 5) & 0x7fffffffU;
+	return ret;
+}
+
+/// The payload of a DATA or HEADERS frame without its padding and, for
+/// HEADERS, without the priority fields.
+ircd::const_buffer
+ircd::http2::frame::payload(const header &header,
+                            const_buffer payload)
+{
+	if(header.flags & flag::PADDED)
+	{
+		const uint8_t pad(!empty(payload)? data(payload)[0] : 0);
+		if(unlikely(empty(payload) || pad >= size(payload)))
+			throw error
+			{
+				error::PROTOCOL_ERROR, "invalid padding"
+			};
+
+		payload = const_buffer{data(payload) + 1, size(payload) - 1 - pad};
+	}
+
+	if(header.type == type::HEADERS && header.flags & flag::PRIORITY)
+	{
+		if(unlikely(size(payload) < 5))
+			throw error
+			{
+				error::FRAME_SIZE_ERROR, "truncated priority"
+			};
+
+		consume(payload, 5);
+	}
+
+	return payload;
+}
+
+/// Frames a header block as a HEADERS frame followed by as many CONTINUATION
+/// frames as the peer's max_frame requires. The sink is called with the
+/// frame header and the fragment of the block for each frame in order.
+void
+ircd::http2::frame::write_block(const const_buffer &block_,
+                                const uint32_t &id,
+                                const size_t &max_frame,
+                                const bool &eos,
+                                const sink &sink)
+{
+	assert(max_frame);
+	const_buffer block(block_);
+	auto kind(type::HEADERS);
+	do
+	{
+		const size_t len(std::min(size(block), max_frame));
+		const uint8_t flags
+		{
+			uint8_t
+			(
+				(len == size(block)? flag::END_HEADERS : 0) |
+				(kind == type::HEADERS && eos? flag::END_STREAM : 0)
+			)
+		};
+
+		char hdr[sizeof(frame::header)];
+		write(hdr, len, kind, flags, id);
+		sink(const_buffer{hdr, sizeof(hdr)}, const_buffer{data(block), len});
+		consume(block, len);
+		kind = type::CONTINUATION;
+	}
+	while(!empty(block));
+}
+
+uint32_t
+ircd::http2::parse32(const const_buffer &in)
+{
+	assert(size(in) >= 4);
+	const auto *const p
+	{
+		reinterpret_cast<const uint8_t *>(data(in))
+	};
+
+	return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+}
+
+ircd::const_buffer
+ircd::http2::write32(const mutable_buffer &out,
+                     const uint32_t &value)
+{
+	assert(size(out) >= 4);
+	data(out)[0] = value >> 24;
+	data(out)[1] = value >> 16;
+	data(out)[2] = value >> 8;
+	data(out)[3] = value;
+	return const_buffer
+	{
+		data(out), 4
+	};
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -167,3 +393,1605 @@ ircd::http2::reflect(const enum error::code &code)
 
 	return "??????";
 }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// hpack.h
+//
+
+namespace ircd::http2::hpack
+{
+	static size_t decode_int(const_buffer &in, const uint8_t &prefix);
+	static size_t encode_int(const mutable_buffer &out, const uint8_t &flags, const uint8_t &prefix, size_t value);
+	static string_view decode_str(mutable_buffer &buf, const_buffer &in);
+	static size_t encode_str(const mutable_buffer &out, const string_view &str);
+	static header lookup(const table &, const size_t &index);
+}
+
+/// RFC 7541 Appendix A
+decltype(ircd::http2::hpack::static_table)
+ircd::http2::hpack::static_table
+{
+	{ ":authority",                    ""                           },
+	{ ":method",                       "GET"                        },
+	{ ":method",                       "POST"                       },
+	{ ":path",                         "/"                          },
+	{ ":path",                         "/index.html"                },
+	{ ":scheme",                       "http"                       },
+	{ ":scheme",                       "https"                      },
+	{ ":status",                       "200"                        },
+	{ ":status",                       "204"                        },
+	{ ":status",                       "206"                        },
+	{ ":status",                       "304"                        },
+	{ ":status",                       "400"                        },
+	{ ":status",                       "404"                        },
+	{ ":status",                       "500"                        },
+	{ "accept-charset",                ""                           },
+	{ "accept-encoding",               "gzip, deflate"              },
+	{ "accept-language",               ""                           },
+	{ "accept-ranges",                 ""                           },
+	{ "accept",                        ""                           },
+	{ "access-control-allow-origin",   ""                           },
+	{ "age",                           ""                           },
+	{ "allow",                         ""                           },
+	{ "authorization",                 ""                           },
+	{ "cache-control",                 ""                           },
+	{ "content-disposition",           ""                           },
+	{ "content-encoding",              ""                           },
+	{ "content-language",              ""                           },
+	{ "content-length",                ""                           },
+	{ "content-location",              ""                           },
+	{ "content-range",                 ""                           },
+	{ "content-type",                  ""                           },
+	{ "cookie",                        ""                           },
+	{ "date",                          ""                           },
+	{ "etag",                          ""                           },
+	{ "expect",                        ""                           },
+	{ "expires",                       ""                           },
+	{ "from",                          ""                           },
+	{ "host",                          ""                           },
+	{ "if-match",                      ""                           },
+	{ "if-modified-since",             ""                           },
+	{ "if-none-match",                 ""                           },
+	{ "if-range",                      ""                           },
+	{ "if-unmodified-since",           ""                           },
+	{ "last-modified",                 ""                           },
+	{ "link",                          ""                           },
+	{ "location",                      ""                           },
+	{ "max-forwards",                  ""                           },
+	{ "proxy-authenticate",            ""                           },
+	{ "proxy-authorization",           ""                           },
+	{ "range",                         ""                           },
+	{ "referer",                       ""                           },
+	{ "refresh",                       ""                           },
+	{ "retry-after",                   ""                           },
+	{ "server",                        ""                           },
+	{ "set-cookie",                    ""                           },
+	{ "strict-transport-security",     ""                           },
+	{ "transfer-encoding",             ""                           },
+	{ "user-agent",                    ""                           },
+	{ "vary",                          ""                           },
+	{ "via",                           ""                           },
+	{ "www-authenticate",              ""                           },
+};
+
+namespace ircd::http2::hpack
+{
+	/// Symbols in order of their canonical Huffman code (RFC 7541 Appendix B)
+	static const uint16_t
+	huffman_sym[257]
+	{
+		 48,  49,  50,  97,  99, 101, 105, 111, 115, 116,  32,  37,  45,  46,  47,  51,
+		 52,  53,  54,  55,  56,  57,  61,  65,  95,  98, 100, 102, 103, 104, 108, 109,
+		110, 112, 114, 117,  58,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,
+		 77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,  89, 106, 107, 113, 118,
+		119, 120, 121, 122,  38,  42,  44,  59,  88,  90,  33,  34,  40,  41,  63,  39,
+		 43, 124,  35,  62,   0,  36,  64,  91,  93, 126,  94, 125,  60,  96, 123,  92,
+		195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161, 167, 172, 176, 177,
+		179, 209, 216, 217, 227, 229, 230, 129, 132, 133, 134, 136, 146, 154, 156, 160,
+		163, 164, 169, 170, 173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+		233,   1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150, 151, 152, 155, 157,
+		158, 165, 166, 168, 174, 175, 180, 182, 183, 188, 191, 197, 231, 239,   9, 142,
+		144, 145, 148, 159, 171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+		200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243, 255, 203, 204, 211,
+		212, 214, 221, 222, 223, 241, 244, 245, 246, 247, 248, 250, 251, 252, 253, 254,
+		  2,   3,   4,   5,   6,   7,   8,  11,  12,  14,  15,  16,  17,  18,  19,  20,
+		 21,  23,  24,  25,  26,  27,  28,  29,  30,  31, 127, 220, 249,  10,  13,  22,
+		256,
+	};
+
+	/// First code of each code length (index is length - 1)
+	static const uint32_t
+	huffman_first[30]
+	{
+		0x0, 0x0, 0x0, 0x0, 0x0, 0x14,
+		0x5c, 0xf8, 0x1fc, 0x3f8, 0x7fa, 0xffa,
+		0x1ff8, 0x3ffc, 0x7ffc, 0xfffe, 0x1fffc, 0x3fff8,
+		0x7fff0, 0xfffe6, 0x1fffdc, 0x3fffd2, 0x7fffd8, 0xffffea,
+		0x1ffffec, 0x3ffffe0, 0x7ffffde, 0xfffffe2, 0x1ffffffe, 0x3ffffffc,
+	};
+
+	/// Number of codes of each code length
+	static const uint16_t
+	huffman_count[30]
+	{
+		 0,  0,  0,  0, 10, 26, 32,  6,  0,  5,  3,  2,  6,  2,  3,
+		 0,  0,  0,  3,  8, 13, 26, 29, 12,  4, 15, 19, 29,  0,  4,
+	};
+
+	/// Index into huffman_sym of the first code of each length
+	static const uint16_t
+	huffman_offset[30]
+	{
+		  0,   0,   0,   0,   0,  10,  36,  68,  74,  74,  79,  82,  84,  90,  92,
+		 95,  95,  95,  95,  98, 106, 119, 145, 174, 186, 190, 205, 224, 253, 253,
+	};
+}
+
+size_t
+ircd::http2::hpack::huffman_decode(const mutable_buffer &out,
+                                   const const_buffer &in)
+{
+	size_t ret(0);
+	uint32_t code(0), len(0);
+	for(const char &c : in)
+		for(int bit(7); bit >= 0; --bit)
+		{
+			code = (code << 1) | ((uint8_t(c) >> bit) & 0x01);
+			if(unlikely(++len > 30))
+				throw error
+				{
+					error::COMPRESSION_ERROR, "invalid huffman code"
+				};
+
+			// With canonical codes any prefix of a longer code compares
+			// above the range of codes of the prefix's length.
+			const uint32_t idx(code - huffman_first[len - 1]);
+			if(code < huffman_first[len - 1] || idx >= huffman_count[len - 1])
+				continue;
+
+			const auto &sym
+			{
+				huffman_sym[huffman_offset[len - 1] + idx]
+			};
+
+			if(unlikely(sym == 256))
+				throw error
+				{
+					error::COMPRESSION_ERROR, "EOS in huffman string"
+				};
+
+			if(unlikely(ret >= size(out)))
+				throw error
+				{
+					error::COMPRESSION_ERROR, "huffman string too large"
+				};
+
+			data(out)[ret++] = sym;
+			code = 0;
+			len = 0;
+		}
+
+	// Padding is the most significant bits of EOS (all ones) and shorter
+	// than one octet (RFC 7541 5.2).
+	if(unlikely(len > 7 || code != (1U << len) - 1))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "invalid huffman padding"
+		};
+
+	return ret;
+}
+
+size_t
+ircd::http2::hpack::encode(const mutable_buffer &out,
+                           const header &header)
+{
+	const auto &[name, value]
+	{
+		header
+	};
+
+	size_t name_idx(0);
+	for(size_t i(0); i < std::size(static_table); ++i)
+	{
+		if(static_table[i].first != name)
+			continue;
+
+		if(static_table[i].second == value)
+			return encode_int(out, 0x80, 7, i + 1);
+
+		name_idx = name_idx?: i + 1;
+	}
+
+	// Literal Header Field without Indexing (RFC 7541 6.2.2)
+	size_t ret(0);
+	ret += encode_int(out, 0x00, 4, name_idx);
+	if(!name_idx)
+		ret += encode_str(out + ret, name);
+
+	ret += encode_str(out + ret, value);
+	return ret;
+}
+
+void
+ircd::http2::hpack::decoder::operator()(const const_buffer &block_,
+                                        const closure &closure)
+{
+	// Huffman coding expands by at most 8/5.
+	const unique_buffer<mutable_buffer> scratch
+	{
+		std::max(size(block_) * 2, 64UL)
+	};
+
+	const_buffer block(block_);
+	while(!empty(block))
+	{
+		const uint8_t lead(block[0]);
+
+		// Indexed Header Field (RFC 7541 6.1)
+		if(lead & 0x80)
+		{
+			const auto idx(decode_int(block, 7));
+			closure(lookup(dynamic, idx));
+			continue;
+		}
+
+		// Dynamic Table Size Update (RFC 7541 6.3)
+		if((lead & 0xe0) == 0x20)
+		{
+			const auto size(decode_int(block, 5));
+			if(unlikely(size > max_size))
+				throw error
+				{
+					error::COMPRESSION_ERROR, "table size %zu exceeds maximum %zu",
+					size,
+					max_size,
+				};
+
+			dynamic.resize(size);
+			continue;
+		}
+
+		// Literal Header Field (RFC 7541 6.2)
+		const bool indexing((lead & 0xc0) == 0x40);
+		const auto idx(decode_int(block, indexing? 6 : 4));
+		mutable_buffer buf(scratch);
+		const string_view name
+		{
+			idx?
+				lookup(dynamic, idx).first:
+				decode_str(buf, block)
+		};
+
+		const string_view value
+		{
+			decode_str(buf, block)
+		};
+
+		closure({name, value});
+		if(indexing)
+			dynamic.add({name, value});
+	}
+}
+
+ircd::http2::hpack::header
+ircd::http2::hpack::lookup(const table &dynamic,
+                           const size_t &idx)
+{
+	if(unlikely(!idx))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "invalid index 0"
+		};
+
+	if(idx <= std::size(static_table))
+		return static_table[idx - 1];
+
+	return dynamic.at(idx - std::size(static_table) - 1);
+}
+
+ircd::http2::hpack::header
+ircd::http2::hpack::table::at(const size_t &idx)
+const
+{
+	if(unlikely(idx >= entry.size()))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "dynamic table index %zu out of range",
+			idx,
+		};
+
+	const auto &[name, value]
+	{
+		entry.at(idx)
+	};
+
+	return header
+	{
+		name, value
+	};
+}
+
+void
+ircd::http2::hpack::table::add(const header &header)
+{
+	// Copied first; the header may refer to an entry evicted below.
+	std::pair<std::string, std::string> ent
+	{
+		header.first, header.second
+	};
+
+	const size_t sz
+	{
+		ent.first.size() + ent.second.size() + 32
+	};
+
+	while(!entry.empty() && bytes + sz > max)
+	{
+		bytes -= entry.back().first.size() + entry.back().second.size() + 32;
+		entry.pop_back();
+	}
+
+	if(sz > max)
+		return;
+
+	entry.emplace_front(std::move(ent));
+	bytes += sz;
+}
+
+void
+ircd::http2::hpack::table::resize(const size_t &max)
+{
+	this->max = max;
+	while(!entry.empty() && bytes > max)
+	{
+		bytes -= entry.back().first.size() + entry.back().second.size() + 32;
+		entry.pop_back();
+	}
+}
+
+ircd::string_view
+ircd::http2::hpack::decode_str(mutable_buffer &buf,
+                               const_buffer &in)
+{
+	if(unlikely(empty(in)))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "truncated string"
+		};
+
+	const bool huffman(uint8_t(in[0]) & 0x80);
+	const auto len(decode_int(in, 7));
+	if(unlikely(len > size(in)))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "truncated string"
+		};
+
+	const const_buffer str
+	{
+		data(in), len
+	};
+
+	consume(in, len);
+	if(!huffman)
+		return string_view
+		{
+			str
+		};
+
+	const string_view ret
+	{
+		data(buf), huffman_decode(buf, str)
+	};
+
+	consume(buf, size(ret));
+	return ret;
+}
+
+size_t
+ircd::http2::hpack::encode_str(const mutable_buffer &out,
+                               const string_view &str)
+{
+	size_t ret(0);
+	ret += encode_int(out, 0x00, 7, size(str));
+	if(unlikely(size(str) > size(out) - ret))
+		throw error
+		{
+			error::INTERNAL_ERROR, "header block buffer overflow"
+		};
+
+	ret += copy(out + ret, str);
+	return ret;
+}
+
+size_t
+ircd::http2::hpack::decode_int(const_buffer &in,
+                               const uint8_t &prefix)
+{
+	if(unlikely(empty(in)))
+		throw error
+		{
+			error::COMPRESSION_ERROR, "truncated integer"
+		};
+
+	const uint8_t mask((1U << prefix) - 1);
+	size_t ret(uint8_t(in[0]) & mask);
+	consume(in, 1);
+	if(ret < mask)
+		return ret;
+
+	for(uint shift(0);; shift += 7)
+	{
+		if(unlikely(empty(in) || shift > 28))
+			throw error
+			{
+				error::COMPRESSION_ERROR, "invalid integer"
+			};
+
+		const uint8_t octet(in[0]);
+		consume(in, 1);
+		ret += size_t(octet & 0x7f) << shift;
+		if(~octet & 0x80)
+			return ret;
+	}
+}
+
+size_t
+ircd::http2::hpack::encode_int(const mutable_buffer &out,
+                               const uint8_t &flags,
+                               const uint8_t &prefix,
+                               size_t value)
+{
+	size_t ret(0);
+	const auto put{[&out, &ret](const uint8_t &octet)
+	{
+		if(unlikely(ret >= size(out)))
+			throw error
+			{
+				error::INTERNAL_ERROR, "header block buffer overflow"
+			};
+
+		data(out)[ret++] = octet;
+	}};
+
+	const uint8_t mask((1U << prefix) - 1);
+	if(value < mask)
+	{
+		put(flags | value);
+		return ret;
+	}
+
+	put(flags | mask);
+	for(value -= mask; value >= 0x80; value >>= 7)
+		put((value & 0x7f) | 0x80);
+
+	put(value);
+	return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// connection.h
+//
+
+namespace ircd::http2
+{
+	static bool token(const string_view &, const bool &lower) noexcept;
+	static bool visible(const string_view &) noexcept;
+}
+
+decltype(ircd::http2::enable)
+ircd::http2::enable
+{
+	{ "name",     "ircd.http2.enable"  },
+	{ "default",  false                },
+};
+
+decltype(ircd::http2::connection::log)
+ircd::http2::connection::log
+{
+	"http2"
+};
+
+decltype(ircd::http2::connection::max_streams)
+ircd::http2::connection::max_streams
+{
+	{ "name",     "ircd.http2.max_streams"  },
+	{ "default",  128L                      },
+};
+
+decltype(ircd::http2::connection::window_size)
+ircd::http2::connection::window_size
+{
+	{ "name",     "ircd.http2.window_size"  },
+	{ "default",  long(1_MiB)               },
+};
+
+decltype(ircd::http2::connection::header_max)
+ircd::http2::connection::header_max
+{
+	{ "name",     "ircd.http2.header.max"  },
+	{ "default",  long(16_KiB)             },
+};
+
+decltype(ircd::http2::connection::content_max)
+ircd::http2::connection::content_max
+{
+	{ "name",     "ircd.http2.content.max"  },
+	{ "default",  long(8_MiB + 64_KiB)      },
+};
+
+decltype(ircd::http2::connection::stall_timeout)
+ircd::http2::connection::stall_timeout
+{
+	{ "name",     "ircd.http2.stall_timeout"  },
+	{ "default",  30000L                      },
+};
+
+ircd::http2::connection::connection(std::shared_ptr<net::socket> sock)
+:sock
+{
+	std::move(sock)
+}
+,in
+{
+	16_KiB + sizeof(frame::header)
+}
+{
+	ours[settings::code::ENABLE_PUSH] = 0;
+	ours[settings::code::MAX_CONCURRENT_STREAMS] = size_t(max_streams);
+	ours[settings::code::INITIAL_WINDOW_SIZE] = std::min(size_t(window_size), 0x7fffffffUL);
+	ours[settings::code::MAX_HEADER_LIST_SIZE] = size_t(header_max);
+}
+
+ircd::http2::connection::~connection()
+noexcept
+{
+	assert(streams.empty() || closing || !sock);
+}
+
+bool
+ircd::http2::connection::handle(const dispatch &dispatch)
+try
+{
+	size_t got(0); do
+	{
+		if(unlikely(closing))
+			return false;
+
+		got = net::read_one(*sock, mutable_buffer
+		{
+			data(in) + in_len, size(in) - in_len
+		});
+
+		in_len += got;
+		const_buffer buf
+		{
+			data(in), in_len
+		};
+
+		if(!preface)
+		{
+			if(size(buf) < size(connection_preface))
+				continue;
+
+			if(unlikely(!startswith(string_view(buf), connection_preface)))
+				throw error
+				{
+					error::PROTOCOL_ERROR, "invalid connection preface"
+				};
+
+			consume(buf, size(connection_preface));
+			preface = true;
+
+			const uint32_t extra
+			{
+				uint32_t(ours[settings::code::INITIAL_WINDOW_SIZE] - 65535)
+			};
+
+			const struct frame::settings::param params[]
+			{
+				{ settings::code::ENABLE_PUSH,             ours[settings::code::ENABLE_PUSH]             },
+				{ settings::code::MAX_CONCURRENT_STREAMS,  ours[settings::code::MAX_CONCURRENT_STREAMS]  },
+				{ settings::code::INITIAL_WINDOW_SIZE,     ours[settings::code::INITIAL_WINDOW_SIZE]     },
+				{ settings::code::MAX_HEADER_LIST_SIZE,    ours[settings::code::MAX_HEADER_LIST_SIZE]    },
+			};
+
+			char param[6 * 4];
+			write_frame(frame::type::SETTINGS, 0, 0, frame::settings::write(param, params));
+
+			// The connection receive window is opened to match the streams.
+			char inc[4];
+			if(extra)
+				write_frame(frame::type::WINDOW_UPDATE, 0, 0, write32(inc, extra));
+
+			recv_window += extra;
+		}
+
+		while(size(buf) >= sizeof(frame::header))
+		{
+			const auto header
+			{
+				frame::read(buf)
+			};
+
+			if(unlikely(header.len > ours[settings::code::MAX_FRAME_SIZE]))
+				throw error
+				{
+					error::FRAME_SIZE_ERROR, "frame length %u exceeds maximum",
+					uint32_t(header.len),
+				};
+
+			if(size(buf) < sizeof(frame::header) + header.len)
+				break;
+
+			const const_buffer payload
+			{
+				data(buf) + sizeof(frame::header), header.len
+			};
+
+			handle_frame(header, payload, dispatch);
+			consume(buf, sizeof(frame::header) + header.len);
+		}
+
+		in_len = size(buf);
+		std::memmove(data(in), data(buf), in_len);
+	}
+	while(got || net::pending(*sock));
+
+	return !closing;
+}
+catch(const error &e)
+{
+	log::derror
+	{
+		log, "socket:%lu :%s",
+		net::id(*sock),
+		e.what(),
+	};
+
+	if(!closing)
+		goaway(e.code);
+
+	return false;
+}
+
+void
+ircd::http2::connection::handle_frame(const frame::header &header,
+                                      const const_buffer &payload,
+                                      const dispatch &dispatch)
+{
+	if(unlikely(continuation && (header.type != frame::type::CONTINUATION || header.stream_id != continuation)))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "expected CONTINUATION for stream %u",
+			continuation,
+		};
+
+	switch(header.type)
+	{
+		case frame::type::DATA:
+			return handle_data(header, payload, dispatch);
+
+		case frame::type::HEADERS:
+			return handle_headers(header, payload, dispatch);
+
+		case frame::type::CONTINUATION:
+			return handle_continuation(header, payload, dispatch);
+
+		case frame::type::SETTINGS:
+			return handle_settings(header, payload);
+
+		case frame::type::WINDOW_UPDATE:
+			return handle_window_update(header, payload);
+
+		case frame::type::RST_STREAM:
+			return handle_rst_stream(header, payload);
+
+		case frame::type::PING:
+			return handle_ping(header, payload);
+
+		case frame::type::GOAWAY:
+			return handle_goaway(header, payload);
+
+		case frame::type::PUSH_PROMISE:
+			throw error
+			{
+				error::PROTOCOL_ERROR, "PUSH_PROMISE from client"
+			};
+
+		// Priority is advisory; unknown frame types are ignored (RFC 7540 4.1)
+		case frame::type::PRIORITY:
+		default:
+			return;
+	}
+}
+
+void
+ircd::http2::connection::handle_headers(const frame::header &header,
+                                        const_buffer payload,
+                                        const dispatch &dispatch)
+{
+	const uint32_t id(header.stream_id);
+	if(unlikely(!id || id % 2 == 0))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "HEADERS on invalid stream %u", id
+		};
+
+	payload = frame::payload(header, payload);
+	auto *s(find(id));
+	if(!s)
+	{
+		if(unlikely(id <= last_id))
+			throw error
+			{
+				error::STREAM_CLOSED, "HEADERS on closed stream %u", id
+			};
+
+		last_id = id;
+		const auto it
+		{
+			streams.emplace(id, std::make_shared<stream>(id)).first
+		};
+
+		s = it->second.get();
+		s->state = stream::state::OPEN;
+		s->window = theirs[settings::code::INITIAL_WINDOW_SIZE];
+		s->recv_window = ours[settings::code::INITIAL_WINDOW_SIZE];
+
+		// The header block is decoded regardless to keep the decoder state.
+		if(streams.size() > size_t(max_streams))
+			s->reset = true;
+	}
+	else if(unlikely(s->state != stream::state::OPEN || !(header.flags & flag::END_STREAM)))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "unexpected HEADERS on stream %u", id
+		};
+
+	if(header.flags & flag::END_STREAM)
+		s->state = stream::state::HALF_CLOSED_REMOTE;
+
+	s->block.append(data(payload), size(payload));
+	handle_continuation(header, {}, dispatch);
+}
+
+void
+ircd::http2::connection::handle_continuation(const frame::header &header,
+                                             const const_buffer &payload,
+                                             const dispatch &dispatch)
+{
+	const uint32_t id(header.stream_id);
+	auto *const s(find(id));
+	if(unlikely(!s || (header.type == frame::type::CONTINUATION && continuation != id)))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "unexpected CONTINUATION on stream %u", id
+		};
+
+	s->block.append(data(payload), size(payload));
+	if(unlikely(s->block.size() > size_t(header_max)))
+		throw error
+		{
+			error::ENHANCE_YOUR_CALM, "header block on stream %u too large", id
+		};
+
+	continuation = id;
+	if(~header.flags & flag::END_HEADERS)
+		return;
+
+	continuation = 0;
+	const bool trailers(!s->head.empty() || s->dispatched);
+	std::string method, path, authority, headers;
+	bool valid(true), host(false), regular(false);
+	size_t list_size(0);
+	decoder(const_buffer{s->block}, [&](const hpack::header &header)
+	{
+		const auto &[name, value]
+		{
+			header
+		};
+
+		list_size += size(name) + size(value) + 32;
+		valid &= list_size <= size_t(header_max);
+		valid &= !has(value, '\r') && !has(value, '\n') && !has(value, '\0');
+		if(!valid || trailers)
+			return;
+
+		// The head is synthesized as HTTP/1.1 so anything which could alter
+		// its framing is malformed (RFC 7540 8.1.2, 8.1.2.1, 8.1.2.6).
+		if(startswith(name, ':'))
+		{
+			valid &= !regular;
+			if(name == ":method")
+			{
+				valid &= method.empty() && token(value, false);
+				method = value;
+			}
+			else if(name == ":path")
+			{
+				valid &= path.empty() && visible(value);
+				path = value;
+			}
+			else if(name == ":authority")
+			{
+				valid &= visible(value);
+				authority = value;
+			}
+			else if(name != ":scheme")
+				valid = false;
+
+			return;
+		}
+
+		regular = true;
+		valid &= token(name, true);
+		if(!valid)
+			return;
+
+		// Hop-by-hop fields are not part of HTTP/2 (RFC 7540 8.1.2.2); the
+		// content-length is supplied when the request is composed.
+		if(name == "connection" || name == "keep-alive" || name == "transfer-encoding" || name == "upgrade" || name == "content-length")
+			return;
+
+		host |= name == "host";
+		headers.append(name);
+		headers.append(": ");
+		headers.append(value);
+		headers.append("\r\n");
+	});
+
+	s->block.clear();
+	s->block.shrink_to_fit();
+	if(trailers)
+		return ready(*s, dispatch);
+
+	if(unlikely(!valid || method.empty() || path.empty()))
+	{
+		rst(*s, error::PROTOCOL_ERROR);
+		return;
+	}
+
+	s->head.reserve(method.size() + path.size() + authority.size() + headers.size() + 32);
+	s->head.append(method);
+	s->head.append(" ");
+	s->head.append(path);
+	s->head.append(" HTTP/1.1\r\n");
+	if(!host && !authority.empty())
+	{
+		s->head.append("host: ");
+		s->head.append(authority);
+		s->head.append("\r\n");
+	}
+
+	s->head.append(headers);
+	ready(*s, dispatch);
+}
+
+/// Header field name or method: one or more tchar (RFC 7230 3.2.6); names
+/// must also be lowercase in HTTP/2.
+bool
+ircd::http2::token(const string_view &str,
+                   const bool &lower)
+noexcept
+{
+	static const string_view special
+	{
+		"!#$%&'*+-.^_`|~"
+	};
+
+	return !empty(str) && std::all_of(begin(str), end(str), [&lower]
+	(const char &c)
+	{
+		return false
+		|| (c >= 'a' && c <= 'z')
+		|| (c >= '0' && c <= '9')
+		|| (!lower && c >= 'A' && c <= 'Z')
+		|| has(special, c)
+		;
+	});
+}
+
+/// Free of SP and CTL, for pseudo-header values which become part of the
+/// request line.
+bool
+ircd::http2::visible(const string_view &str)
+noexcept
+{
+	return std::all_of(begin(str), end(str), []
+	(const char &c)
+	{
+		return uint8_t(c) > 0x20 && uint8_t(c) != 0x7f;
+	});
+}
+
+void
+ircd::http2::connection::handle_data(const frame::header &header,
+                                     const_buffer payload,
+                                     const dispatch &dispatch)
+{
+	const uint32_t id(header.stream_id);
+	if(unlikely(!id || id > last_id))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "DATA on idle stream %u", id
+		};
+
+	// Flow control counts the whole payload including padding.
+	if(unlikely(int64_t(header.len) > recv_window))
+		throw error
+		{
+			error::FLOW_CONTROL_ERROR, "DATA exceeds connection window by %ld",
+			int64_t(header.len) - recv_window,
+		};
+
+	const int64_t initial
+	{
+		ours[settings::code::INITIAL_WINDOW_SIZE]
+	};
+
+	// The connection window is replenished in batches once half of it has
+	// been taken; each stream's buffer is bounded separately below.
+	char inc[4];
+	recv_window -= header.len;
+	recv_unacked += header.len;
+	if(int64_t(recv_unacked) >= initial / 2)
+	{
+		write_frame(frame::type::WINDOW_UPDATE, 0, 0, write32(inc, recv_unacked));
+		recv_window += recv_unacked;
+		recv_unacked = 0;
+	}
+
+	payload = frame::payload(header, payload);
+
+	auto *const s(find(id));
+	if(!s || s->reset)
+		return;
+
+	if(unlikely(s->state != stream::state::OPEN || !s->block.empty()))
+	{
+		rst(*s, error::STREAM_CLOSED);
+		return;
+	}
+
+	if(unlikely(int64_t(header.len) > s->recv_window))
+	{
+		rst(*s, error::FLOW_CONTROL_ERROR);
+		return;
+	}
+
+	if(unlikely(s->content.size() + size(payload) > size_t(content_max)))
+	{
+		rst(*s, error::REFUSED_STREAM);
+		return;
+	}
+
+	s->recv_window -= header.len;
+	s->content.append(data(payload), size(payload));
+
+	// The stream window is reopened once half of it has been taken, but
+	// never beyond what remains of content_max; a peer can't be invited to
+	// send more than the stream is allowed to buffer.
+	const int64_t remain
+	{
+		int64_t(content_max) - int64_t(s->content.size()) - s->recv_window
+	};
+
+	const int64_t grant
+	{
+		std::min(initial - s->recv_window, remain)
+	};
+
+	if(~header.flags & flag::END_STREAM && s->recv_window < initial / 2 && grant > 0)
+	{
+		write_frame(frame::type::WINDOW_UPDATE, 0, id, write32(inc, grant));
+		s->recv_window += grant;
+	}
+
+	if(header.flags & flag::END_STREAM)
+	{
+		s->state = stream::state::HALF_CLOSED_REMOTE;
+		ready(*s, dispatch);
+	}
+}
+
+void
+ircd::http2::connection::handle_settings(const frame::header &header,
+                                         const const_buffer &payload)
+{
+	const bool params
+	{
+		frame::settings::read(header, payload, [this]
+		(const auto &code, const auto &value)
+		{
+			if(code == settings::code::INITIAL_WINDOW_SIZE)
+			{
+				const int64_t delta(int64_t(value) - theirs[code]);
+				for(auto &it : streams)
+					it.second->window += delta;
+			}
+
+			theirs[code] = value;
+		})
+	};
+
+	if(!params)
+		return;
+
+	write_frame(frame::type::SETTINGS, flag::ACK, 0);
+	dock.notify_all();
+}
+
+void
+ircd::http2::connection::handle_window_update(const frame::header &header,
+                                              const const_buffer &payload)
+{
+	if(unlikely(size(payload) != 4))
+		throw error
+		{
+			error::FRAME_SIZE_ERROR, "invalid WINDOW_UPDATE length %zu",
+			size(payload),
+		};
+
+	const uint32_t inc
+	{
+		parse32(payload) & 0x7fffffffU
+	};
+
+	if(!header.stream_id)
+	{
+		if(unlikely(!inc || window + inc > 0x7fffffffL))
+			throw error
+			{
+				error::FLOW_CONTROL_ERROR, "invalid connection WINDOW_UPDATE %u", inc
+			};
+
+		window += inc;
+		dock.notify_all();
+		return;
+	}
+
+	auto *const s(find(header.stream_id));
+	if(!s || s->reset)
+		return;
+
+	if(unlikely(!inc || s->window + inc > 0x7fffffffL))
+	{
+		rst(*s, error::FLOW_CONTROL_ERROR);
+		return;
+	}
+
+	s->window += inc;
+	dock.notify_all();
+}
+
+void
+ircd::http2::connection::handle_rst_stream(const frame::header &header,
+                                           const const_buffer &payload)
+{
+	if(unlikely(size(payload) != 4))
+		throw error
+		{
+			error::FRAME_SIZE_ERROR, "invalid RST_STREAM length %zu",
+			size(payload),
+		};
+
+	if(unlikely(!header.stream_id || header.stream_id > last_id))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "RST_STREAM on idle stream %u",
+			uint32_t(header.stream_id),
+		};
+
+	auto *const s(find(header.stream_id));
+	if(!s)
+		return;
+
+	log::debug
+	{
+		log, "socket:%lu stream:%u reset by peer :%s",
+		net::id(*sock),
+		s->id,
+		reflect(static_cast<enum error::code>(parse32(payload))),
+	};
+
+	s->reset = true;
+	s->state = stream::state::CLOSED;
+	if(s->context)
+		ctx::interrupt(*s->context);
+
+	if(!s->dispatched)
+		streams.erase(header.stream_id);
+
+	dock.notify_all();
+}
+
+void
+ircd::http2::connection::handle_ping(const frame::header &header,
+                                     const const_buffer &payload)
+{
+	if(unlikely(size(payload) != 8))
+		throw error
+		{
+			error::FRAME_SIZE_ERROR, "invalid PING length %zu",
+			size(payload),
+		};
+
+	if(unlikely(header.stream_id))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "PING on stream %u",
+			uint32_t(header.stream_id),
+		};
+
+	if(~header.flags & flag::ACK)
+		write_frame(frame::type::PING, flag::ACK, 0, payload);
+}
+
+void
+ircd::http2::connection::handle_goaway(const frame::header &header,
+                                       const const_buffer &payload)
+{
+	if(unlikely(size(payload) < 8 || header.stream_id))
+		throw error
+		{
+			error::PROTOCOL_ERROR, "invalid GOAWAY"
+		};
+
+	// The peer will open no further streams; those in flight complete.
+	log::debug
+	{
+		log, "socket:%lu goaway last:%u :%s",
+		net::id(*sock),
+		parse32(payload) & 0x7fffffffU,
+		reflect(static_cast<enum error::code>(parse32(payload + 4))),
+	};
+}
+
+void
+ircd::http2::connection::ready(stream &s,
+                               const dispatch &dispatch)
+{
+	if(s.reset)
+	{
+		if(!s.dispatched)
+			rst(s, error::REFUSED_STREAM);
+
+		return;
+	}
+
+	if(s.dispatched || s.head.empty() || !s.block.empty())
+		return;
+
+	if(s.state != stream::state::HALF_CLOSED_REMOTE)
+		return;
+
+	s.dispatched = true;
+	dispatch(s);
+}
+
+ircd::unique_buffer<ircd::mutable_buffer>
+ircd::http2::connection::request(stream &s)
+{
+	char lenbuf[64];
+	const string_view content_length
+	{
+		fmt::sprintf
+		{
+			lenbuf, "content-length: %zu\r\n\r\n", s.content.size()
+		}
+	};
+
+	unique_buffer<mutable_buffer> ret
+	{
+		std::max(s.head.size() + size(content_length) + s.content.size(), size_t(8_KiB))
+	};
+
+	mutable_buffer out(ret);
+	consume(out, copy(out, string_view(s.head)));
+	consume(out, copy(out, content_length));
+	consume(out, copy(out, string_view(s.content)));
+	std::string{}.swap(s.head);
+	std::string{}.swap(s.content);
+	return ret;
+}
+
+ircd::http2::stream *
+ircd::http2::connection::find(const uint32_t &id)
+{
+	const auto it
+	{
+		streams.find(id)
+	};
+
+	return it != end(streams)?
+		it->second.get():
+		nullptr;
+}
+
+void
+ircd::http2::connection::cancel(const uint32_t &id)
+{
+	auto *const s(find(id));
+	if(!s || s->reset)
+		return;
+
+	s->cancelled = true;
+	if(s->context && s->context != ctx::current)
+		ctx::interrupt(*s->context);
+
+	dock.notify_all();
+}
+
+void
+ircd::http2::connection::finish(const uint32_t &id)
+{
+	const auto it
+	{
+		streams.find(id)
+	};
+
+	if(it == end(streams))
+		return;
+
+	const auto s(it->second);
+	s->context = nullptr;
+	if(!s->reset && !closing) try
+	{
+		// A response without content (e.g. HEAD) is ended here; otherwise
+		// an incomplete response is reset so it isn't taken as complete.
+		if(!s->cancelled && s->phase == 1 && !s->sent)
+			write_data(*s, {}, true);
+		else if(s->cancelled || s->phase != 6)
+			rst(*s, s->cancelled? error::CANCEL : error::INTERNAL_ERROR);
+	}
+	catch(const std::exception &e)
+	{
+		log::derror
+		{
+			log, "socket:%lu stream:%u finish :%s",
+			net::id(*sock),
+			id,
+			e.what(),
+		};
+	}
+
+	streams.erase(id);
+	dock.notify_all();
+}
+
+size_t
+ircd::http2::connection::write(stream &s,
+                               const const_buffer &buf)
+{
+	if(unlikely(s.reset || s.cancelled || closing))
+		throw error
+		{
+			error::CANCEL, "stream %u closed", s.id
+		};
+
+	const_buffer in(buf);
+	if(s.phase == 0)
+	{
+		const size_t had(s.head.size());
+		s.head.append(data(in), size(in));
+		const auto pos(s.head.find("\r\n\r\n"));
+		if(pos == s.head.npos)
+		{
+			if(unlikely(s.head.size() > size_t(header_max)))
+				throw error
+				{
+					error::INTERNAL_ERROR, "response head too large"
+				};
+
+			return size(buf);
+		}
+
+		s.head.resize(pos + 4);
+		consume(in, s.head.size() - had);
+		write_head(s);
+	}
+
+	write_body(s, in);
+	return size(buf);
+}
+
+/// The HTTP/1.1 response head is parsed and sent as a HEADERS frame, split
+/// into CONTINUATION frames as required by the peer's MAX_FRAME_SIZE.
+void
+ircd::http2::connection::write_head(stream &s)
+{
+	std::vector<http::header> headers;
+	parse::buffer pb{const_buffer{s.head}};
+	parse::capstan pc{pb};
+	const http::response::head head
+	{
+		pc, [&headers](const http::header &header)
+		{
+			headers.emplace_back(header);
+		}
+	};
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		s.head.size() + 64 + headers.size() * 8
+	};
+
+	// Lowercased names are carved from a buffer the size of the head so no
+	// name can be truncated.
+	const unique_buffer<mutable_buffer> names
+	{
+		s.head.size()
+	};
+
+	mutable_buffer namebuf(names);
+	mutable_buffer out(buf);
+	consume(out, hpack::encode(out, {":status", head.status}));
+	for(const auto &[key, val] : headers)
+	{
+		const string_view name
+		{
+			tolower(namebuf, key)
+		};
+
+		consume(namebuf, size(name));
+
+		if(name == "connection" || name == "keep-alive" || name == "transfer-encoding" || name == "upgrade")
+			continue;
+
+		consume(out, hpack::encode(out, {name, val}));
+	}
+
+	const uint status(lex_cast<uint>(head.status));
+	const bool chunked(iequals(head.transfer_encoding, "chunked"_sv));
+	const bool empty_content
+	{
+		(status >= 100 && status < 200) || status == 204 || status == 304 || (!chunked && !head.content_length)
+	};
+
+	const const_buffer block
+	{
+		data(buf), size(buf) - size(out)
+	};
+
+	const size_t max_frame(theirs[settings::code::MAX_FRAME_SIZE]);
+	const std::lock_guard lock
+	{
+		write_mutex
+	};
+
+	frame::write_block(block, s.id, max_frame, empty_content, [this]
+	(const const_buffer &hdr, const const_buffer &fragment)
+	{
+		const const_buffer iov[]
+		{
+			hdr, fragment
+		};
+
+		net::write_all(*sock, iov);
+	});
+
+	std::string{}.swap(s.head);
+	s.remain = head.content_length;
+	s.phase = empty_content? 6 : chunked? 2 : 1;
+	if(empty_content)
+		s.state = stream::state::CLOSED;
+}
+
+/// Phases of the response body: 1 content-length bytes remaining; 2 chunk
+/// size line; 3 chunk data; 4 chunk data terminator; 5 trailer; 6 complete.
+size_t
+ircd::http2::connection::write_body(stream &s,
+                                    const const_buffer &buf)
+{
+	const_buffer in(buf);
+	while(!empty(in)) switch(s.phase)
+	{
+		case 1:
+		case 3:
+		{
+			const size_t len(std::min(size(in), s.remain));
+			s.remain -= len;
+			write_data(s, {data(in), len}, s.phase == 1 && !s.remain);
+			consume(in, len);
+			if(!s.remain)
+				s.phase = s.phase == 1? 6 : 4;
+
+			if(s.phase == 4)
+				s.remain = 2;
+
+			continue;
+		}
+
+		case 2:
+		{
+			const string_view str(in);
+			const auto pos(str.find('\n'));
+			const size_t len(pos != str.npos? pos + 1 : size(str));
+			s.chunk.append(data(in), len);
+			consume(in, len);
+			if(unlikely(s.chunk.size() > 64))
+				throw error
+				{
+					error::INTERNAL_ERROR, "invalid chunk size line"
+				};
+
+			if(pos == str.npos)
+				continue;
+
+			s.remain = 0;
+			for(const char &c : s.chunk)
+			{
+				if(!std::isxdigit(c))
+					break;
+
+				s.remain <<= 4;
+				s.remain |= c <= '9'? c - '0': std::tolower(c) - 'a' + 10;
+			}
+
+			s.chunk.clear();
+			s.phase = s.remain? 3 : 5;
+			continue;
+		}
+
+		case 4:
+		{
+			const size_t len(std::min(size(in), s.remain));
+			s.remain -= len;
+			consume(in, len);
+			if(!s.remain)
+				s.phase = 2;
+
+			continue;
+		}
+
+		case 5:
+		{
+			// Any trailer fields are discarded; the section ends with an
+			// empty line.
+			const string_view str(in);
+			const auto pos(str.find('\n'));
+			const size_t len(pos != str.npos? pos + 1 : size(str));
+			s.chunk.append(data(in), len);
+			consume(in, len);
+			if(pos == str.npos)
+				continue;
+
+			const bool last(s.chunk == "\r\n" || s.chunk == "\n");
+			s.chunk.clear();
+			if(!last)
+				continue;
+
+			write_data(s, {}, true);
+			s.phase = 6;
+			continue;
+		}
+
+		default:
+			return size(buf) - size(in);
+	}
+
+	return size(buf);
+}
+
+void
+ircd::http2::connection::write_data(stream &s,
+                                    const const_buffer &buf,
+                                    const bool &eos)
+{
+	const_buffer remain(buf);
+	if(empty(remain))
+	{
+		if(eos)
+		{
+			write_frame(frame::type::DATA, flag::END_STREAM, s.id);
+			s.state = stream::state::CLOSED;
+		}
+
+		return;
+	}
+
+	do
+	{
+		const bool ok
+		{
+			dock.wait_for(milliseconds(stall_timeout), [this, &s]
+			{
+				return (window > 0 && s.window > 0) || s.reset || s.cancelled || closing;
+			})
+		};
+
+		if(unlikely(!ok || s.reset || s.cancelled || closing))
+			throw error
+			{
+				error::CANCEL, "stream %u %s",
+				s.id,
+				!ok? "stalled by flow control"_sv: "closed"_sv,
+			};
+
+		const size_t len
+		{
+			std::min
+			({
+				size(remain),
+				size_t(window),
+				size_t(s.window),
+				size_t(theirs[settings::code::MAX_FRAME_SIZE]),
+			})
+		};
+
+		const bool last(eos && len == size(remain));
+		window -= len;
+		s.window -= len;
+		s.sent += len;
+		write_frame(frame::type::DATA, last? flag::END_STREAM : 0, s.id, {data(remain), len});
+		consume(remain, len);
+		if(last)
+			s.state = stream::state::CLOSED;
+	}
+	while(!empty(remain));
+}
+
+void
+ircd::http2::connection::rst(stream &s,
+                             const enum error::code &code)
+{
+	const uint32_t id(s.id);
+	char buf[4];
+	const const_buffer payload
+	{
+		write32(buf, code)
+	};
+
+	s.reset = true;
+	s.state = stream::state::CLOSED;
+	if(s.context && s.context != ctx::current)
+		ctx::interrupt(*s.context);
+
+	if(!s.dispatched)
+		streams.erase(id);
+
+	dock.notify_all();
+	write_frame(frame::type::RST_STREAM, 0, id, payload);
+}
+
+void
+ircd::http2::connection::goaway(const enum error::code &code)
+{
+	char payload[8];
+	write32(payload, last_id);
+	write32(mutable_buffer{payload + 4, 4}, code);
+
+	closing = true;
+	for(const auto &[id, s] : streams)
+		if(s->context)
+			ctx::interrupt(*s->context);
+
+	dock.notify_all();
+	write_frame(frame::type::GOAWAY, 0, 0, {payload, sizeof(payload)});
+}
+
+void
+ircd::http2::connection::write_frame(const frame::type &type,
+                                     const uint8_t &flags,
+                                     const uint32_t &id,
+                                     const const_buffer &payload)
+{
+	char hdr[sizeof(frame::header)];
+	frame::write(hdr, size(payload), type, flags, id);
+	const const_buffer iov[]
+	{
+		{ hdr, sizeof(hdr) },
+		payload,
+	};
+
+	const std::lock_guard lock
+	{
+		write_mutex
+	};
+
+	net::write_all(*sock, iov);
+}
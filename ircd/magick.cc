@@ -39,6 +39,8 @@ namespace ircd::magick
 	extern conf::item<uint64_t> limit_cycles;
 	extern conf::item<uint64_t> yield_threshold;
 	extern conf::item<uint64_t> yield_interval;
+	extern conf::item<bool> offload_enable;
+	extern const ctx::ole::opts offload_opts;
 	extern log::log log;
 }
 
@@ -91,11 +93,33 @@ ircd::magick::yield_interval
 	{ "default", 768L                         },
 };
 
+decltype(ircd::magick::offload_enable)
+ircd::magick::offload_enable
+{
+	{ "name",    "ircd.magick.offload.enable" },
+	{ "default", true                         },
+	{ "description",
+
+	R"(
+	Conduct transforms on an offload thread (see: ircd.ctx.ole). When false
+	transforms run on the calling context, which periodically yields to keep
+	the main thread responsive (see: ircd.magick.yield).
+	)"}
+};
+
+decltype(ircd::magick::offload_opts)
+ircd::magick::offload_opts
+{
+	"magick"
+};
+
 // It is likely that we can't have two contexts enter libmagick
 // simultaneously. This race is possible if the progress callback yields
 // and another context starts an operation. It is highly unlikely the lib
 // can handle reentrancy on the same thread. Hitting thread mutexes within
-// magick will also be catastrophic to ircd::ctx.
+// magick will also be catastrophic to ircd::ctx. The mutex is held by the
+// calling context for the duration of each operation, including while it
+// waits for an offload thread to conduct the operation.
 decltype(ircd::magick::call_mutex)
 ircd::magick::call_mutex;
 
@@ -440,39 +464,66 @@ ircd::magick::transform::transform(const const_buffer &input,
                                    const output &output,
                                    const transformer &transformer)
 {
-	const custom_ptr<ImageInfo> input_info
+	size_t output_size(0);
+	custom_ptr<void> output_data
 	{
-		CloneImageInfo(nullptr),
-		DestroyImageInfo
+		nullptr, MagickFree
 	};
 
-	const custom_ptr<ImageInfo> output_info
+	// All library calls for the transform are made from here, which may run
+	// on another thread. The output closure is called afterward back on this
+	// context with the library released, as it may itself transform (see:
+	// thumbcrop) or conduct I/O with the result.
+	const auto work{[&input, &transformer, &output_data, &output_size]
 	{
-		CloneImageInfo(nullptr),
-		DestroyImageInfo
-	};
+		const custom_ptr<ImageInfo> input_info
+		{
+			CloneImageInfo(nullptr),
+			DestroyImageInfo
+		};
 
-	const custom_ptr<Image> input_image
-	{
-		callex<Image *>(BlobToImage, input_info.get(), data(input), size(input)),
-		DestroyImage // pollock
-	};
+		const custom_ptr<ImageInfo> output_info
+		{
+			CloneImageInfo(nullptr),
+			DestroyImageInfo
+		};
 
-	const custom_ptr<Image> output_image
-	{
-		transformer({*input_info, input_image.get()}),
-		DestroyImage
-	};
+		const custom_ptr<Image> input_image
+		{
+			callex<Image *>(BlobToImage, input_info.get(), data(input), size(input)),
+			DestroyImage // pollock
+		};
+
+		const custom_ptr<Image> output_image
+		{
+			transformer({*input_info, input_image.get()}),
+			DestroyImage
+		};
+
+		output_data.reset
+		(
+			callex<void *>(ImageToBlob, output_info.get(), output_image.get(), &output_size)
+		);
+	}};
 
-	size_t output_size(0);
-	const auto output_data
 	{
-		callex<void *>(ImageToBlob, output_info.get(), output_image.get(), &output_size)
-	};
+		const std::lock_guard lock
+		{
+			call_mutex
+		};
+
+		if(offload_enable && ctx::current)
+			ctx::offload
+			{
+				offload_opts, work
+			};
+		else
+			work();
+	}
 
 	const const_buffer result
 	{
-		reinterpret_cast<char *>(output_data), output_size
+		static_cast<const char *>(output_data.get()), output_size
 	};
 
 	output(result);
@@ -484,6 +535,11 @@ ircd::magick::transform::transform(const const_buffer &input,
 
 ircd::magick::display::display(const const_buffer &input)
 {
+	const std::lock_guard lock
+	{
+		call_mutex
+	};
+
 	const custom_ptr<ImageInfo> input_info
 	{
 		CloneImageInfo(nullptr),
@@ -496,15 +552,17 @@ ircd::magick::display::display(const const_buffer &input)
 		DestroyImage // pollock
 	};
 
-	display
-	{
-		*input_info, *input_image
-	};
+	callpf(DisplayImages, input_info.get(), input_image.get());
 }
 
 ircd::magick::display::display(const ImageInfo &info,
                                Image &image)
 {
+	const std::lock_guard lock
+	{
+		call_mutex
+	};
+
 	callpf(DisplayImages, &info, &image);
 }
 
@@ -525,11 +583,8 @@ ircd::magick::callex(function&& f,
 			"Graphics library not ready."
 		};
 
-	const std::lock_guard lock
-	{
-		call_mutex
-	};
-
+	// The caller holds the call_mutex, though this may be on an offload
+	// thread where the ircd::ctx::mutex cannot be touched.
 	ExceptionInfo ei;
 	GetExceptionInfo(&ei); // initializer
 	const unwind destroy{[&ei]
@@ -582,11 +637,6 @@ ircd::magick::call(function&& f,
 			"Graphics library not ready."
 		};
 
-	const std::lock_guard lock
-	{
-		call_mutex
-	};
-
 	assert(call_ready);
 	return f(std::forward<args>(a)...);
 }
@@ -628,10 +678,13 @@ noexcept try
 	// Sample the current reference cycle count first and once. This is an
 	// accumulated cycle count for only this ircd::ctx and the current slice,
 	// (all other cycles are not accumulated here) which is non-zero by now
-	// and monotonically increases across jobs as well.
+	// and monotonically increases across jobs as well. On an offload thread
+	// there is no ircd::ctx and the thread's own cycle counter is used.
 	const auto cycles_sample
 	{
-		ctx::this_ctx::cycles()
+		ctx::current?
+			ctx::this_ctx::cycles():
+			prof::cycles()
 	};
 
 	// Detect if this is a new job. Tick is usually zero for a new job, but for
@@ -742,6 +795,10 @@ ircd::magick::check_cycles(job &job)
 bool
 ircd::magick::check_yield(job &job)
 {
+	// Jobs on an offload thread don't hold up the main thread.
+	if(!ctx::current)
+		return false;
+
 	const uint64_t &yield_threshold
 	{
 		magick::yield_threshold
@@ -71,6 +71,7 @@ ircd::net::init::init()
 	init_ipv6();
 	sslv23_client.set_verify_mode(asio::ssl::verify_peer);
 	sslv23_client.set_default_verify_paths();
+	SSL_CTX_set_session_cache_mode(sslv23_client.native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
 	_dns_.emplace();
 }
 
@@ -176,6 +177,43 @@ noexcept
 	};
 }
 
+/// The session negotiated on the socket if it can be offered for resumption
+/// on a later connection; otherwise null. With TLS 1.3 the session is only
+/// resumable once the remote's ticket has arrived after the handshake.
+std::shared_ptr<ircd::openssl::SSL_SESSION>
+ircd::net::session(const socket &socket)
+noexcept
+{
+	if(!socket.ssl)
+		return {};
+
+	SSL_SESSION *const session
+	{
+		SSL_get1_session(mutable_cast(socket).ssl->native_handle())
+	};
+
+	if(!session)
+		return {};
+
+	if(!SSL_SESSION_is_resumable(session))
+	{
+		SSL_SESSION_free(session);
+		return {};
+	}
+
+	return
+	{
+		session, SSL_SESSION_free
+	};
+}
+
+bool
+ircd::net::resumed(const socket &socket)
+noexcept
+{
+	return socket.ssl && SSL_session_reused(mutable_cast(socket).ssl->native_handle());
+}
+
 ircd::string_view
 ircd::net::loghead(const socket &socket)
 {
@@ -1621,6 +1659,20 @@ ircd::net::socket::total_calls_out
 	{ "desc", "The total number of write operations on all sockets"  },
 };
 
+decltype(ircd::net::socket::total_handshake_full)
+ircd::net::socket::total_handshake_full
+{
+	{ "name", "ircd.net.socket.handshake.full"                              },
+	{ "desc", "The number of outbound handshakes without session resumption" },
+};
+
+decltype(ircd::net::socket::total_handshake_resumed)
+ircd::net::socket::total_handshake_resumed
+{
+	{ "name", "ircd.net.socket.handshake.resumed"                          },
+	{ "desc", "The number of outbound handshakes resuming a prior session" },
+};
+
 //
 // socket::socket
 //
@@ -1757,6 +1809,26 @@ ircd::net::socket::handshake(const open_opts &opts,
 	if(opts.send_sni && server_name(opts))
 		openssl::server_name(*this, server_name(opts));
 
+	if(!empty(opts.alpn))
+	{
+		// Protocol list in the wire format of RFC 7301 3.1
+		size_t len(0);
+		unsigned char protos[64];
+		for(const auto &proto : opts.alpn)
+		{
+			if(unlikely(empty(proto) || len + 1 + size(proto) > sizeof(protos)))
+				continue;
+
+			protos[len++] = size(proto);
+			len += copy(mutable_buffer{reinterpret_cast<char *>(protos + len), size(proto)}, proto);
+		}
+
+		SSL_set_alpn_protos(ssl->native_handle(), protos, len);
+	}
+
+	if(opts.session)
+		SSL_set_session(ssl->native_handle(), opts.session.get());
+
 	ssl->set_verify_callback(std::move(verify_handler));
 	ssl->async_handshake(handshake_type::client, ios::handle(desc_handshake, std::move(handshake_handler)));
 }
@@ -2686,6 +2758,21 @@ noexcept try
 	if(!ec)
 		blocking(*this, false);
 
+	// Note the application protocol selected by the remote, if any.
+	if(!ec && ssl)
+	{
+		uint len(0);
+		const unsigned char *proto(nullptr);
+		SSL_get0_alpn_selected(ssl->native_handle(), &proto, &len);
+		if(proto && len)
+			strlcpy(alpn, string_view(reinterpret_cast<const char *>(proto), len));
+
+		if(SSL_session_reused(ssl->native_handle()))
+			++total_handshake_resumed;
+		else
+			++total_handshake_full;
+	}
+
 	// This is the end of the asynchronous call chain; the user is called
 	// back with or without error here.
 	call_user(callback, ec);
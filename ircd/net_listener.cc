@@ -8,6 +8,9 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+#include <RB_INC_OPENSSL_HMAC_H
+#include <RB_INC_OPENSSL_RAND_H
+
 /// Option to indicate if any listener sockets should be allowed to bind. If
 /// false then no listeners should bind. This is only effective on startup
 /// unless a conf item updated function is implemented here.
@@ -272,6 +275,58 @@ ircd::net::acceptor::ssl_cipher_blacklist
 	{ "default",  string_view{ircd::net::ssl_cipher_blacklist} },
 };
 
+/// The number of sessions each listener retains for resumption by session
+/// ID; zero disables the cache. Takes effect when the listener is loaded.
+decltype(ircd::net::acceptor::ssl_session_cache_size)
+ircd::net::acceptor::ssl_session_cache_size
+{
+	{ "name",     "ircd.net.acceptor.ssl.session.cache.size" },
+	{ "default",  16384L                                     },
+};
+
+/// The lifetime of a session (and its ticket) available for resumption.
+decltype(ircd::net::acceptor::ssl_session_timeout)
+ircd::net::acceptor::ssl_session_timeout
+{
+	{ "name",     "ircd.net.acceptor.ssl.session.timeout" },
+	{ "default",  7200L                                   },
+};
+
+/// Issue session tickets (RFC 5077) so clients resume without the server
+/// retaining any state. Takes effect when the listener is loaded.
+decltype(ircd::net::acceptor::ssl_ticket_enable)
+ircd::net::acceptor::ssl_ticket_enable
+{
+	{ "name",     "ircd.net.acceptor.ssl.ticket.enable" },
+	{ "default",  true                                  },
+};
+
+/// The interval at which a new ticket key is generated. Tickets issued under
+/// the previous key are still accepted and renewed for one more interval.
+decltype(ircd::net::acceptor::ssl_ticket_rotate)
+ircd::net::acceptor::ssl_ticket_rotate
+{
+	{ "name",     "ircd.net.acceptor.ssl.ticket.rotate" },
+	{ "default",  43200L                                },
+};
+
+decltype(ircd::net::acceptor::handshake_full)
+ircd::net::acceptor::handshake_full
+{
+	{ "name", "ircd.net.acceptor.handshake.full"                           },
+	{ "desc", "The number of inbound handshakes without session resumption" },
+};
+
+decltype(ircd::net::acceptor::handshake_resumed)
+ircd::net::acceptor::handshake_resumed
+{
+	{ "name", "ircd.net.acceptor.handshake.resumed"                       },
+	{ "desc", "The number of inbound handshakes resuming a prior session" },
+};
+
+decltype(ircd::net::acceptor::ticket_keys)
+ircd::net::acceptor::ticket_keys;
+
 //
 // acceptor::acceptor
 //
@@ -750,6 +805,11 @@ noexcept try
 	handshaking.erase(it);
 	openssl::set_app_data(*sock, nullptr);
 	check_handshake_error(ec, *sock);
+	if(resumed(*sock))
+		++handshake_resumed;
+	else
+		++handshake_full;
+
 	sock->cancel_timeout();
 	accepted(sock);
 }
@@ -858,7 +918,14 @@ ircd::net::acceptor::handle_alpn(socket &socket,
 			};
 		}
 
-	//NOTE: proto == "h2" condition goes here
+	if(http2::enable)
+		for(const auto &proto : in)
+			if(proto == "h2")
+			{
+				strlcpy(socket.alpn, proto);
+				return proto;
+			}
+
 	for(const auto &proto : in)
 		if(proto == "http/1.1")
 		{
@@ -947,6 +1014,141 @@ catch(...)
 	__builtin_unreachable();
 }
 
+static int
+ircd_net_acceptor_handle_ticket(SSL *const s,
+                                unsigned char *const name,
+                                unsigned char *const iv,
+                                EVP_CIPHER_CTX *const cipher,
+                                HMAC_CTX *const hmac,
+                                int enc)
+noexcept try
+{
+	using ircd::net::acceptor;
+
+	const EVP_CIPHER *const algorithm
+	{
+		EVP_aes_256_cbc()
+	};
+
+	if(enc)
+	{
+		const auto &key
+		{
+			acceptor::rotate_ticket_key()
+		};
+
+		if(RAND_bytes(iv, EVP_CIPHER_iv_length(algorithm)) <= 0)
+			return -1;
+
+		memcpy(name, key.name, sizeof(key.name));
+		if(!EVP_EncryptInit_ex(cipher, algorithm, nullptr, reinterpret_cast<const uint8_t *>(key.aes), iv))
+			return -1;
+
+		if(!HMAC_Init_ex(hmac, key.hmac, sizeof(key.hmac), EVP_sha256(), nullptr))
+			return -1;
+
+		return 1;
+	}
+
+	const auto *const key
+	{
+		acceptor::find_ticket_key(ircd::const_buffer
+		{
+			reinterpret_cast<const char *>(name), sizeof(acceptor::ticket_key::name)
+		})
+	};
+
+	// Unknown or expired key; the ticket is ignored for a full handshake.
+	if(!key)
+		return 0;
+
+	if(!HMAC_Init_ex(hmac, key->hmac, sizeof(key->hmac), EVP_sha256(), nullptr))
+		return -1;
+
+	if(!EVP_DecryptInit_ex(cipher, algorithm, nullptr, reinterpret_cast<const uint8_t *>(key->aes), iv))
+		return -1;
+
+	// Tickets under a prior key are accepted and reissued under the current.
+	return key == &acceptor::rotate_ticket_key()? 1 : 2;
+}
+catch(const std::exception &e)
+{
+	ircd::log::error
+	{
+		ircd::net::acceptor::log, "Session ticket callback :%s",
+		e.what(),
+	};
+
+	return -1;
+}
+
+const ircd::net::acceptor::ticket_key *
+ircd::net::acceptor::find_ticket_key(const const_buffer &name)
+{
+	rotate_ticket_key();
+	for(const auto &key : ticket_keys)
+		if(memcmp(key.name, data(name), std::min(size(name), sizeof(key.name))) == 0)
+			return &key;
+
+	return nullptr;
+}
+
+const ircd::net::acceptor::ticket_key &
+ircd::net::acceptor::rotate_ticket_key()
+{
+	const seconds rotate
+	{
+		ssl_ticket_rotate
+	};
+
+	const auto now
+	{
+		ircd::now<system_point>()
+	};
+
+	if(!ticket_keys.empty() && now - ticket_keys.front().created < rotate)
+		return ticket_keys.front();
+
+	ticket_key key;
+	key.created = now;
+	if(RAND_bytes(reinterpret_cast<uint8_t *>(key.name), sizeof(key.name)) <= 0)
+		throw error
+		{
+			"Failed to generate session ticket key name."
+		};
+
+	if(RAND_bytes(reinterpret_cast<uint8_t *>(key.aes), sizeof(key.aes)) <= 0)
+		throw error
+		{
+			"Failed to generate session ticket cipher key."
+		};
+
+	if(RAND_bytes(reinterpret_cast<uint8_t *>(key.hmac), sizeof(key.hmac)) <= 0)
+		throw error
+		{
+			"Failed to generate session ticket hmac key."
+		};
+
+	ticket_keys.emplace_front(key);
+	OPENSSL_cleanse(&key, sizeof(key));
+
+	// The previous key is retained for one more interval to decrypt tickets
+	// issued before this rotation.
+	while(ticket_keys.size() > 1 && now - ticket_keys.back().created >= rotate * 2)
+	{
+		OPENSSL_cleanse(&ticket_keys.back(), sizeof(ticket_key));
+		ticket_keys.pop_back();
+	}
+
+	log::debug
+	{
+		log, "Rotated session ticket key; %zu keys active.",
+		ticket_keys.size(),
+	};
+
+	return ticket_keys.front();
+}
+
 bool
 ircd::net::acceptor::handle_sni(socket &socket,
                                 int &client_server)
@@ -1097,6 +1299,7 @@ ircd::net::acceptor::configure(const json::object &opts)
 	configure_ciphers(opts);
 	configure_curves(opts);
 	configure_sni(opts);
+	configure_session(opts);
 	log::debug
 	{
 		log, "%s configured listener SSL",
@@ -1114,6 +1317,40 @@ ircd::net::acceptor::configure_sni(const json::object &opts)
 	SSL_CTX_set_tlsext_servername_arg(ssl.native_handle(), this);
 }
 
+void
+ircd::net::acceptor::configure_session(const json::object &opts)
+{
+	auto *const ctx
+	{
+		ssl.native_handle()
+	};
+
+	const size_t cache_size
+	{
+		ssl_session_cache_size
+	};
+
+	SSL_CTX_set_session_cache_mode(ctx, cache_size? SSL_SESS_CACHE_SERVER: SSL_SESS_CACHE_OFF);
+	SSL_CTX_sess_set_cache_size(ctx, cache_size);
+	SSL_CTX_set_timeout(ctx, seconds(ssl_session_timeout).count());
+
+	// Sessions are only resumed on the listener which established them.
+	const string_view sid_ctx
+	{
+		name.data(), std::min(name.size(), size_t(SSL_MAX_SID_CTX_LENGTH))
+	};
+
+	SSL_CTX_set_session_id_context(ctx, reinterpret_cast<const uint8_t *>(data(sid_ctx)), size(sid_ctx));
+
+	if(!ssl_ticket_enable)
+	{
+		ssl.set_options(SSL_OP_NO_TICKET);
+		return;
+	}
+
+	SSL_CTX_set_tlsext_ticket_key_cb(ctx, ircd_net_acceptor_handle_ticket);
+}
+
 void
 ircd::net::acceptor::configure_flags(const json::object &opts)
 {
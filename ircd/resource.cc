@@ -518,15 +518,19 @@ try
 			seconds(default_timeout)
 	};
 
-	const net::scope_timeout timeout
-	{
-		*client.sock, method_timeout, [this, &client]
-		(const bool &timed_out)
+	// The socket of an HTTP/2 stream is shared by the connection which has
+	// its own timing; the stream is conducted without this timer.
+	net::scope_timeout timeout;
+	if(likely(!client.h2_stream))
+		timeout = net::scope_timeout
 		{
-			if(timed_out)
-				this->handle_timeout(client);
-		}
-	};
+			*client.sock, method_timeout, [this, &client]
+			(const bool &timed_out)
+			{
+				if(timed_out)
+					this->handle_timeout(client);
+			}
+		};
 
 	// Content that hasn't yet arrived is remaining
 	const size_t content_remain
@@ -907,6 +907,15 @@ ircd::server::peer::sock_write_lowat
 	}
 };
 
+/// Offer the TLS session from a previous link when opening another link to
+/// the same peer, avoiding a full handshake when the remote accepts it.
+decltype(ircd::server::peer::session_reuse)
+ircd::server::peer::session_reuse
+{
+	{ "name",     "ircd.server.peer.session.reuse" },
+	{ "default",  true                             },
+};
+
 decltype(ircd::server::peer::ids)
 ircd::server::peer::ids;
 
@@ -1382,6 +1391,14 @@ noexcept try
 		++tag_done;
 	}
 
+	// The session is retained after the first response on each link; by then
+	// any ticket the remote sent following the handshake has been received.
+	if(!session_reuse)
+		open_opts.session = {};
+	else if(!link.tag_done && link.socket)
+		if(auto session{net::session(*link.socket)})
+			open_opts.session = std::move(session);
+
 	if(tag.request && (ircd::debugmode || RB_DEBUG_LEVEL))
 		log::logf
 		{
@@ -2222,6 +2239,61 @@ ircd::server::link::tag_commit_max_default
 	{ "default",  3L                                }
 };
 
+decltype(ircd::server::link::h2_enable)
+ircd::server::link::h2_enable
+{
+	{ "name",     "ircd.server.link.h2.enable" },
+	{ "default",  false                        },
+};
+
+decltype(ircd::server::link::h2_streams_max)
+ircd::server::link::h2_streams_max
+{
+	{ "name",     "ircd.server.link.h2.streams_max" },
+	{ "default",  64L                               },
+};
+
+decltype(ircd::server::link::h2_window_size)
+ircd::server::link::h2_window_size
+{
+	{ "name",     "ircd.server.link.h2.window_size" },
+	{ "default",  long(1_MiB)                       },
+};
+
+decltype(ircd::server::link::h2_alpn)
+ircd::server::link::h2_alpn
+{
+	"h2", "http/1.1"
+};
+
+/// HTTP/2 connection state of a link. Each committed tag is a stream; the
+/// tag's HTTP/1.1 request is sent as HEADERS and DATA frames and the frames
+/// received for the stream are presented to the tag as an HTTP/1.1 response
+/// so the tag's existing reception machinery is used unmodified.
+struct ircd::server::link::mux
+{
+	http2::settings theirs;
+	http2::hpack::decoder decoder;
+	unique_buffer<mutable_buffer> in {16_KiB + sizeof(http2::frame::header)};
+	size_t in_len {0};
+	std::string out;                   // frames pending write
+	std::string block;                 // header block in progress
+	std::set<uint32_t> chunked;        // streams without content-length
+	int64_t window {65535};            // connection send window
+	uint32_t next_id {1};
+	uint32_t continuation {0};
+	bool block_eos {false};
+	bool goaway {false};
+};
+
+namespace ircd::server
+{
+	static void h2_append(std::string &out, const http2::frame::type &, const uint8_t &flags, const uint32_t &id, const const_buffer & = {});
+	static void h2_window_update(std::string &out, const uint32_t &id, const uint32_t &inc);
+	static void h2_rst(std::string &out, const uint32_t &id, const enum http2::error::code &);
+	static bool h2_feed(link &, tag &, const_buffer);
+}
+
 decltype(ircd::server::link::ids)
 ircd::server::link::ids;
 
@@ -2356,6 +2428,37 @@ ircd::server::link::cancel_uncommitted(std::exception_ptr eptr)
 void
 ircd::server::link::cleanup_canceled()
 {
+	// Streams of canceled tags are reset individually rather than having
+	// their responses read out.
+	if(h2)
+	{
+		bool reset(false);
+		for(auto it(begin(queue)); it != end(queue); )
+		{
+			auto &tag{*it};
+			if(tag.committed() && tag.canceled())
+			{
+				h2_rst(h2->out, tag.state.stream, http2::error::CANCEL);
+				it = queue.erase(it);
+				reset = true;
+				continue;
+			}
+
+			if(!tag.committed() && !tag.request)
+			{
+				it = queue.erase(it);
+				continue;
+			}
+
+			++it;
+		}
+
+		if(reset && ready())
+			wait_writable();
+
+		return;
+	}
+
 	size_t dead(0);
 	for(auto it(begin(queue)); it != end(queue); )
 	{
@@ -2408,6 +2511,13 @@ ircd::server::link::open(const net::open_opts &open_opts)
 		std::bind(&link::handle_open, this, ph::_1)
 	};
 
+	// Offer HTTP/2 to multiplex requests on the link; the setting is read
+	// for each link so it takes effect on the next connection to a peer.
+	net::open_opts opts{open_opts};
+	opts.alpn = h2_enable?
+		vector_view<const string_view>{h2_alpn}:
+		vector_view<const string_view>{};
+
 	op_init = true;
 	op_open = true;
 	const unwind_exceptional unhandled{[this]
@@ -2416,7 +2526,7 @@ ircd::server::link::open(const net::open_opts &open_opts)
 		op_open = false;
 	}};
 
-	socket = net::open(open_opts, std::move(handler));
+	socket = net::open(opts, std::move(handler));
 	op_open = false;
 
 	if(finished())
@@ -2436,6 +2546,9 @@ ircd::server::link::handle_open(std::exception_ptr eptr)
 	op_init = false;
 	synack_ts = time<seconds>();
 
+	if(!eptr && !op_fini && socket && string_view(socket->alpn) == "h2"_sv)
+		h2_open();
+
 	if(!eptr && !op_fini)
 		wait_writable();
 
@@ -2562,6 +2675,9 @@ void
 ircd::server::link::handle_writable_success()
 {
 	assert(socket);
+	if(h2)
+		return h2_writable();
+
 	auto it(begin(queue));
 	while(it != end(queue))
 	{
@@ -2751,6 +2867,9 @@ void
 ircd::server::link::handle_readable_success()
 {
 	assert(socket);
+	if(h2)
+		return h2_readable();
+
 	if(!tag_committed())
 	{
 		discard_read();
@@ -2962,6 +3081,816 @@ ircd::server::link::discard_read()
 	};
 }
 
+//
+// link::h2
+//
+
+/// The remote selected HTTP/2 during the handshake. The connection preface
+/// and our settings are queued to precede any stream.
+void
+ircd::server::link::h2_open()
+{
+	assert(!h2);
+	h2 = std::make_unique<mux>();
+
+	const uint32_t window
+	{
+		uint32_t(std::clamp(size_t(h2_window_size), 65535UL, 0x7fffffffUL))
+	};
+
+	const struct http2::frame::settings::param params[]
+	{
+		{ http2::settings::code::ENABLE_PUSH,              0       },
+		{ http2::settings::code::INITIAL_WINDOW_SIZE,      window  },
+	};
+
+	char param[6 * 2];
+	h2->out.append(http2::connection_preface);
+	h2_append(h2->out, http2::frame::type::SETTINGS, 0, 0, http2::frame::settings::write(param, params));
+	if(window > 65535)
+		h2_window_update(h2->out, 0, window - 65535);
+
+	log::debug
+	{
+		log, "%s negotiated HTTP/2",
+		loghead(*this),
+	};
+}
+
+/// Opens streams for uncommitted tags up to the concurrency limit, sends
+/// content as flow control allows, and flushes the output. Unlike HTTP/1.1
+/// the socket is always being read so responses on any stream are received
+/// as they arrive.
+void
+ircd::server::link::h2_writable()
+{
+	assert(h2);
+	auto &mux(*h2);
+	size_t committed(tag_committed());
+	for(auto it(begin(queue)); it != end(queue); )
+	{
+		auto &tag{*it};
+		if((tag.abandoned() || tag.canceled()) && !tag.committed())
+		{
+			it = queue.erase(it);
+			continue;
+		}
+
+		if(tag.canceled())
+		{
+			h2_rst(mux.out, tag.state.stream, http2::error::CANCEL);
+			it = queue.erase(it);
+			--committed;
+			continue;
+		}
+
+		if(!tag.committed())
+		{
+			if(mux.goaway || committed >= tag_commit_max())
+				break;
+
+			if(!h2_commit(tag))
+			{
+				it = queue.erase(it);
+				continue;
+			}
+
+			++committed;
+		}
+
+		if(tag.write_remaining())
+			h2_content(tag);
+
+		++it;
+	}
+
+	if(!mux.out.empty())
+	{
+		const size_t wrote
+		{
+			write_any(*socket, const_buffer{mux.out})
+		};
+
+		assert(peer);
+		peer->write_bytes += wrote;
+		mux.out.erase(0, wrote);
+	}
+
+	if(!mux.out.empty())
+		wait_writable();
+
+	wait_readable();
+}
+
+/// The tag's HTTP/1.1 request head is translated to a HEADERS frame opening
+/// a new stream. Returns false if the request can't be expressed; the tag
+/// has its exception set.
+bool
+ircd::server::link::h2_commit(tag &tag)
+try
+{
+	assert(h2);
+	assert(tag.request);
+	assert(!tag.committed());
+	auto &mux(*h2);
+	const auto &req{*tag.request};
+
+	std::vector<http::header> headers;
+	parse::buffer pb{req.out.head};
+	parse::capstan pc{pb};
+	const http::request::head head
+	{
+		pc, [&headers](const auto &header)
+		{
+			headers.emplace_back(header);
+		}
+	};
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		size(req.out.head) + 64 + headers.size() * 8
+	};
+
+	// Lowercased names are carved from a buffer the size of the head so no
+	// name can be truncated.
+	const unique_buffer<mutable_buffer> names
+	{
+		size(req.out.head)
+	};
+
+	mutable_buffer namebuf(names);
+	mutable_buffer out(buf);
+	consume(out, http2::hpack::encode(out, {":method", head.method}));
+	consume(out, http2::hpack::encode(out, {":scheme", "https"}));
+	consume(out, http2::hpack::encode(out, {":authority", head.host}));
+	consume(out, http2::hpack::encode(out, {":path", head.uri}));
+	for(const auto &[key, val] : headers)
+	{
+		const string_view name
+		{
+			tolower(namebuf, key)
+		};
+
+		consume(namebuf, size(name));
+
+		// Connection-specific fields are not permitted (RFC 7540 8.1.2.2)
+		if(name == "host" || name == "connection" || name == "keep-alive" || name == "transfer-encoding" || name == "upgrade" || name == "te")
+			continue;
+
+		consume(out, http2::hpack::encode(out, {name, val}));
+	}
+
+	const uint32_t id(mux.next_id);
+	mux.next_id += 2;
+	tag.state.stream = id;
+	tag.state.window = mux.theirs[http2::settings::code::INITIAL_WINDOW_SIZE];
+
+	const bool eos(empty(req.out.content));
+	const size_t max_frame(mux.theirs[http2::settings::code::MAX_FRAME_SIZE]);
+	const const_buffer block
+	{
+		data(buf), size(buf) - size(out)
+	};
+
+	http2::frame::write_block(block, id, max_frame, eos, [&mux]
+	(const const_buffer &hdr, const const_buffer &fragment)
+	{
+		mux.out.append(data(hdr), size(hdr));
+		mux.out.append(data(fragment), size(fragment));
+	});
+
+	// The head is accounted as written which commits the tag.
+	tag.wrote_buffer(tag.make_write_buffer());
+	assert(tag.committed());
+
+	log::debug
+	{
+		log, "%s starting on tag:%lu stream:%u wt:%zu [%s]",
+		loghead(*this),
+		tag.state.id,
+		id,
+		tag.write_size(),
+		loghead(req),
+	};
+
+	return true;
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "%s tag:%lu cannot be sent :%s",
+		loghead(*this),
+		tag.state.id,
+		e.what(),
+	};
+
+	tag.set_exception(std::current_exception());
+	return false;
+}
+
+void
+ircd::server::link::h2_content(tag &tag)
+{
+	assert(h2);
+	auto &mux(*h2);
+	while(tag.write_remaining() && mux.window > 0 && tag.state.window > 0)
+	{
+		const const_buffer buf
+		{
+			tag.make_write_buffer()
+		};
+
+		const size_t len
+		{
+			std::min
+			({
+				size(buf),
+				size_t(mux.window),
+				size_t(tag.state.window),
+				size_t(mux.theirs[http2::settings::code::MAX_FRAME_SIZE]),
+			})
+		};
+
+		const const_buffer chunk
+		{
+			data(buf), len
+		};
+
+		mux.window -= len;
+		tag.state.window -= len;
+		tag.wrote_buffer(chunk);
+		h2_append(mux.out, http2::frame::type::DATA, tag.write_remaining()? 0 : http2::flag::END_STREAM, tag.state.stream, chunk);
+	}
+}
+
+void
+ircd::server::link::h2_readable()
+{
+	assert(h2);
+	auto &mux(*h2);
+	const auto tag_done_before(tag_done);
+	size_t got(0); do
+	{
+		const mutable_buffer buf
+		{
+			data(mux.in) + mux.in_len, size(mux.in) - mux.in_len
+		};
+
+		got = size(read(buf));
+		mux.in_len += got;
+		const_buffer in
+		{
+			data(mux.in), mux.in_len
+		};
+
+		while(size(in) >= sizeof(http2::frame::header))
+		{
+			const auto header
+			{
+				http2::frame::read(in)
+			};
+
+			// Our MAX_FRAME_SIZE is the default.
+			if(unlikely(header.len > 16384))
+				throw http2::error
+				{
+					http2::error::FRAME_SIZE_ERROR, "frame length %u exceeds maximum",
+					uint32_t(header.len),
+				};
+
+			if(size(in) < sizeof(http2::frame::header) + header.len)
+				break;
+
+			h2_frame(header, const_buffer
+			{
+				data(in) + sizeof(http2::frame::header), header.len
+			});
+
+			consume(in, sizeof(http2::frame::header) + header.len);
+		}
+
+		mux.in_len = size(in);
+		std::memmove(data(mux.in), data(in), mux.in_len);
+	}
+	while(got && !op_fini);
+
+	if(unlikely(op_fini))
+		return;
+
+	if(mux.goaway && !tag_committed())
+	{
+		close();
+		return;
+	}
+
+	if(!mux.out.empty() || tag_uncommitted() || write_remaining())
+		wait_writable();
+
+	if(queue.empty() && tag_done != tag_done_before)
+	{
+		assert(peer);
+		peer->handle_link_done(*this);
+		return;
+	}
+
+	wait_readable();
+}
+
+void
+ircd::server::link::h2_frame(const http2::frame::header &header,
+                             const_buffer payload)
+{
+	assert(h2);
+	auto &mux(*h2);
+	const uint32_t id(header.stream_id);
+	if(unlikely(mux.continuation && (header.type != http2::frame::type::CONTINUATION || id != mux.continuation)))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "expected CONTINUATION for stream %u",
+			mux.continuation,
+		};
+
+	// These are always associated with a stream (RFC 7540 6.1, 6.2, 6.10);
+	// uncommitted tags also have a zero stream so one must never be matched.
+	const bool stream_frame
+	{
+		header.type == http2::frame::type::DATA
+		|| header.type == http2::frame::type::HEADERS
+		|| header.type == http2::frame::type::CONTINUATION
+	};
+
+	if(unlikely(stream_frame && !id))
+		throw http2::error
+		{
+			http2::error::PROTOCOL_ERROR, "%s on stream 0",
+			http2::frame::reflect(header.type),
+		};
+
+	switch(header.type)
+	{
+		case http2::frame::type::DATA:
+			return h2_data(header, payload);
+
+		case http2::frame::type::HEADERS:
+		{
+			payload = http2::frame::payload(header, payload);
+			mux.block.assign(data(payload), size(payload));
+			mux.block_eos = header.flags & http2::flag::END_STREAM;
+			mux.continuation = id;
+			if(header.flags & http2::flag::END_HEADERS)
+				h2_headers(id, mux.block_eos);
+
+			return;
+		}
+
+		case http2::frame::type::CONTINUATION:
+		{
+			if(unlikely(id != mux.continuation))
+				throw http2::error
+				{
+					http2::error::PROTOCOL_ERROR, "unexpected CONTINUATION"
+				};
+
+			mux.block.append(data(payload), size(payload));
+			if(unlikely(mux.block.size() > 256_KiB))
+				throw http2::error
+				{
+					http2::error::ENHANCE_YOUR_CALM, "header block too large"
+				};
+
+			if(header.flags & http2::flag::END_HEADERS)
+				h2_headers(id, mux.block_eos);
+
+			return;
+		}
+
+		case http2::frame::type::SETTINGS:
+		{
+			const bool params
+			{
+				http2::frame::settings::read(header, payload, [this, &mux]
+				(const auto &code, const auto &value)
+				{
+					if(code == http2::settings::code::INITIAL_WINDOW_SIZE)
+					{
+						const int64_t delta(int64_t(value) - mux.theirs[code]);
+						for(auto &tag : queue)
+							if(tag.committed())
+								tag.state.window += delta;
+					}
+
+					mux.theirs[code] = value;
+				})
+			};
+
+			if(params)
+				h2_append(mux.out, http2::frame::type::SETTINGS, http2::flag::ACK, 0);
+
+			return;
+		}
+
+		case http2::frame::type::WINDOW_UPDATE:
+		{
+			if(unlikely(size(payload) != 4))
+				throw http2::error
+				{
+					http2::error::FRAME_SIZE_ERROR, "invalid WINDOW_UPDATE"
+				};
+
+			const uint32_t inc(http2::parse32(payload) & 0x7fffffffU);
+			if(!id)
+			{
+				if(unlikely(!inc || mux.window + inc > 0x7fffffffL))
+					throw http2::error
+					{
+						http2::error::FLOW_CONTROL_ERROR, "invalid WINDOW_UPDATE"
+					};
+
+				mux.window += inc;
+				return;
+			}
+
+			const auto it(std::find_if(begin(queue), end(queue), [&id](const auto &tag)
+			{
+				return tag.state.stream == id;
+			}));
+
+			if(it == end(queue))
+				return;
+
+			if(unlikely(!inc || it->state.window + inc > 0x7fffffffL))
+			{
+				h2_rst(mux.out, id, inc? http2::error::FLOW_CONTROL_ERROR: http2::error::PROTOCOL_ERROR);
+				it->set_exception<error>("Invalid HTTP/2 WINDOW_UPDATE on stream %u", id);
+				queue.erase(it);
+				return;
+			}
+
+			it->state.window += inc;
+			return;
+		}
+
+		case http2::frame::type::RST_STREAM:
+		{
+			if(unlikely(size(payload) != 4 || !id))
+				throw http2::error
+				{
+					http2::error::PROTOCOL_ERROR, "invalid RST_STREAM"
+				};
+
+			const auto it(std::find_if(begin(queue), end(queue), [&id](const auto &tag)
+			{
+				return tag.state.stream == id;
+			}));
+
+			if(it == end(queue))
+				return;
+
+			const auto code(static_cast<enum http2::error::code>(http2::parse32(payload)));
+			it->set_exception(make_exception_ptr<http2::error>(code));
+			queue.erase(it);
+			return;
+		}
+
+		case http2::frame::type::PING:
+		{
+			if(unlikely(size(payload) != 8 || id))
+				throw http2::error
+				{
+					http2::error::PROTOCOL_ERROR, "invalid PING"
+				};
+
+			if(~header.flags & http2::flag::ACK)
+				h2_append(mux.out, http2::frame::type::PING, http2::flag::ACK, 0, payload);
+
+			return;
+		}
+
+		case http2::frame::type::GOAWAY:
+		{
+			if(unlikely(size(payload) < 8 || id))
+				throw http2::error
+				{
+					http2::error::PROTOCOL_ERROR, "invalid GOAWAY"
+				};
+
+			return h2_goaway(http2::parse32(payload) & 0x7fffffffU, http2::parse32(payload + 4));
+		}
+
+		// Push was disabled in our SETTINGS.
+		case http2::frame::type::PUSH_PROMISE:
+			throw http2::error
+			{
+				http2::error::PROTOCOL_ERROR, "PUSH_PROMISE was disabled"
+			};
+
+		// Priority is advisory; unknown frame types are ignored (RFC 7540 4.1)
+		case http2::frame::type::PRIORITY:
+		default:
+			return;
+	}
+}
+
+/// A complete header block was received for the stream. The block is always
+/// decoded to maintain the decoder state even if the tag is gone. The first
+/// block is presented to the tag as an HTTP/1.1 response head; chunked
+/// framing is announced when the remote gives no content-length.
+void
+ircd::server::link::h2_headers(const uint32_t &id,
+                               const bool &eos)
+{
+	assert(h2);
+	auto &mux(*h2);
+	std::string head;
+	uint code(0);
+	bool valid(true), length(false);
+	mux.decoder(const_buffer{mux.block}, [&](const http2::hpack::header &header)
+	{
+		const auto &[name, value]
+		{
+			header
+		};
+
+		// The value may refer to the decoder's scratch which does not
+		// outlive this closure.
+		valid &= !has(value, '\r') && !has(value, '\n');
+		if(name == ":status")
+			code = lex_castable<uint>(value)?
+				lex_cast<uint>(value): 0U;
+
+		if(startswith(name, ':') || !valid)
+			return;
+
+		if(name == "connection" || name == "transfer-encoding" || name == "keep-alive")
+			return;
+
+		length |= name == "content-length";
+		head.append(name);
+		head.append(": ");
+		head.append(value);
+		head.append("\r\n");
+	});
+
+	mux.block.clear();
+	mux.continuation = 0;
+	const auto it(std::find_if(begin(queue), end(queue), [&id](const auto &tag)
+	{
+		return tag.state.stream == id;
+	}));
+
+	if(it == end(queue))
+		return;
+
+	auto &tag{*it};
+	bool done(false);
+	if(tag.state.status != http::code(0))
+	{
+		// Trailers; only the end of the stream is significant.
+		if(!eos)
+			return;
+
+		if(mux.chunked.count(id))
+			done = h2_feed(*this, tag, "0\r\n\r\n"_sv);
+	}
+	else
+	{
+		if(unlikely(!valid || code < 100 || code > 999))
+		{
+			h2_rst(mux.out, id, http2::error::PROTOCOL_ERROR);
+			tag.set_exception<error>("Invalid HTTP/2 response head on stream %u", id);
+			queue.erase(it);
+			return;
+		}
+
+		// Interim response
+		if(code < 200)
+			return;
+
+		char linebuf[64];
+		const string_view line
+		{
+			fmt::sprintf
+			{
+				linebuf, "HTTP/1.1 %u %s\r\n%s",
+				code,
+				http::status(http::code(code)),
+				!length?
+					"transfer-encoding: chunked\r\n"_sv: string_view{},
+			}
+		};
+
+		if(!length)
+			mux.chunked.emplace(id);
+
+		head.insert(0, line);
+		head.append("\r\n");
+		done = h2_feed(*this, tag, const_buffer{head});
+		if(!done && eos && !length)
+			done = h2_feed(*this, tag, "0\r\n\r\n"_sv);
+	}
+
+	if(!done && eos)
+	{
+		tag.set_exception<error>("HTTP/2 stream %u ended before the content", id);
+		queue.erase(it);
+		mux.chunked.erase(id);
+		return;
+	}
+
+	if(!done)
+		return;
+
+	mux.chunked.erase(id);
+	assert(peer);
+	peer->handle_tag_done(*this, tag);
+	queue.erase(it);
+	++tag_done;
+}
+
+void
+ircd::server::link::h2_data(const http2::frame::header &header,
+                            const_buffer payload)
+{
+	assert(h2);
+	auto &mux(*h2);
+	const uint32_t id(header.stream_id);
+	const bool eos(header.flags & http2::flag::END_STREAM);
+
+	// Content is received directly into the tags so the connection window
+	// is replenished immediately.
+	if(header.len)
+		h2_window_update(mux.out, 0, header.len);
+
+	payload = http2::frame::payload(header, payload);
+	const auto it(std::find_if(begin(queue), end(queue), [&id](const auto &tag)
+	{
+		return tag.state.stream == id;
+	}));
+
+	if(it == end(queue))
+		return;
+
+	auto &tag{*it};
+	if(unlikely(tag.state.status == http::code(0)))
+	{
+		h2_rst(mux.out, id, http2::error::PROTOCOL_ERROR);
+		tag.set_exception<error>("HTTP/2 DATA before HEADERS on stream %u", id);
+		queue.erase(it);
+		return;
+	}
+
+	const bool chunked(mux.chunked.count(id));
+	bool done(false);
+	if(!empty(payload) && chunked)
+	{
+		char lenbuf[24];
+		const string_view chunk_head
+		{
+			fmt::sprintf{lenbuf, "%zx\r\n", size(payload)}
+		};
+
+		done = h2_feed(*this, tag, chunk_head);
+		done = done || h2_feed(*this, tag, payload);
+		done = done || h2_feed(*this, tag, "\r\n"_sv);
+	}
+	else if(!empty(payload))
+		done = h2_feed(*this, tag, payload);
+
+	if(!done && eos && chunked)
+		done = h2_feed(*this, tag, "0\r\n\r\n"_sv);
+
+	if(!done && eos)
+	{
+		tag.set_exception<error>("HTTP/2 stream %u ended before the content", id);
+		queue.erase(it);
+		mux.chunked.erase(id);
+		return;
+	}
+
+	if(!done)
+	{
+		if(header.len)
+			h2_window_update(mux.out, id, header.len);
+
+		return;
+	}
+
+	// The tag may be satisfied before the remote ends the stream.
+	if(!eos)
+		h2_rst(mux.out, id, http2::error::NO_ERROR);
+
+	mux.chunked.erase(id);
+	assert(peer);
+	peer->handle_tag_done(*this, tag);
+	queue.erase(it);
+	++tag_done;
+}
+
+/// The remote is closing the connection. Streams above last_id were not
+/// processed; those tags fail and the uncommitted tags are moved to other
+/// links. The link closes once its remaining streams complete.
+void
+ircd::server::link::h2_goaway(const uint32_t &last_id,
+                              const uint32_t &code)
+{
+	assert(h2);
+	auto &mux(*h2);
+	log::dwarning
+	{
+		log, "%s GOAWAY last:%u :%s",
+		loghead(*this),
+		last_id,
+		http2::reflect(static_cast<enum http2::error::code>(code)),
+	};
+
+	mux.goaway = true;
+	exclude = true;
+	for(auto it(begin(queue)); it != end(queue); )
+	{
+		auto &tag{*it};
+		if(!tag.committed() || tag.state.stream <= last_id)
+		{
+			++it;
+			continue;
+		}
+
+		tag.set_exception<canceled>
+		(
+			"Request was refused by the remote closing the connection"
+		);
+
+		it = queue.erase(it);
+	}
+
+	assert(peer);
+	peer->disperse_uncommitted(*this);
+}
+
+/// Presents a portion of an HTTP/1.1 response to the tag through its read
+/// buffers. Returns true when the tag has completed.
+bool
+ircd::server::h2_feed(link &link,
+                      tag &tag,
+                      const_buffer buf)
+{
+	bool done(false);
+	while(!empty(buf) && !done)
+	{
+		const mutable_buffer dst
+		{
+			tag.make_read_buffer()
+		};
+
+		if(unlikely(empty(dst)))
+			throw buffer_overrun
+			{
+				"No buffer space for HTTP/2 stream content"
+			};
+
+		const const_buffer copied
+		{
+			data(dst), copy(dst, buf)
+		};
+
+		consume(buf, size(copied));
+		tag.read_buffer(copied, done, link);
+	}
+
+	return done;
+}
+
+void
+ircd::server::h2_rst(std::string &out,
+                     const uint32_t &id,
+                     const enum http2::error::code &code)
+{
+	char payload[4];
+	h2_append(out, http2::frame::type::RST_STREAM, 0, id, http2::write32(payload, code));
+}
+
+void
+ircd::server::h2_window_update(std::string &out,
+                               const uint32_t &id,
+                               const uint32_t &inc)
+{
+	char payload[4];
+	h2_append(out, http2::frame::type::WINDOW_UPDATE, 0, id, http2::write32(payload, inc));
+}
+
+void
+ircd::server::h2_append(std::string &out,
+                        const http2::frame::type &type,
+                        const uint8_t &flags,
+                        const uint32_t &id,
+                        const const_buffer &payload)
+{
+	char hdr[sizeof(http2::frame::header)];
+	http2::frame::write(hdr, size(payload), type, flags, id);
+	out.append(hdr, sizeof(hdr));
+	out.append(data(payload), size(payload));
+}
+
 size_t
 ircd::server::link::tag_uncommitted()
 const
@@ -3095,6 +4024,18 @@ size_t
 ircd::server::link::tag_commit_max()
 const
 {
+	if(h2)
+	{
+		const size_t theirs
+		{
+			h2->theirs[http2::settings::code::MAX_CONCURRENT_STREAMS]
+		};
+
+		return theirs?
+			std::min(theirs, size_t(h2_streams_max)):
+			size_t(h2_streams_max);
+	}
+
 	return tag_commit_max_default;
 }
 
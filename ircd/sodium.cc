@@ -17,6 +17,12 @@ namespace ircd::nacl
 	static void init() __attribute__((constructor));
 }
 
+namespace ircd::ed25519
+{
+	extern conf::item<size_t> verify_offload_min;
+	extern const ctx::ole::opts verify_offload_opts;
+}
+
 struct ircd::nacl::throw_on_error
 {
 	throw_on_error(const int &val);
@@ -71,6 +77,64 @@ ircd::buffer::zero(const mutable_buffer &buf)
 static_assert(ircd::ed25519::SK_SZ == crypto_sign_ed25519_SECRETKEYBYTES);
 static_assert(ircd::ed25519::PK_SZ == crypto_sign_ed25519_PUBLICKEYBYTES);
 
+decltype(ircd::ed25519::verify_offload_min)
+ircd::ed25519::verify_offload_min
+{
+	{ "name",    "ircd.ed25519.verify.offload.min" },
+	{ "default", 8L                                },
+	{ "description",
+
+	R"(
+	The smallest batch of signatures conducted on an offload thread (see:
+	ircd.ctx.ole); smaller batches are verified on the calling context. Zero
+	disables offloading.
+	)"}
+};
+
+decltype(ircd::ed25519::verify_offload_opts)
+ircd::ed25519::verify_offload_opts
+{
+	"ed25519"
+};
+
+size_t
+ircd::ed25519::verify(const vector_view<bool> &result,
+                      const vector_view<const const_buffer> &msg,
+                      const vector_view<const sig> &sig,
+                      const vector_view<const pk> &pk)
+{
+	assert(msg.size() == result.size());
+	assert(sig.size() == result.size());
+	assert(pk.size() == result.size());
+	const size_t num
+	{
+		std::min({result.size(), msg.size(), sig.size(), pk.size()})
+	};
+
+	const auto verify_all{[&result, &msg, &sig, &pk, &num]
+	{
+		for(size_t i(0); i < num; ++i)
+			result[i] = pk[i].verify(msg[i], sig[i]);
+	}};
+
+	const bool offload
+	{
+		ctx::current
+		&& size_t(verify_offload_min)
+		&& num >= size_t(verify_offload_min)
+	};
+
+	if(offload)
+		ctx::offload
+		{
+			verify_offload_opts, verify_all
+		};
+	else
+		verify_all();
+
+	return std::count(result.begin(), result.begin() + num, true);
+}
+
 ircd::ed25519::sk::sk(pk *const &pk_arg,
                       const const_buffer &seed)
 :key
@@ -0,0 +1,155 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#include <RB_INC_ZSTD_H
+
+decltype(ircd::zstd::version_api)
+ircd::zstd::version_api
+{
+	"zstd", info::versions::API,
+	#ifdef HAVE_ZSTD_H
+	ZSTD_VERSION_NUMBER,
+	{
+		ZSTD_VERSION_MAJOR,
+		ZSTD_VERSION_MINOR,
+		ZSTD_VERSION_RELEASE,
+	},
+	ZSTD_VERSION_STRING
+	#endif
+};
+
+decltype(ircd::zstd::version_abi)
+ircd::zstd::version_abi
+{
+	"zstd", info::versions::ABI,
+	#ifdef HAVE_ZSTD_H
+	long(::ZSTD_versionNumber()),
+	{0L},
+	::ZSTD_versionString()
+	#endif
+};
+
+#ifdef HAVE_ZSTD_H
+ircd::const_buffer
+ircd::zstd::decompress(const mutable_buffer &out,
+                       const const_buffer &in)
+{
+	const size_t ret
+	{
+		::ZSTD_decompress(data(out), size(out), data(in), size(in))
+	};
+
+	if(unlikely(::ZSTD_isError(ret)))
+		throw error
+		{
+			"decompress: %s", ::ZSTD_getErrorName(ret)
+		};
+
+	return const_buffer
+	{
+		data(out), ret
+	};
+}
+#else
+ircd::const_buffer
+ircd::zstd::decompress(const mutable_buffer &out,
+                       const const_buffer &in)
+{
+	throw error
+	{
+		"zstd is not available."
+	};
+}
+#endif
+
+#ifdef HAVE_ZSTD_H
+ircd::const_buffer
+ircd::zstd::compress(const mutable_buffer &out,
+                     const const_buffer &in,
+                     const int &level)
+{
+	const size_t ret
+	{
+		::ZSTD_compress(data(out), size(out), data(in), size(in), level)
+	};
+
+	if(unlikely(::ZSTD_isError(ret)))
+		throw error
+		{
+			"compress: %s", ::ZSTD_getErrorName(ret)
+		};
+
+	return const_buffer
+	{
+		data(out), ret
+	};
+}
+#else
+ircd::const_buffer
+ircd::zstd::compress(const mutable_buffer &out,
+                     const const_buffer &in,
+                     const int &level)
+{
+	throw error
+	{
+		"zstd is not available."
+	};
+}
+#endif
+
+/// Size of the original content recorded in the frame header; throws if the
+/// frame is invalid or was written without the size.
+size_t
+ircd::zstd::content_size(const const_buffer &in)
+#ifdef HAVE_ZSTD_H
+{
+	const auto ret
+	{
+		::ZSTD_getFrameContentSize(data(in), size(in))
+	};
+
+	if(unlikely(ret == ZSTD_CONTENTSIZE_ERROR || ret == ZSTD_CONTENTSIZE_UNKNOWN))
+		throw error
+		{
+			"Frame content size is unavailable."
+		};
+
+	return ret;
+}
+#else
+{
+	throw error
+	{
+		"zstd is not available."
+	};
+}
+#endif
+
+size_t
+ircd::zstd::bound(const size_t &size)
+noexcept
+{
+	#ifdef HAVE_ZSTD_H
+	return ::ZSTD_compressBound(size);
+	#else
+	return size;
+	#endif
+}
+
+bool
+ircd::zstd::available()
+noexcept
+{
+	#ifdef HAVE_ZSTD_H
+	return true;
+	#else
+	return false;
+	#endif
+}
@@ -327,6 +327,9 @@ ircd::m::dbs::_index_room(db::txn &txn,
 
 	if(opts.appendix.test(appendix::ROOM_REDACT) && json::get<"type"_>(event) == "m.room.redaction")
 		_index_room_redact(txn, event, opts);
+
+	if(opts.appendix.test(appendix::ROOM_SEARCH))
+		_index_room_search(txn, event, opts);
 }
 
 size_t
@@ -529,6 +529,30 @@ ircd::m::dbs::desc::events
 	// Mapping of all current head events for a room.
 	room_head,
 
+	// (room_id, user_id) => (notification_count, highlight_count)
+	// Unread notification counters of local users in the room.
+	room_unread,
+
+	// (term, (room_id, event_idx))
+	// Inverted index of the text content of events in rooms.
+	room_search,
+
+	// (room_id, (root)) => (latest_idx, count)
+	// Summary of the threads in a room by root and by latest reply.
+	room_threads,
+
+	// (room_id, offset) => (bytes)
+	// Binary content of files in the media repository.
+	media_block,
+
+	// (room_id, method, width, height) => (bytes)
+	// Generated thumbnails of files in the media repository.
+	media_thumbnail,
+
+	// (remote, event_idx) => ()
+	// Outbound federation queue.
+	fed_queue,
+
 	//
 	// These columns are legacy; they have been dropped from the schema.
 	//
@@ -22,6 +22,13 @@ ircd::m::dbs::desc::_event__comp
 	{ "default",  "default"                 },
 };
 
+decltype(ircd::m::dbs::desc::_event__comp__dict__size)
+ircd::m::dbs::desc::_event__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs.__event.comp.dict.size" },
+	{ "default",  0L                                  },
+};
+
 decltype(ircd::m::dbs::desc::_event__bloom__bits)
 ircd::m::dbs::desc::_event__bloom__bits
 {
@@ -80,7 +87,7 @@ ircd::m::dbs::desc::event_id__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "event_id"_>()));
 		const size_t &value{event_id__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -113,6 +120,7 @@ ircd::m::dbs::desc::event_id
 	.block_size = size_t(event_id__block__size),
 	.meta_block_size = size_t(event_id__meta_block__size),
 	.compression = string_view{event_id__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 //
@@ -166,7 +174,7 @@ ircd::m::dbs::desc::type__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "type"_>()));
 		const size_t &value{type__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -199,6 +207,7 @@ ircd::m::dbs::desc::type
 	.block_size = size_t(type__block__size),
 	.meta_block_size = size_t(type__meta_block__size),
 	.compression = string_view{type__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 //
@@ -252,7 +261,7 @@ ircd::m::dbs::desc::content__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "content"_>()));
 		const size_t &value{content__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -299,6 +308,7 @@ ircd::m::dbs::desc::content
 	.block_size = size_t(content__block__size),
 	.meta_block_size = size_t(content__meta_block__size),
 	.compression = string_view{content__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 	.compaction_pri = "Universal"s,
 	.target_file_size = { size_t(content__file__size__max), 1L, },
 	.compaction_trigger = size_t(content__compaction_trigger),
@@ -355,7 +365,7 @@ ircd::m::dbs::desc::room_id__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "room_id"_>()));
 		const size_t &value{room_id__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -387,6 +397,7 @@ ircd::m::dbs::desc::room_id
 	.block_size = size_t(room_id__block__size),
 	.meta_block_size = size_t(room_id__meta_block__size),
 	.compression = string_view{room_id__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 //
@@ -440,7 +451,7 @@ ircd::m::dbs::desc::sender__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "sender"_>()));
 		const size_t &value{sender__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -472,6 +483,7 @@ ircd::m::dbs::desc::sender
 	.block_size = size_t(sender__block__size),
 	.meta_block_size = size_t(sender__meta_block__size),
 	.compression = string_view{sender__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 //
@@ -525,7 +537,7 @@ ircd::m::dbs::desc::state_key__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "state_key"_>()));
 		const size_t &value{state_key__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -559,6 +571,7 @@ ircd::m::dbs::desc::state_key
 	.block_size = size_t(state_key__block__size),
 	.meta_block_size = size_t(state_key__meta_block__size),
 	.compression = string_view{state_key__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 //
@@ -612,7 +625,7 @@ ircd::m::dbs::desc::origin_server_ts__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "origin_server_ts"_>()));
 		const size_t &value{origin_server_ts__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -645,6 +658,7 @@ ircd::m::dbs::desc::origin_server_ts
 	.block_size = size_t(origin_server_ts__block__size),
 	.meta_block_size = size_t(origin_server_ts__meta_block__size),
 	.compression = string_view{origin_server_ts__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 //
@@ -698,7 +712,7 @@ ircd::m::dbs::desc::depth__cache_comp__size
 	{
 		auto &column(event_column.at(json::indexof<event, "depth"_>()));
 		const size_t &value{depth__cache_comp__size};
-		db::capacity(db::cache_compressed(column), value);
+		db::secondary_capacity(db::cache(column), value);
 	}
 };
 
@@ -724,6 +738,7 @@ ircd::m::dbs::desc::depth
 	.block_size = size_t(depth__block__size),
 	.meta_block_size = size_t(depth__meta_block__size),
 	.compression = string_view{depth__comp},
+	.compression_dict = size_t(_event__comp__dict__size),
 };
 
 void
@@ -18,6 +18,13 @@ ircd::m::dbs::desc::event_horizon__comp
 	{ "default",  "default"                        },
 };
 
+decltype(ircd::m::dbs::desc::event_horizon__comp__dict__size)
+ircd::m::dbs::desc::event_horizon__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._event_horizon.comp.dict.size" },
+	{ "default",  0L                                         },
+};
+
 decltype(ircd::m::dbs::desc::event_horizon__block__size)
 ircd::m::dbs::desc::event_horizon__block__size
 {
@@ -56,7 +63,7 @@ ircd::m::dbs::desc::event_horizon__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{event_horizon__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::event_horizon), value);
+		db::secondary_capacity(db::cache(dbs::event_horizon), value);
 	}
 };
 
@@ -113,6 +120,7 @@ ircd::m::dbs::desc::event_horizon
 	.block_size = size_t(event_horizon__block__size),
 	.meta_block_size = size_t(event_horizon__meta_block__size),
 	.compression = string_view{event_horizon__comp},
+	.compression_dict = size_t(event_horizon__comp__dict__size),
 	.compaction_pri = "kOldestSmallestSeqFirst"s,
 };
 
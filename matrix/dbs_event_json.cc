@@ -18,6 +18,13 @@ ircd::m::dbs::desc::event_json__comp
 	{ "default",  "default"                     },
 };
 
+decltype(ircd::m::dbs::desc::event_json__comp__dict__size)
+ircd::m::dbs::desc::event_json__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._event_json.comp.dict.size" },
+	{ "default",  long(16_KiB)                            },
+};
+
 decltype(ircd::m::dbs::desc::event_json__block__size)
 ircd::m::dbs::desc::event_json__block__size
 {
@@ -56,7 +63,7 @@ ircd::m::dbs::desc::event_json__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{event_json__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::event_json), value);
+		db::secondary_capacity(db::cache(dbs::event_json), value);
 	}
 };
 
@@ -103,6 +110,7 @@ ircd::m::dbs::desc::event_json
 	.block_size = size_t(event_json__block__size),
 	.meta_block_size = size_t(event_json__meta_block__size),
 	.compression = string_view{event_json__comp},
+	.compression_dict = size_t(event_json__comp__dict__size),
 	.compaction_pri = "Universal"s,
 	.target_file_size = { size_t(event_json__file__size__max), 1L, },
 	.compaction_trigger = size_t(event_json__compaction_trigger),
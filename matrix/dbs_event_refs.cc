@@ -39,6 +39,13 @@ ircd::m::dbs::desc::event_refs__comp
 	{ "default",  "default"                     },
 };
 
+decltype(ircd::m::dbs::desc::event_refs__comp__dict__size)
+ircd::m::dbs::desc::event_refs__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._event_refs.comp.dict.size" },
+	{ "default",  0L                                      },
+};
+
 decltype(ircd::m::dbs::desc::event_refs__block__size)
 ircd::m::dbs::desc::event_refs__block__size
 {
@@ -77,7 +84,7 @@ ircd::m::dbs::desc::event_refs__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{event_refs__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::event_refs), value);
+		db::secondary_capacity(db::cache(dbs::event_refs), value);
 	}
 };
 
@@ -147,6 +154,7 @@ ircd::m::dbs::desc::event_refs
 	.block_size = size_t(event_refs__block__size),
 	.meta_block_size = size_t(event_refs__meta_block__size),
 	.compression = string_view{event_refs__comp},
+	.compression_dict = size_t(event_refs__comp__dict__size),
 	.compaction_pri = "kOldestSmallestSeqFirst"s,
 };
 
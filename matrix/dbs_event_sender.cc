@@ -18,6 +18,13 @@ ircd::m::dbs::desc::event_sender__comp
 	{ "default",  "default"                       },
 };
 
+decltype(ircd::m::dbs::desc::event_sender__comp__dict__size)
+ircd::m::dbs::desc::event_sender__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._event_sender.comp.dict.size" },
+	{ "default",  0L                                        },
+};
+
 decltype(ircd::m::dbs::desc::event_sender__block__size)
 ircd::m::dbs::desc::event_sender__block__size
 {
@@ -56,7 +63,7 @@ ircd::m::dbs::desc::event_sender__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{event_sender__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::event_sender), value);
+		db::secondary_capacity(db::cache(dbs::event_sender), value);
 	}
 };
 
@@ -126,6 +133,7 @@ ircd::m::dbs::desc::event_sender
 	.block_size = size_t(event_sender__block__size),
 	.meta_block_size = size_t(event_sender__meta_block__size),
 	.compression = string_view{event_sender__comp},
+	.compression_dict = size_t(event_sender__comp__dict__size),
 	.compaction_pri = "kOldestSmallestSeqFirst"s,
 };
 
@@ -23,6 +23,13 @@ ircd::m::dbs::desc::event_state__comp
 	{ "default",  "default"                      },
 };
 
+decltype(ircd::m::dbs::desc::event_state__comp__dict__size)
+ircd::m::dbs::desc::event_state__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._event_state.comp.dict.size" },
+	{ "default",  0L                                       },
+};
+
 decltype(ircd::m::dbs::desc::event_state__block__size)
 ircd::m::dbs::desc::event_state__block__size
 {
@@ -61,7 +68,7 @@ ircd::m::dbs::desc::event_state__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{event_state__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::event_state), value);
+		db::secondary_capacity(db::cache(dbs::event_state), value);
 	}
 };
 
@@ -99,6 +106,7 @@ ircd::m::dbs::desc::event_state
 	.block_size = size_t(event_state__block__size),
 	.meta_block_size = size_t(event_state__meta_block__size),
 	.compression = string_view{event_state__comp},
+	.compression_dict = size_t(event_state__comp__dict__size),
 	.compaction_pri = "kOldestSmallestSeqFirst"s,
 };
 
@@ -18,6 +18,13 @@ ircd::m::dbs::desc::event_type__comp
 	{ "default",  "default"                     },
 };
 
+decltype(ircd::m::dbs::desc::event_type__comp__dict__size)
+ircd::m::dbs::desc::event_type__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._event_type.comp.dict.size" },
+	{ "default",  0L                                      },
+};
+
 decltype(ircd::m::dbs::desc::event_type__block__size)
 ircd::m::dbs::desc::event_type__block__size
 {
@@ -56,7 +63,7 @@ ircd::m::dbs::desc::event_type__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{event_type__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::event_type), value);
+		db::secondary_capacity(db::cache(dbs::event_type), value);
 	}
 };
 
@@ -102,6 +109,7 @@ ircd::m::dbs::desc::event_type
 	.block_size = size_t(event_type__block__size),
 	.meta_block_size = size_t(event_type__meta_block__size),
 	.compression = string_view{event_type__comp},
+	.compression_dict = size_t(event_type__comp__dict__size),
 	.compaction_pri = "kOldestSmallestSeqFirst"s,
 };
 
@@ -0,0 +1,197 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::fed_queue)
+ircd::m::dbs::fed_queue;
+
+decltype(ircd::m::dbs::desc::fed_queue__comp)
+ircd::m::dbs::desc::fed_queue__comp
+{
+	{ "name",     "ircd.m.dbs._fed_queue.comp" },
+	{ "default",  ""                           },
+};
+
+decltype(ircd::m::dbs::desc::fed_queue__comp__dict__size)
+ircd::m::dbs::desc::fed_queue__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._fed_queue.comp.dict.size" },
+	{ "default",  0L                                     },
+};
+
+decltype(ircd::m::dbs::desc::fed_queue__block__size)
+ircd::m::dbs::desc::fed_queue__block__size
+{
+	{ "name",     "ircd.m.dbs._fed_queue.block.size" },
+	{ "default",  long(4_KiB)                        },
+};
+
+decltype(ircd::m::dbs::desc::fed_queue__meta_block__size)
+ircd::m::dbs::desc::fed_queue__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._fed_queue.meta_block.size" },
+	{ "default",  long(4_KiB)                             },
+};
+
+decltype(ircd::m::dbs::desc::fed_queue__cache__size)
+ircd::m::dbs::desc::fed_queue__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._fed_queue.cache.size" },
+		{ "default",  long(8_MiB)                        },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{fed_queue__cache__size};
+		db::capacity(db::cache(dbs::fed_queue), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::fed_queue__cache_comp__size)
+ircd::m::dbs::desc::fed_queue__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._fed_queue.cache_comp.size" },
+		{ "default",  long(0_MiB)                             },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{fed_queue__cache_comp__size};
+		db::secondary_capacity(db::cache(dbs::fed_queue), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::fed_queue__bloom__bits)
+ircd::m::dbs::desc::fed_queue__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._fed_queue.bloom.bits" },
+	{ "default",  0L                                 },
+};
+
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::fed_queue__pfx
+{
+	"_fed_queue",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::fed_queue
+{
+	// name
+	"_fed_queue",
+
+	// explanation
+	R"(Outbound federation queue.
+
+	[remote | event_idx] => ()
+
+	Each key references a PDU which remains to be sent to the remote server.
+	The event_idx is big-endian so each remote's queue is sequenced in order
+	of evaluation. Keys are removed once a transaction carrying the PDU has
+	been accepted by the remote, so the queue survives a restart.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	fed_queue__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(fed_queue__bloom__bits),
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(fed_queue__block__size),
+
+	// meta_block size
+	size_t(fed_queue__meta_block__size),
+
+	// compression
+	string_view{fed_queue__comp},
+
+	// compression dictionary
+	size_t(fed_queue__comp__dict__size),
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestSmallestSeqFirst"s,
+};
+
+//
+// key
+//
+
+ircd::string_view
+ircd::m::dbs::fed_queue_key(const mutable_buffer &out_,
+                            const string_view &remote)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, remote));
+	return { data(out_), data(out) };
+}
+
+ircd::string_view
+ircd::m::dbs::fed_queue_key(const mutable_buffer &out_,
+                            const string_view &remote,
+                            const event::idx &event_idx)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, remote));
+	consume(out, copy(out, '\0'));
+	for(size_t i(0); i < 8; ++i)
+		consume(out, copy(out, char(uint64_t(event_idx) >> (56 - i * 8))));
+
+	return { data(out_), data(out) };
+}
+
+ircd::m::event::idx
+ircd::m::dbs::fed_queue_key(const string_view &amalgam)
+{
+	assert(size(amalgam) >= 1 + 8);
+	assert(amalgam.front() == '\0');
+
+	uint64_t ret(0);
+	for(size_t i(1); i < 1 + 8 && i < size(amalgam); ++i)
+		ret = (ret << 8) | uint8_t(amalgam[i]);
+
+	return ret;
+}
@@ -108,6 +108,12 @@ ircd::m::dbs::init::init_columns()
 	room_joined = db::domain{*events, desc::room_joined.name};
 	room_state = db::domain{*events, desc::room_state.name};
 	room_state_space = db::domain{*events, desc::room_state_space.name};
+	room_unread = db::domain{*events, desc::room_unread.name};
+	room_search = db::domain{*events, desc::room_search.name};
+	room_threads = db::domain{*events, desc::room_threads.name};
+	media_block = db::domain{*events, desc::media_block.name};
+	media_thumbnail = db::domain{*events, desc::media_thumbnail.name};
+	fed_queue = db::domain{*events, desc::fed_queue.name};
 }
 
 void
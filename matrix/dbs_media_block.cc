@@ -0,0 +1,198 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::media_block)
+ircd::m::dbs::media_block;
+
+decltype(ircd::m::dbs::desc::media_block__comp)
+ircd::m::dbs::desc::media_block__comp
+{
+	{ "name",     "ircd.m.dbs._media_block.comp" },
+	{ "default",  ""                             },
+};
+
+decltype(ircd::m::dbs::desc::media_block__comp__dict__size)
+ircd::m::dbs::desc::media_block__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._media_block.comp.dict.size" },
+	{ "default",  0L                                       },
+};
+
+decltype(ircd::m::dbs::desc::media_block__block__size)
+ircd::m::dbs::desc::media_block__block__size
+{
+	{ "name",     "ircd.m.dbs._media_block.block.size" },
+	{ "default",  long(64_KiB)                         },
+};
+
+decltype(ircd::m::dbs::desc::media_block__meta_block__size)
+ircd::m::dbs::desc::media_block__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._media_block.meta_block.size" },
+	{ "default",  long(4_KiB)                               },
+};
+
+decltype(ircd::m::dbs::desc::media_block__cache__size)
+ircd::m::dbs::desc::media_block__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._media_block.cache.size" },
+		{ "default",  long(64_MiB)                         },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{media_block__cache__size};
+		db::capacity(db::cache(dbs::media_block), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::media_block__cache_comp__size)
+ircd::m::dbs::desc::media_block__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._media_block.cache_comp.size" },
+		{ "default",  long(0_MiB)                               },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{media_block__cache_comp__size};
+		db::secondary_capacity(db::cache(dbs::media_block), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::media_block__bloom__bits)
+ircd::m::dbs::desc::media_block__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._media_block.bloom.bits" },
+	{ "default",  0L                                   },
+};
+
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::media_block__pfx
+{
+	"_media_block",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::media_block
+{
+	// name
+	"_media_block",
+
+	// explanation
+	R"(Binary content of files in the media repository.
+
+	[room_id | offset] => (bytes)
+
+	The file room_id is derived from the hash of the mxc. Each value is a
+	block of the file's raw content starting at the offset; the offset is
+	big-endian so the blocks of a file are sequenced in order. The file's
+	metadata remains as state in the file room.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	media_block__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(media_block__bloom__bits),
+
+	// expect queries hit
+	true,
+
+	// block size
+	size_t(media_block__block__size),
+
+	// meta_block size
+	size_t(media_block__meta_block__size),
+
+	// compression
+	string_view{media_block__comp},
+
+	// compression dictionary
+	size_t(media_block__comp__dict__size),
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestSmallestSeqFirst"s,
+};
+
+//
+// key
+//
+
+ircd::string_view
+ircd::m::dbs::media_block_key(const mutable_buffer &out_,
+                              const id::room &room_id)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	return { data(out_), data(out) };
+}
+
+ircd::string_view
+ircd::m::dbs::media_block_key(const mutable_buffer &out_,
+                              const id::room &room_id,
+                              const size_t &offset)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	for(size_t i(0); i < 8; ++i)
+		consume(out, copy(out, char(uint64_t(offset) >> (56 - i * 8))));
+
+	return { data(out_), data(out) };
+}
+
+size_t
+ircd::m::dbs::media_block_key(const string_view &amalgam)
+{
+	assert(size(amalgam) >= 1 + 8);
+	assert(amalgam.front() == '\0');
+
+	uint64_t ret(0);
+	for(size_t i(1); i < 1 + 8 && i < size(amalgam); ++i)
+		ret = (ret << 8) | uint8_t(amalgam[i]);
+
+	return ret;
+}
+
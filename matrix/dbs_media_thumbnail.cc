@@ -0,0 +1,189 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::media_thumbnail)
+ircd::m::dbs::media_thumbnail;
+
+decltype(ircd::m::dbs::desc::media_thumbnail__comp)
+ircd::m::dbs::desc::media_thumbnail__comp
+{
+	{ "name",     "ircd.m.dbs._media_thumbnail.comp" },
+	{ "default",  ""                                 },
+};
+
+decltype(ircd::m::dbs::desc::media_thumbnail__comp__dict__size)
+ircd::m::dbs::desc::media_thumbnail__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._media_thumbnail.comp.dict.size" },
+	{ "default",  0L                                           },
+};
+
+decltype(ircd::m::dbs::desc::media_thumbnail__block__size)
+ircd::m::dbs::desc::media_thumbnail__block__size
+{
+	{ "name",     "ircd.m.dbs._media_thumbnail.block.size" },
+	{ "default",  long(16_KiB)                             },
+};
+
+decltype(ircd::m::dbs::desc::media_thumbnail__meta_block__size)
+ircd::m::dbs::desc::media_thumbnail__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._media_thumbnail.meta_block.size" },
+	{ "default",  long(4_KiB)                                   },
+};
+
+decltype(ircd::m::dbs::desc::media_thumbnail__cache__size)
+ircd::m::dbs::desc::media_thumbnail__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._media_thumbnail.cache.size" },
+		{ "default",  long(32_MiB)                             },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{media_thumbnail__cache__size};
+		db::capacity(db::cache(dbs::media_thumbnail), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::media_thumbnail__cache_comp__size)
+ircd::m::dbs::desc::media_thumbnail__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._media_thumbnail.cache_comp.size" },
+		{ "default",  long(0_MiB)                                   },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{media_thumbnail__cache_comp__size};
+		db::secondary_capacity(db::cache(dbs::media_thumbnail), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::media_thumbnail__bloom__bits)
+ircd::m::dbs::desc::media_thumbnail__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._media_thumbnail.bloom.bits" },
+	{ "default",  10L                                      },
+};
+
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::media_thumbnail__pfx
+{
+	"_media_thumbnail",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::media_thumbnail
+{
+	// name
+	"_media_thumbnail",
+
+	// explanation
+	R"(Generated thumbnails of files in the media repository.
+
+	[room_id | method, width, height] => (bytes)
+
+	The file room_id is derived from the hash of the mxc. The method is the
+	first character of the thumbnailing method and the dimensions are those
+	requested by the client (after clamping); the value is the thumbnail
+	image in the content-type of the original file.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	media_thumbnail__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(media_thumbnail__bloom__bits),
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(media_thumbnail__block__size),
+
+	// meta_block size
+	size_t(media_thumbnail__meta_block__size),
+
+	// compression
+	string_view{media_thumbnail__comp},
+
+	// compression dictionary
+	size_t(media_thumbnail__comp__dict__size),
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestSmallestSeqFirst"s,
+};
+
+//
+// key
+//
+
+ircd::string_view
+ircd::m::dbs::media_thumbnail_key(const mutable_buffer &out_,
+                                  const id::room &room_id)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	return { data(out_), data(out) };
+}
+
+ircd::string_view
+ircd::m::dbs::media_thumbnail_key(const mutable_buffer &out_,
+                                  const id::room &room_id,
+                                  const char &method,
+                                  const pair<size_t> &dimension)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, method));
+	for(size_t i(0); i < 4; ++i)
+		consume(out, copy(out, char(uint32_t(dimension.first) >> (24 - i * 8))));
+
+	for(size_t i(0); i < 4; ++i)
+		consume(out, copy(out, char(uint32_t(dimension.second) >> (24 - i * 8))));
+
+	return { data(out_), data(out) };
+}
@@ -24,6 +24,13 @@ ircd::m::dbs::desc::room_events__comp
 	{ "default",  "default"                      },
 };
 
+decltype(ircd::m::dbs::desc::room_events__comp__dict__size)
+ircd::m::dbs::desc::room_events__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_events.comp.dict.size" },
+	{ "default",  0L                                       },
+};
+
 decltype(ircd::m::dbs::desc::room_events__block__size)
 ircd::m::dbs::desc::room_events__block__size
 {
@@ -62,7 +69,7 @@ ircd::m::dbs::desc::room_events__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{room_events__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::room_events), value);
+		db::secondary_capacity(db::cache(dbs::room_events), value);
 	}
 };
 
@@ -167,6 +174,9 @@ ircd::m::dbs::desc::room_events
 
 	// compression
 	string_view{room_events__comp},
+
+	// compression dictionary
+	size_t(room_events__comp__dict__size),
 };
 
 //
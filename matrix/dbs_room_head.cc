@@ -18,6 +18,13 @@ ircd::m::dbs::desc::room_head__comp
 	{ "default",  string_view{}                },
 };
 
+decltype(ircd::m::dbs::desc::room_head__comp__dict__size)
+ircd::m::dbs::desc::room_head__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_head.comp.dict.size" },
+	{ "default",  0L                                     },
+};
+
 decltype(ircd::m::dbs::desc::room_head__block__size)
 ircd::m::dbs::desc::room_head__block__size
 {
@@ -128,6 +135,9 @@ ircd::m::dbs::desc::room_head
 	// compression
 	string_view{room_head__comp},
 
+	// compression dictionary
+	size_t(room_head__comp__dict__size),
+
 	// compactor
 	{},
 
@@ -18,6 +18,13 @@ ircd::m::dbs::desc::room_joined__comp
 	{ "default",  "default"                      },
 };
 
+decltype(ircd::m::dbs::desc::room_joined__comp__dict__size)
+ircd::m::dbs::desc::room_joined__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_joined.comp.dict.size" },
+	{ "default",  0L                                       },
+};
+
 decltype(ircd::m::dbs::desc::room_joined__block__size)
 ircd::m::dbs::desc::room_joined__block__size
 {
@@ -56,7 +63,7 @@ ircd::m::dbs::desc::room_joined__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{room_joined__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::room_joined), value);
+		db::secondary_capacity(db::cache(dbs::room_joined), value);
 	}
 };
 
@@ -136,6 +143,9 @@ ircd::m::dbs::desc::room_joined
 	// compression
 	string_view{room_joined__comp},
 
+	// compression dictionary
+	size_t(room_joined__comp__dict__size),
+
 	// compactor
 	{},
 
@@ -0,0 +1,447 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+namespace ircd::m::dbs
+{
+	static bool room_search__cmp_lt(const string_view &, const string_view &);
+	static void _index_room_search_redact(db::txn &, const event &, const opts &);
+	static void _index_room_search_content(db::txn &, const string_view &room_id, const json::object &content, const opts &);
+
+	extern conf::item<size_t> room_search__terms__max;
+}
+
+decltype(ircd::m::dbs::room_search)
+ircd::m::dbs::room_search;
+
+decltype(ircd::m::dbs::room_search__terms__max)
+ircd::m::dbs::room_search__terms__max
+{
+	{ "name",     "ircd.m.dbs._room_search.terms.max" },
+	{ "default",  256L                                },
+};
+
+decltype(ircd::m::dbs::desc::room_search__comp)
+ircd::m::dbs::desc::room_search__comp
+{
+	{ "name",     "ircd.m.dbs._room_search.comp" },
+	{ "default",  "default"                      },
+};
+
+decltype(ircd::m::dbs::desc::room_search__comp__dict__size)
+ircd::m::dbs::desc::room_search__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_search.comp.dict.size" },
+	{ "default",  0L                                       },
+};
+
+decltype(ircd::m::dbs::desc::room_search__block__size)
+ircd::m::dbs::desc::room_search__block__size
+{
+	{ "name",     "ircd.m.dbs._room_search.block.size" },
+	{ "default",  512L                                 },
+};
+
+decltype(ircd::m::dbs::desc::room_search__meta_block__size)
+ircd::m::dbs::desc::room_search__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._room_search.meta_block.size" },
+	{ "default",  8192L                                     },
+};
+
+decltype(ircd::m::dbs::desc::room_search__cache__size)
+ircd::m::dbs::desc::room_search__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._room_search.cache.size" },
+		{ "default",  long(16_MiB)                         },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{room_search__cache__size};
+		db::capacity(db::cache(dbs::room_search), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::room_search__cache_comp__size)
+ircd::m::dbs::desc::room_search__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._room_search.cache_comp.size" },
+		{ "default",  long(0_MiB)                               },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{room_search__cache_comp__size};
+		db::secondary_capacity(db::cache(dbs::room_search), value);
+	}
+};
+
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::room_search__pfx
+{
+	"_room_search",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::comparator
+ircd::m::dbs::desc::room_search__cmp
+{
+	"_room_search",
+	room_search__cmp_lt,
+	db::cmp_string_view::equal,
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::room_search
+{
+	// name
+	"_room_search",
+
+	// explanation
+	R"(Inverted index of terms in the text content of events in a room.
+
+	[term | room_id, event_idx]
+
+	The content.body, content.name and content.topic of each event are split
+	into terms which are folded to lower case. A term forms the prefix domain
+	and its postings are sequenced by room, then by event_idx descending so
+	the most recent matches of a term in a room are found first.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	room_search__cmp,
+
+	// prefix transform
+	room_search__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	0, // no bloom filter because of possible comparator issues
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(room_search__block__size),
+
+	// meta_block size
+	size_t(room_search__meta_block__size),
+
+	// compression
+	string_view{room_search__comp},
+
+	// compression dictionary
+	size_t(room_search__comp__dict__size),
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestSmallestSeqFirst"s,
+};
+
+//
+// indexer
+//
+
+void
+ircd::m::dbs::_index_room_search(db::txn &txn,
+                                 const event &event,
+                                 const opts &opts)
+{
+	assert(opts.appendix.test(appendix::ROOM_SEARCH));
+
+	if(json::get<"type"_>(event) == "m.room.redaction")
+		return _index_room_search_redact(txn, event, opts);
+
+	_index_room_search_content(txn, at<"room_id"_>(event), json::get<"content"_>(event), opts);
+}
+
+// NOTE: QUERY
+void
+ircd::m::dbs::_index_room_search_redact(db::txn &txn,
+                                        const event &event,
+                                        const opts &opts)
+{
+	const auto &target_id
+	{
+		json::get<"redacts"_>(event)
+	};
+
+	if(!target_id || !opts.allow_queries)
+		return;
+
+	const m::event::idx target_idx
+	{
+		find_event_idx(target_id, opts)
+	};
+
+	if(!target_idx)
+		return;
+
+	auto _opts(opts);
+	_opts.op = db::op::DELETE;
+	_opts.event_idx = target_idx;
+	m::get(std::nothrow, target_idx, "content", [&txn, &event, &_opts]
+	(const string_view &content)
+	{
+		_index_room_search_content(txn, at<"room_id"_>(event), json::object{content}, _opts);
+	});
+}
+
+void
+ircd::m::dbs::_index_room_search_content(db::txn &txn,
+                                         const string_view &room_id,
+                                         const json::object &content,
+                                         const opts &opts)
+{
+	static const string_view keys[]
+	{
+		"body", "name", "topic"
+	};
+
+	// Terms are deduplicated so an event has one posting per term.
+	std::set<std::string, std::less<>> terms;
+	for(const auto &key : keys)
+	{
+		const json::string text
+		{
+			content[key]
+		};
+
+		room_search_terms(text, [&terms]
+		(const string_view &term)
+		{
+			terms.emplace(term);
+			return terms.size() < size_t(room_search__terms__max);
+		});
+	}
+
+	for(const auto &term : terms)
+	{
+		thread_local char buf[ROOM_SEARCH_KEY_MAX_SIZE];
+		const ctx::critical_assertion ca;
+		const string_view &key
+		{
+			room_search_key(buf, term, room_id, opts.event_idx)
+		};
+
+		db::txn::append
+		{
+			txn, room_search,
+			{
+				opts.op,        // db::op
+				key,            // key,
+			}
+		};
+	}
+}
+
+//
+// terms
+//
+
+/// Splits text into the terms of this index. A term is a run of ASCII
+/// alphanumerics or of any non-ASCII bytes (so UTF-8 words survive intact);
+/// ASCII is folded to lower case. Terms of a single character are skipped
+/// and long terms are truncated. The same function is used to split the
+/// text of a query.
+bool
+ircd::m::dbs::room_search_terms(const string_view &text,
+                                const room_search_closure &closure)
+{
+	static const auto is_term_char{[](const uint8_t &c) noexcept
+	{
+		return c >= 0x80
+		|| (c >= 'a' && c <= 'z')
+		|| (c >= 'A' && c <= 'Z')
+		|| (c >= '0' && c <= '9');
+	}};
+
+	char buf[ROOM_SEARCH_TERM_MAX_SIZE];
+	size_t len(0);
+	for(size_t i(0); i <= text.size(); ++i)
+	{
+		const uint8_t c
+		{
+			i < text.size()? uint8_t(text[i]): uint8_t(0)
+		};
+
+		if(i < text.size() && is_term_char(c))
+		{
+			if(len < sizeof(buf))
+				buf[len++] = (c >= 'A' && c <= 'Z')? c | 0x20: c;
+
+			continue;
+		}
+
+		if(len > 1)
+			if(!closure(string_view{buf, len}))
+				return false;
+
+		len = 0;
+	}
+
+	return true;
+}
+
+//
+// cmp
+//
+
+bool
+ircd::m::dbs::room_search__cmp_lt(const string_view &a,
+                                  const string_view &b)
+{
+	static const auto &pt
+	{
+		desc::room_search__pfx
+	};
+
+	// Extract the prefix from the keys
+	const string_view pre[2]
+	{
+		pt.get(a),
+		pt.get(b),
+	};
+
+	// Prefix size comparison has highest priority for rocksdb
+	if(size(pre[0]) < size(pre[1]))
+		return true;
+
+	// Prefix size comparison has highest priority for rocksdb
+	if(size(pre[0]) > size(pre[1]))
+		return false;
+
+	// Prefix lexical comparison sorts prefixes of the same size
+	if(pre[0] < pre[1])
+		return true;
+
+	// Prefix lexical comparison sorts prefixes of the same size
+	if(pre[0] > pre[1])
+		return false;
+
+	// After the prefix is the \0,room_id,\0,event_idx
+	const string_view post[2]
+	{
+		a.substr(size(pre[0])),
+		b.substr(size(pre[1])),
+	};
+
+	// These conditions are matched on some queries when the user only
+	// supplies a term.
+	if(empty(post[0]))
+		return true;
+
+	if(empty(post[1]))
+		return false;
+
+	const auto &[room_id_a, event_idx_a]
+	{
+		room_search_key(post[0])
+	};
+
+	const auto &[room_id_b, event_idx_b]
+	{
+		room_search_key(post[1])
+	};
+
+	if(room_id_a < room_id_b)
+		return true;
+
+	if(room_id_a > room_id_b)
+		return false;
+
+	// reverse event_idx to start from highest first like room_events
+	if(event_idx_a < event_idx_b)
+		return false;
+
+	if(event_idx_a > event_idx_b)
+		return true;
+
+	// equal is not less; so false
+	return false;
+}
+
+//
+// key
+//
+
+ircd::m::dbs::room_search_tuple
+ircd::m::dbs::room_search_key(const string_view &amalgam_)
+{
+	assert(size(amalgam_) >= 1 + 1 + 8);
+
+	assert(amalgam_.front() == '\0');
+	const string_view &amalgam
+	{
+		amalgam_.substr(1)
+	};
+
+	const auto &[room_id, trail]
+	{
+		split(amalgam, '\0')
+	};
+
+	return room_search_tuple
+	{
+		room_id,
+		likely(trail.size() >= 8)?
+			event::idx(byte_view<uint64_t>(trail.substr(0, 8))):
+			-1UL,
+	};
+}
+
+ircd::string_view
+ircd::m::dbs::room_search_key(const mutable_buffer &out_,
+                              const string_view &term,
+                              const id::room &room_id,
+                              const event::idx &event_idx)
+{
+	assert(term);
+	assert(size(out_) >= ROOM_SEARCH_KEY_MAX_SIZE);
+	mutable_buffer out{out_};
+	consume(out, copy(out, trunc(term, ROOM_SEARCH_TERM_MAX_SIZE)));
+
+	if(!room_id)
+		return { data(out_), data(out) };
+
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, byte_view<string_view>(event_idx)));
+	return { data(out_), data(out) };
+}
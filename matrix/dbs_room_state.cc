@@ -18,6 +18,13 @@ ircd::m::dbs::desc::room_state__comp
 	{ "default",  "default"                     },
 };
 
+decltype(ircd::m::dbs::desc::room_state__comp__dict__size)
+ircd::m::dbs::desc::room_state__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_state.comp.dict.size" },
+	{ "default",  0L                                      },
+};
+
 decltype(ircd::m::dbs::desc::room_state__block__size)
 ircd::m::dbs::desc::room_state__block__size
 {
@@ -56,7 +63,7 @@ ircd::m::dbs::desc::room_state__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{room_state__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::room_state), value);
+		db::secondary_capacity(db::cache(dbs::room_state), value);
 	}
 };
 
@@ -145,6 +152,9 @@ ircd::m::dbs::desc::room_state
 	// compression
 	string_view{room_state__comp},
 
+	// compression dictionary
+	size_t(room_state__comp__dict__size),
+
 	// compactor
 	{},
 
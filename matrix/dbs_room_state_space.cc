@@ -23,6 +23,13 @@ ircd::m::dbs::desc::room_state_space__comp
 	{ "default",  "default"                           },
 };
 
+decltype(ircd::m::dbs::desc::room_state_space__comp__dict__size)
+ircd::m::dbs::desc::room_state_space__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_state_space.comp.dict.size" },
+	{ "default",  0L                                            },
+};
+
 decltype(ircd::m::dbs::desc::room_state_space__block__size)
 ircd::m::dbs::desc::room_state_space__block__size
 {
@@ -61,7 +68,7 @@ ircd::m::dbs::desc::room_state_space__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{room_state_space__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::room_state_space), value);
+		db::secondary_capacity(db::cache(dbs::room_state_space), value);
 	}
 };
 
@@ -145,6 +152,9 @@ ircd::m::dbs::desc::room_state_space
 	// compression
 	string_view{room_state_space__comp},
 
+	// compression dictionary
+	size_t(room_state_space__comp__dict__size),
+
 	// compactor
 	{},
 
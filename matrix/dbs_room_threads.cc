@@ -0,0 +1,244 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::room_threads)
+ircd::m::dbs::room_threads;
+
+decltype(ircd::m::dbs::desc::room_threads__comp)
+ircd::m::dbs::desc::room_threads__comp
+{
+	{ "name",     "ircd.m.dbs._room_threads.comp" },
+	{ "default",  "default"                       },
+};
+
+decltype(ircd::m::dbs::desc::room_threads__comp__dict__size)
+ircd::m::dbs::desc::room_threads__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_threads.comp.dict.size" },
+	{ "default",  0L                                        },
+};
+
+decltype(ircd::m::dbs::desc::room_threads__block__size)
+ircd::m::dbs::desc::room_threads__block__size
+{
+	{ "name",     "ircd.m.dbs._room_threads.block.size" },
+	{ "default",  512L                                  },
+};
+
+decltype(ircd::m::dbs::desc::room_threads__meta_block__size)
+ircd::m::dbs::desc::room_threads__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._room_threads.meta_block.size" },
+	{ "default",  long(4_KiB)                                },
+};
+
+decltype(ircd::m::dbs::desc::room_threads__cache__size)
+ircd::m::dbs::desc::room_threads__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._room_threads.cache.size" },
+		{ "default",  long(8_MiB)                           },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{room_threads__cache__size};
+		db::capacity(db::cache(dbs::room_threads), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::room_threads__cache_comp__size)
+ircd::m::dbs::desc::room_threads__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._room_threads.cache_comp.size" },
+		{ "default",  long(0_MiB)                                },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{room_threads__cache_comp__size};
+		db::secondary_capacity(db::cache(dbs::room_threads), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::room_threads__bloom__bits)
+ircd::m::dbs::desc::room_threads__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._room_threads.bloom.bits" },
+	{ "default",  10L                                   },
+};
+
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::room_threads__pfx
+{
+	"_room_threads",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::room_threads
+{
+	// name
+	"_room_threads",
+
+	// explanation
+	R"(Index of the threads in a room.
+
+	[room_id | R, root] => [latest_idx, count]
+	[room_id | A, latest_idx, root]
+	[room_id | P, root, user_id]
+
+	Each thread root in the room has a summary of its most recent reply and
+	its number of replies. The roots are also sequenced by their most recent
+	reply so the threads of a room can be listed by activity. Every user who
+	has replied to a thread is recorded for that thread. The event_idx's are
+	stored big-endian and complemented so they sequence in descending order.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	room_threads__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(room_threads__bloom__bits),
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(room_threads__block__size),
+
+	// meta_block size
+	size_t(room_threads__meta_block__size),
+
+	// compression
+	string_view{room_threads__comp},
+
+	// compression dictionary
+	size_t(room_threads__comp__dict__size),
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestSmallestSeqFirst"s,
+};
+
+//
+// key
+//
+
+namespace ircd::m::dbs
+{
+	static void room_threads_idx(mutable_buffer &, const event::idx &);
+	static event::idx room_threads_idx(const string_view &);
+}
+
+ircd::string_view
+ircd::m::dbs::room_threads_root_key(const mutable_buffer &out_,
+                                    const id::room &room_id,
+                                    const event::idx &root)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, 'R'));
+	room_threads_idx(out, root);
+	return { data(out_), data(out) };
+}
+
+ircd::string_view
+ircd::m::dbs::room_threads_latest_key(const mutable_buffer &out_,
+                                      const id::room &room_id,
+                                      const event::idx &latest,
+                                      const event::idx &root)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, 'A'));
+	room_threads_idx(out, latest);
+	room_threads_idx(out, root);
+	return { data(out_), data(out) };
+}
+
+ircd::m::dbs::room_threads_tuple
+ircd::m::dbs::room_threads_latest_key(const string_view &amalgam)
+{
+	assert(size(amalgam) >= 1 + 1 + 8 + 8);
+	assert(amalgam[0] == '\0' && amalgam[1] == 'A');
+	return
+	{
+		room_threads_idx(amalgam.substr(2, 8)),
+		room_threads_idx(amalgam.substr(10, 8)),
+	};
+}
+
+ircd::string_view
+ircd::m::dbs::room_threads_user_key(const mutable_buffer &out_,
+                                    const id::room &room_id,
+                                    const event::idx &root,
+                                    const id::user &user_id)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, 'P'));
+	room_threads_idx(out, root);
+	consume(out, copy(out, user_id));
+	return { data(out_), data(out) };
+}
+
+void
+ircd::m::dbs::room_threads_idx(mutable_buffer &out,
+                               const event::idx &idx)
+{
+	const uint64_t val(~idx);
+	for(size_t i(0); i < 8; ++i)
+		consume(out, copy(out, char(val >> (56 - i * 8))));
+}
+
+ircd::m::event::idx
+ircd::m::dbs::room_threads_idx(const string_view &buf)
+{
+	uint64_t val(0);
+	for(size_t i(0); i < 8 && i < size(buf); ++i)
+		val = (val << 8) | uint8_t(buf[i]);
+
+	return ~val;
+}
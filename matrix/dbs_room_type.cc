@@ -23,6 +23,13 @@ ircd::m::dbs::desc::room_type__comp
 	{ "default",  "default"                    },
 };
 
+decltype(ircd::m::dbs::desc::room_type__comp__dict__size)
+ircd::m::dbs::desc::room_type__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_type.comp.dict.size" },
+	{ "default",  0L                                     },
+};
+
 decltype(ircd::m::dbs::desc::room_type__block__size)
 ircd::m::dbs::desc::room_type__block__size
 {
@@ -61,7 +68,7 @@ ircd::m::dbs::desc::room_type__cache_comp__size
 	[](conf::item<void> &)
 	{
 		const size_t &value{room_type__cache_comp__size};
-		db::capacity(db::cache_compressed(dbs::room_type), value);
+		db::secondary_capacity(db::cache(dbs::room_type), value);
 	}
 };
 
@@ -153,6 +160,9 @@ ircd::m::dbs::desc::room_type
 	// compression
 	string_view{room_type__comp},
 
+	// compression dictionary
+	size_t(room_type__comp__dict__size),
+
 	// compactor
 	{},
 
@@ -0,0 +1,184 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+decltype(ircd::m::dbs::room_unread)
+ircd::m::dbs::room_unread;
+
+decltype(ircd::m::dbs::desc::room_unread__comp)
+ircd::m::dbs::desc::room_unread__comp
+{
+	{ "name",     "ircd.m.dbs._room_unread.comp" },
+	{ "default",  "default"                      },
+};
+
+decltype(ircd::m::dbs::desc::room_unread__comp__dict__size)
+ircd::m::dbs::desc::room_unread__comp__dict__size
+{
+	{ "name",     "ircd.m.dbs._room_unread.comp.dict.size" },
+	{ "default",  0L                                       },
+};
+
+decltype(ircd::m::dbs::desc::room_unread__block__size)
+ircd::m::dbs::desc::room_unread__block__size
+{
+	{ "name",     "ircd.m.dbs._room_unread.block.size" },
+	{ "default",  512L                                 },
+};
+
+decltype(ircd::m::dbs::desc::room_unread__meta_block__size)
+ircd::m::dbs::desc::room_unread__meta_block__size
+{
+	{ "name",     "ircd.m.dbs._room_unread.meta_block.size" },
+	{ "default",  long(4_KiB)                               },
+};
+
+decltype(ircd::m::dbs::desc::room_unread__cache__size)
+ircd::m::dbs::desc::room_unread__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs._room_unread.cache.size" },
+		{ "default",  long(8_MiB)                          },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{room_unread__cache__size};
+		db::capacity(db::cache(dbs::room_unread), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::room_unread__cache_comp__size)
+ircd::m::dbs::desc::room_unread__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs._room_unread.cache_comp.size" },
+		{ "default",  long(0_MiB)                               },
+	},
+	[](conf::item<void> &)
+	{
+		const size_t &value{room_unread__cache_comp__size};
+		db::secondary_capacity(db::cache(dbs::room_unread), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::room_unread__bloom__bits)
+ircd::m::dbs::desc::room_unread__bloom__bits
+{
+	{ "name",     "ircd.m.dbs._room_unread.bloom.bits" },
+	{ "default",  10L                                  },
+};
+
+/// Prefix transform for the room_unread
+///
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::room_unread__pfx
+{
+	"_room_unread",
+
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, '\0').first;
+	}
+};
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::room_unread
+{
+	// name
+	"_room_unread",
+
+	// explanation
+	R"(Materialized unread notification counts of local users in a room.
+
+	[room_id | user_id] => [notification_count, highlight_count]
+
+	Incremented as push rules notify a user and recounted whenever the
+	user's read marker for the room advances; sync is then a point lookup
+	rather than a range count over the room or the user's notifications.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	room_unread__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	size_t(room_unread__bloom__bits),
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(room_unread__block__size),
+
+	// meta_block size
+	size_t(room_unread__meta_block__size),
+
+	// compression
+	string_view{room_unread__comp},
+
+	// compression dictionary
+	size_t(room_unread__comp__dict__size),
+
+	// compactor
+	{},
+
+	// compaction priority algorithm
+	"kOldestSmallestSeqFirst"s,
+};
+
+//
+// key
+//
+
+ircd::string_view
+ircd::m::dbs::room_unread_key(const mutable_buffer &out_,
+                              const id::room &room_id)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	return { data(out_), data(out) };
+}
+
+ircd::string_view
+ircd::m::dbs::room_unread_key(const mutable_buffer &out_,
+                              const id::room &room_id,
+                              const id::user &user_id)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, room_id));
+	consume(out, copy(out, '\0'));
+	consume(out, copy(out, user_id));
+	return { data(out_), data(out) };
+}
@@ -546,6 +546,115 @@ ircd::m::verify(const event &event,
 	return false;
 }
 
+/// Verify the origin's signature on many events together. Keys are only
+/// taken from the cache; a null entry, an event whose key is not cached, or
+/// any other failure has false in the result so the caller may fall back to
+/// verifying that event individually.
+size_t
+ircd::m::verify(const vector_view<bool> &result,
+                const vector_view<const event *const> &events)
+{
+	assert(result.size() >= events.size());
+	const size_t num
+	{
+		std::min(result.size(), events.size())
+	};
+
+	std::vector<std::string> preimage(num);
+	std::vector<const_buffer> msg(num);
+	std::vector<ed25519::sig> sig(num);
+	std::vector<ed25519::pk> pk(num);
+	std::vector<size_t> pos(num);
+	size_t n(0);
+	for(size_t i(0); i < num; ++i) try
+	{
+		result[i] = false;
+		if(!events[i])
+			continue;
+
+		const auto &event
+		{
+			*events[i]
+		};
+
+		const string_view &origin
+		{
+			json::get<"origin"_>(event)
+		};
+
+		const json::object &origin_sigs
+		{
+			json::get<"signatures"_>(event).get(origin)
+		};
+
+		bool found(false);
+		for(const auto &[keyid, sig_b64] : origin_sigs)
+			if((found = keys::cache::verify_key(origin, json::string(keyid), pk[n])))
+			{
+				sig[n] = ed25519::sig
+				{
+					[&sig_b64](auto&& buf)
+					{
+						b64::decode(buf, json::string(sig_b64));
+					}
+				};
+
+				break;
+			}
+
+		if(!found)
+			continue;
+
+		const m::event essential
+		{
+			m::essential(event, event::buf[3])
+		};
+
+		preimage[n] = std::string
+		{
+			stringify(event::buf[2], essential)
+		};
+
+		msg[n] = const_buffer{preimage[n]};
+		pos[n++] = i;
+	}
+	catch(const ctx::interrupted &)
+	{
+		throw;
+	}
+	catch(const std::exception &e)
+	{
+		log::derror
+		{
+			log, "Batch verify %s :%s",
+			string_view{events[i]->event_id},
+			e.what(),
+		};
+	}
+
+	const std::unique_ptr<bool[]> valid
+	{
+		new bool[n]
+	};
+
+	ed25519::verify
+	(
+		vector_view<bool>(valid.get(), n),
+		vector_view<const const_buffer>(msg.data(), n),
+		vector_view<const ed25519::sig>(sig.data(), n),
+		vector_view<const ed25519::pk>(pk.data(), n)
+	);
+
+	size_t ret(0);
+	for(size_t j(0); j < n; ++j)
+	{
+		result[pos[j]] = valid[j];
+		ret += valid[j];
+	}
+
+	return ret;
+}
+
 bool
 ircd::m::verify(const event &event,
                 const string_view &origin,
@@ -363,9 +363,90 @@ ircd::m::event::append::_relations(json::stack::object &out,
 	if(opts.bundle_all || opts.bundle_replace)
 		commit |= bundle_replace(object, event, opts);
 
+	if(opts.bundle_all || opts.bundle_thread)
+		commit |= bundle_thread(object, event, opts);
+
 	cp.committing(commit);
 }
 
+bool
+ircd::m::event::append::bundle_thread(json::stack::object &out,
+                                      const event &event,
+                                      const opts &opts)
+{
+	if(!opts.event_idx || !json::get<"room_id"_>(event))
+		return false;
+
+	const m::room room
+	{
+		json::get<"room_id"_>(event)
+	};
+
+	const m::room::threads threads
+	{
+		room
+	};
+
+	m::room::threads::summary summary;
+	if(likely(!threads.get(std::nothrow, opts.event_idx, summary)))
+		return false;
+
+	const m::event::fetch latest
+	{
+		std::nothrow, summary.latest
+	};
+
+	if(unlikely(!latest.valid))
+		return false;
+
+	if(unlikely(json::get<"room_id"_>(latest) != room.room_id))
+		return false;
+
+	// The latest reply is filtered for the user like any event in /relations.
+	if(opts.user_id && !visible(latest, opts.user_id))
+		return false;
+
+	json::stack::object object
+	{
+		out, "m.thread"
+	};
+
+	json::stack::object latest_event
+	{
+		object, "latest_event"
+	};
+
+	append
+	{
+		latest_event, latest,
+		{
+			.event_idx = summary.latest,
+			.user_id = opts.user_id,
+			.query_txnid = false,
+			.query_prev_state = false,
+		}
+	};
+
+	latest_event.~object();
+	json::stack::member
+	{
+		object, "count", json::value
+		{
+			long(summary.count)
+		}
+	};
+
+	json::stack::member
+	{
+		object, "current_user_participated", json::value
+		{
+			opts.user_id && threads.participated(opts.event_idx, opts.user_id)
+		}
+	};
+
+	return true;
+}
+
 bool
 ircd::m::event::append::bundle_replace(json::stack::object &out,
                                        const event &event,
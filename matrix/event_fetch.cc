@@ -8,6 +8,139 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+//
+// seek (vector)
+//
+
+namespace ircd::m
+{
+	static size_t _seek_json(const vector_view<const event::idx> &, const event::fetch::opts &, const seek_closure &, bool &);
+}
+
+decltype(ircd::m::event::fetch::batch_max)
+ircd::m::event::fetch::batch_max
+{
+	64UL
+};
+
+size_t
+ircd::m::seek(std::nothrow_t,
+              const vector_view<const event::idx> &event_idx,
+              const seek_closure &closure)
+{
+	return seek(std::nothrow, event_idx, event::fetch::default_opts, closure);
+}
+
+/// Fetch several events with one parallel query to the database for each
+/// batch of up to event::fetch::batch_max. The database is free to coalesce
+/// the block reads for the batch, and the per-key overhead of the query is
+/// amortized. Each m::event given to the closure is a zero-copy reference
+/// into pinned database memory, valid only for the duration of the closure.
+/// Missing events are skipped. Returns the number of events found.
+///
+/// Selections which would perform a row query (see event::fetch::opts) are
+/// fetched individually, since each of those is already parallelized over
+/// its columns.
+size_t
+ircd::m::seek(std::nothrow_t,
+              const vector_view<const event::idx> &event_idx,
+              const event::fetch::opts &opts,
+              const seek_closure &closure)
+{
+	size_t ret(0);
+	bool cont(true);
+	if(event::fetch::should_seek_json(opts))
+	{
+		for(size_t i(0); i < event_idx.size() && cont; i += event::fetch::batch_max)
+		{
+			const vector_view<const event::idx> batch
+			{
+				event_idx.data() + i, std::min(event_idx.size() - i, event::fetch::batch_max)
+			};
+
+			ret += _seek_json(batch, opts, closure, cont);
+		}
+
+		return ret;
+	}
+
+	event::fetch event
+	{
+		opts
+	};
+
+	for(size_t i(0); i < event_idx.size() && cont; ++i)
+	{
+		if(!seek(std::nothrow, event, event_idx[i]))
+			continue;
+
+		cont = closure(event_idx[i], event);
+		++ret;
+	}
+
+	return ret;
+}
+
+size_t
+ircd::m::_seek_json(const vector_view<const event::idx> &event_idx,
+                    const event::fetch::opts &opts,
+                    const seek_closure &closure,
+                    bool &cont)
+{
+	const auto &num
+	{
+		event_idx.size()
+	};
+
+	assert(num <= event::fetch::batch_max);
+	string_view key[num];
+	for(size_t i(0); i < num; ++i)
+		key[i] = event::fetch::key(event_idx.data() + i);
+
+	size_t ret(0);
+	dbs::event_json(vector_view<const string_view>(key, num), std::nothrow, opts.gopts, [&]
+	(const vector_view<const string_view> &val)
+	{
+		for(size_t i(0); i < num && cont; ++i) try
+		{
+			if(!event_idx[i] || empty(val[i]))
+				continue;
+
+			const json::object source
+			{
+				val[i]
+			};
+
+			event::id::buf event_id_buf;
+			const auto event_id
+			{
+				source.has("event_id")?
+					event::id(json::string(source.at("event_id"))):
+					m::event_id(std::nothrow, event_idx[i], event_id_buf)
+			};
+
+			const m::event event
+			{
+				source, event_id, event::keys{opts.keys}
+			};
+
+			cont = closure(event_idx[i], event);
+			++ret;
+		}
+		catch(const json::parse_error &e)
+		{
+			log::critical
+			{
+				m::log, "Fetching event:%lu JSON from local database :%s",
+				event_idx[i],
+				e.what(),
+			};
+		}
+	});
+
+	return ret;
+}
+
 //
 // seek
 //
@@ -601,6 +601,40 @@ ircd::m::keys::get(const queries &queries,
 // m::keys::cache
 //
 
+namespace ircd::m
+{
+	using keys_cache_pk_list = std::list<std::pair<std::string, ed25519::pk>>;
+
+	static void keys_cache_pk_clear(const string_view &server_name);
+
+	extern conf::item<size_t> keys_cache_pk_max;
+	extern stats::item<uint64_t> keys_cache_pk_hit;
+	extern stats::item<uint64_t> keys_cache_pk_miss;
+
+	// "server_name key_id" => decoded key; most recently used at the front.
+	static keys_cache_pk_list keys_cache_pk;
+	static std::map<string_view, keys_cache_pk_list::iterator, std::less<>> keys_cache_pk_map;
+}
+
+decltype(ircd::m::keys_cache_pk_max)
+ircd::m::keys_cache_pk_max
+{
+	{ "name",     "ircd.keys.cache.pk.max" },
+	{ "default",  4096L                    },
+};
+
+decltype(ircd::m::keys_cache_pk_hit)
+ircd::m::keys_cache_pk_hit
+{
+	{ "name", "ircd.keys.cache.pk.hit" },
+};
+
+decltype(ircd::m::keys_cache_pk_miss)
+ircd::m::keys_cache_pk_miss
+{
+	{ "name", "ircd.keys.cache.pk.miss" },
+};
+
 size_t
 ircd::m::keys::cache::set(const json::object &keys)
 {
@@ -609,6 +643,8 @@ ircd::m::keys::cache::set(const json::object &keys)
 		keys.at("server_name")
 	};
 
+	keys_cache_pk_clear(server_name);
+
 	const m::node::room node_room
 	{
 		server_name
@@ -662,6 +698,87 @@ ircd::m::keys::cache::get(const string_view &server_name,
 		false;
 }
 
+/// Decoded public key from the cache. Keys are retained in memory so
+/// repeated verifications avoid the database, JSON and base64.
+bool
+ircd::m::keys::cache::verify_key(const string_view &server_name,
+                                 const string_view &key_id,
+                                 ed25519::pk &pk)
+{
+	char buf[rfc3986::DOMAIN_BUFSIZE + 256];
+	const string_view key
+	{
+		fmt::sprintf
+		{
+			buf, "%s %s", server_name, key_id
+		}
+	};
+
+	auto it
+	{
+		keys_cache_pk_map.find(key)
+	};
+
+	if(it != end(keys_cache_pk_map))
+	{
+		++keys_cache_pk_hit;
+		keys_cache_pk.splice(begin(keys_cache_pk), keys_cache_pk, it->second);
+		pk = it->second->second;
+		return true;
+	}
+
+	++keys_cache_pk_miss;
+	bool ret{false};
+	get(server_name, key_id, [&pk, &key_id, &ret]
+	(const json::object &keys)
+	{
+		const json::object &verify_keys
+		{
+			keys["verify_keys"]
+		};
+
+		const json::object &verify_key
+		{
+			verify_keys.has(key_id)?
+				verify_keys.get(key_id):
+				json::object(keys["old_verify_keys"]).get(key_id)
+		};
+
+		const json::string &key_b64
+		{
+			verify_key["key"]
+		};
+
+		if(!key_b64)
+			return;
+
+		pk = ed25519::pk
+		{
+			[&key_b64](auto&& buf)
+			{
+				b64::decode(buf, key_b64);
+			}
+		};
+
+		ret = true;
+	});
+
+	// Another context may have inserted the same key while this one read
+	// the database.
+	if(!ret || keys_cache_pk_map.count(key))
+		return ret;
+
+	keys_cache_pk.emplace_front(std::string{key}, pk);
+	keys_cache_pk_map.emplace(keys_cache_pk.front().first, begin(keys_cache_pk));
+	while(keys_cache_pk.size() > std::max(size_t(keys_cache_pk_max), 1UL))
+	{
+		keys_cache_pk_map.erase(keys_cache_pk.back().first);
+		keys_cache_pk.pop_back();
+	}
+
+	return ret;
+}
+
 bool
 ircd::m::keys::cache::has(const string_view &server_name,
                           const string_view &key_id)
@@ -708,6 +825,28 @@ ircd::m::keys::cache::for_each(const string_view &server_name,
 	});
 }
 
+void
+ircd::m::keys_cache_pk_clear(const string_view &server_name)
+{
+	auto it
+	{
+		keys_cache_pk_map.lower_bound(server_name)
+	};
+
+	while(it != end(keys_cache_pk_map) && startswith(it->first, server_name))
+	{
+		if(it->first.size() <= server_name.size() || it->first[server_name.size()] != ' ')
+		{
+			++it;
+			continue;
+		}
+
+		const auto pit(it->second);
+		it = keys_cache_pk_map.erase(it);
+		keys_cache_pk.erase(pit);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // (internal) ed25519 support sanity test
@@ -8,12 +8,26 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+namespace ircd::m::media::file
+{
+	static size_t read_b64(const room &, const size_t &, const size_t &, const closure &);
+
+	extern conf::item<size_t> block_size;
+}
+
 decltype(ircd::m::media::log)
 ircd::m::media::log
 {
 	"m.media"
 };
 
+decltype(ircd::m::media::file::block_size)
+ircd::m::media::file::block_size
+{
+	{ "name",     "ircd.m.media.file.block.size" },
+	{ "default",  long(64_KiB)                   },
+};
+
 decltype(ircd::m::media::events_prefetch)
 ircd::m::media::events_prefetch
 {
@@ -225,28 +239,55 @@ ircd::m::media::file::write(const m::room &room,
                             const string_view &name)
 try
 {
-	static const size_t BLK_SZ
+	const size_t blk_sz
 	{
-		32_KiB
+		std::max(size_t(block_size), size_t(4_KiB))
 	};
 
-	static const size_t BLK_ENCODE_BUF_SZ
+	const db::sopts sopts
 	{
-		48_KiB
+		room.copts?
+			room.copts->wopts.sopts:
+			db::sopts{}
 	};
 
-	static const size_t BLK_ENCODE_BUF_ALIGN
+	// The content is written to the blocks directly; the transaction is
+	// committed periodically so it never holds more than a few MiB.
+	db::txn txn
 	{
-		64
+		*dbs::events
 	};
 
-	static_assert(BLK_ENCODE_BUF_SZ >= b64::encode_size(BLK_SZ));
-	const unique_mutable_buffer blk_encode_buf
+	size_t off{0}, pending{0};
+	while(off < size(content))
 	{
-		BLK_ENCODE_BUF_SZ,
-		BLK_ENCODE_BUF_ALIGN,
-	};
+		const const_buffer blk
+		{
+			content + off, std::min(size(content) - off, blk_sz)
+		};
+
+		char key_buf[dbs::MEDIA_BLOCK_KEY_MAX_SIZE];
+		db::txn::append
+		{
+			txn, dbs::media_block,
+			{
+				db::op::SET,
+				dbs::media_block_key(key_buf, room.room_id, off),
+				blk,
+			}
+		};
 
+		off += size(blk);
+		pending += size(blk);
+		if(pending < 4_MiB && off < size(content))
+			continue;
+
+		txn(sopts);
+		txn.clear();
+		pending = 0;
+	}
+
+	// The file is complete once its size is stated.
 	send(room, user_id, "ircd.file.stat.size", "", json::members
 	{
 		{ "bytes", long(size(content)) }
@@ -263,50 +304,18 @@ try
 			{ "name", name }
 		});
 
-	size_t off{0}, wrote{0};
-	while(off < size(content))
-	{
-		const size_t blk_sz
-		{
-			std::min(size(content) - off, BLK_SZ)
-		};
-
-		const const_buffer blk_raw
-		{
-			content + off, blk_sz
-		};
-
-		const string_view blk
-		{
-			b64::encode(blk_encode_buf, blk_raw)
-		};
-
-		assert(size(blk) == b64::encode_size(blk_raw));
-		const auto event_id
-		{
-			send(room, user_id, "ircd.file.block.b64", json::members
-			{
-				{ "data", blk },
-			})
-		};
-
-		off += size(blk_raw);
-		wrote += size(blk);
-	}
-
 	log::logf
 	{
 		log, log::level::DEBUG,
-		"File written %s by %s type:%s len:%zu pos:%zu wrote:%zu",
+		"File written %s by %s type:%s len:%zu pos:%zu blocks:%zu",
 		string_view{room.room_id},
 		string_view{user_id},
 		content_type,
 		size(content),
 		off,
-		wrote,
+		(off + blk_sz - 1) / blk_sz,
 	};
 
-	//assert(wrote == b64::encode_size(off));
 	assert(off == size(content));
 	return off;
 }
@@ -334,6 +343,90 @@ catch(const std::exception &e)
 size_t
 ircd::m::media::file::read(const m::room &room,
                            const closure &closure)
+{
+	return read(room, 0, -1UL, closure);
+}
+
+/// Read length bytes of the file from offset. The closure is called with
+/// consecutive slices of the file until the length is satisfied or the
+/// file ends; each slice is only valid for the duration of the call.
+size_t
+ircd::m::media::file::read(const m::room &room,
+                           const size_t &offset,
+                           const size_t &length,
+                           const closure &closure)
+{
+	const auto covers{[&offset](const auto &it)
+	{
+		const auto &blk_off(dbs::media_block_key(it->first));
+		return blk_off <= offset && blk_off + size(it->second) > offset;
+	}};
+
+	char key_buf[dbs::MEDIA_BLOCK_KEY_MAX_SIZE];
+	const size_t blk_sz
+	{
+		std::max(size_t(block_size), size_t(4_KiB))
+	};
+
+	// Every block but the last is the same size, so the block covering the
+	// offset is sought directly.
+	auto it
+	{
+		dbs::media_block.begin(dbs::media_block_key(key_buf, room.room_id, offset / blk_sz * blk_sz))
+	};
+
+	// The file was written with another block size; the first block has it.
+	if(offset && (!it || !covers(it)))
+	{
+		it = dbs::media_block.begin(dbs::media_block_key(key_buf, room.room_id, 0));
+		if(const size_t stride{it? size(it->second): 0UL}; stride && !covers(it))
+			it = dbs::media_block.begin(dbs::media_block_key(key_buf, room.room_id, offset / stride * stride));
+	}
+
+	// Files written before the block column have their content in events.
+	if(!it)
+		return db::has(dbs::media_block, dbs::media_block_key(key_buf, room.room_id, 0))?
+			0UL:
+			read_b64(room, offset, length, closure);
+
+	size_t ret(0);
+	for(; it && ret < length; ++it)
+	{
+		const auto &blk_off
+		{
+			dbs::media_block_key(it->first)
+		};
+
+		const string_view &blk
+		{
+			it->second
+		};
+
+		if(blk_off + size(blk) <= offset)
+			continue;
+
+		const size_t skip
+		{
+			offset > blk_off? offset - blk_off: 0UL
+		};
+
+		const string_view slice
+		{
+			blk.substr(skip, length - ret)
+		};
+
+		closure(slice);
+		ret += size(slice);
+	}
+
+	return ret;
+}
+
+size_t
+ircd::m::media::file::read_b64(const m::room &room,
+                               const size_t &offset,
+                               const size_t &length,
+                               const closure &closure)
 {
 	static const size_t BLK_DECODE_BUF_SZ
 	{
@@ -376,9 +469,10 @@ ircd::m::media::file::read(const m::room &room,
 	decoded_bytes(0),
 	encoding_bytes(0),
 	events_fetched(0),
-	events_prefetched(0);
+	events_prefetched(0),
+	ret(0);
 	m::event::fetch event;
-	for(; it; ++it) try
+	for(; it && ret < length; ++it) try
 	{
 		for(; epf && events_prefetched < events_fetched + events_prefetch; ++epf)
 			events_prefetched += epf.prefetch();
@@ -420,9 +514,23 @@ ircd::m::media::file::read(const m::room &room,
 
 		assert(size(blk) == b64::decode_size(blk_encoded));
 
-		closure(blk);
+		const size_t skip
+		{
+			offset > decoded_bytes? offset - decoded_bytes: 0UL
+		};
+
 		decoded_bytes += size(blk);
 		encoding_bytes += size(blk_encoded);
+		if(skip >= size(blk))
+			continue;
+
+		const const_buffer slice
+		{
+			data(blk) + skip, std::min(size(blk) - skip, length - ret)
+		};
+
+		closure(slice);
+		ret += size(slice);
 	}
 	catch(const ctx::interrupted &)
 	{
@@ -442,8 +550,7 @@ ircd::m::media::file::read(const m::room &room,
 		throw;
 	}
 
-	//assert(decoded_bytes == b64::decode_size(encoding_bytes));
-	return decoded_bytes;
+	return ret;
 }
 
 //
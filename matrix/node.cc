@@ -98,6 +98,13 @@ ircd::m::node::keys::get(const string_view &key_id,
                          const ed25519_closure &closure)
 const
 {
+	ed25519::pk pk;
+	if(m::keys::cache::verify_key(node.node_id, key_id, pk))
+	{
+		closure(pk);
+		return true;
+	}
+
 	return get(key_id, key_closure{[&closure]
 	(const json::string &keyb64)
 	{
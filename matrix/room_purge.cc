@@ -41,14 +41,16 @@ ircd::m::room::purge::purge(const m::room &room,
 	else if(opts.state)
 		state();
 
+	if(opts.media && whole())
+		media();
+
 	commit();
 }
 
 void
 ircd::m::room::purge::commit()
 {
-	assert(ret || !txn.size());
-	if(!ret)
+	if(!txn.size())
 		return;
 
 	if(opts.debuglog_txn || opts.infolog_txn)
@@ -71,6 +73,55 @@ ircd::m::room::purge::commit()
 	txn();
 }
 
+/// Raw file content stored outside of events when this is a media room,
+/// along with any thumbnails made from it.
+void
+ircd::m::room::purge::media()
+{
+	char key_buf[dbs::MEDIA_BLOCK_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::media_block_key(key_buf, room.room_id)
+	};
+
+	for(auto it(dbs::media_block.begin(key)); it; ++it)
+	{
+		char blk_key_buf[dbs::MEDIA_BLOCK_KEY_MAX_SIZE];
+		db::txn::append
+		{
+			txn, dbs::media_block,
+			{
+				db::op::DELETE,
+				dbs::media_block_key(blk_key_buf, room.room_id, dbs::media_block_key(it->first)),
+			}
+		};
+	}
+
+	// Thumbnails generated from the content are cached under the same room
+	// and would otherwise still be served.
+	char thumb_buf[dbs::MEDIA_THUMBNAIL_KEY_MAX_SIZE];
+	const string_view thumb_key
+	{
+		dbs::media_thumbnail_key(thumb_buf, room.room_id)
+	};
+
+	for(auto it(dbs::media_thumbnail.begin(thumb_key)); it; ++it)
+	{
+		char thumb_key_buf[dbs::MEDIA_THUMBNAIL_KEY_MAX_SIZE];
+		mutable_buffer out{thumb_key_buf};
+		consume(out, copy(out, room.room_id));
+		consume(out, copy(out, it->first));
+		db::txn::append
+		{
+			txn, dbs::media_thumbnail,
+			{
+				db::op::DELETE,
+				string_view{thumb_key_buf, data(out)},
+			}
+		};
+	}
+}
+
 void
 ircd::m::room::purge::state()
 {
@@ -135,6 +186,24 @@ ircd::m::room::purge::timeline()
 	}
 }
 
+/// Whether the options select every event of the room.
+bool
+ircd::m::room::purge::whole()
+const
+{
+	return true
+	&& opts.timeline
+	&& opts.state
+	&& opts.present
+	&& opts.history
+	&& !opts.filter
+	&& opts.depth.first == 0
+	&& opts.depth.second == std::numeric_limits<uint64_t>::max()
+	&& opts.idx.first == 0
+	&& opts.idx.second == std::numeric_limits<event::idx>::max()
+	;
+}
+
 bool
 ircd::m::room::purge::match(const uint64_t &depth,
                             const event::idx &event_idx)
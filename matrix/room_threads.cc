@@ -0,0 +1,345 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+namespace ircd::m
+{
+	// Serializes the read-modify-write of the thread summaries.
+	static ctx::mutex threads_mutex;
+}
+
+ircd::m::room::threads::summary
+ircd::m::room::threads::add(const event::idx &root,
+                            const event::idx &reply,
+                            const id::user &sender)
+const
+{
+	assert(root && reply);
+	const std::lock_guard lock
+	{
+		threads_mutex
+	};
+
+	// The first reply indexed for the root also counts any which were not,
+	// including this one; failing that it is simply the first.
+	summary ret;
+	if(!get(std::nothrow, root, ret))
+		if((ret = _rebuild(root)).count)
+			return ret;
+
+	const auto latest
+	{
+		std::max(ret.latest, reply)
+	};
+
+	db::txn txn
+	{
+		*dbs::events
+	};
+
+	char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+	if(ret.latest && ret.latest != latest)
+		db::txn::append
+		{
+			txn, dbs::room_threads,
+			{
+				db::op::DELETE,
+				dbs::room_threads_latest_key(buf, room.room_id, ret.latest, root),
+			}
+		};
+
+	if(ret.latest != latest)
+		db::txn::append
+		{
+			txn, dbs::room_threads,
+			{
+				db::op::SET,
+				dbs::room_threads_latest_key(buf, room.room_id, latest, root),
+			}
+		};
+
+	// The root's sender participates once the thread is started.
+	if(!ret.count)
+	{
+		char root_sender_buf[id::MAX_SIZE];
+		const string_view root_sender
+		{
+			m::get(std::nothrow, root, "sender", root_sender_buf)
+		};
+
+		if(root_sender)
+			db::txn::append
+			{
+				txn, dbs::room_threads,
+				{
+					db::op::SET,
+					dbs::room_threads_user_key(buf, room.room_id, root, id::user(root_sender)),
+				}
+			};
+	}
+
+	db::txn::append
+	{
+		txn, dbs::room_threads,
+		{
+			db::op::SET,
+			dbs::room_threads_user_key(buf, room.room_id, root, sender),
+		}
+	};
+
+	ret.latest = latest;
+	ret.count += 1;
+	db::txn::append
+	{
+		txn, dbs::room_threads,
+		{
+			db::op::SET,
+			dbs::room_threads_root_key(buf, room.room_id, root),
+			const_buffer
+			{
+				reinterpret_cast<const char *>(&ret), sizeof(ret)
+			},
+		}
+	};
+
+	txn();
+	return ret;
+}
+
+size_t
+ircd::m::room::threads::rebuild()
+const
+{
+	size_t ret(0);
+	for(m::room::events it{room}; it; --it)
+	{
+		const m::relates relates
+		{
+			.refs = it.event_idx(),
+		};
+
+		if(!relates.has("m.thread"))
+			continue;
+
+		rebuild(it.event_idx());
+		++ret;
+	}
+
+	return ret;
+}
+
+ircd::m::room::threads::summary
+ircd::m::room::threads::rebuild(const event::idx &root)
+const
+{
+	const std::lock_guard lock
+	{
+		threads_mutex
+	};
+
+	return _rebuild(root);
+}
+
+ircd::m::room::threads::summary
+ircd::m::room::threads::_rebuild(const event::idx &root)
+const
+{
+	assert(threads_mutex.locked());
+	const m::relates relates
+	{
+		.refs = root,
+		.prefetch_sender = true,
+	};
+
+	db::txn txn
+	{
+		*dbs::events
+	};
+
+	const auto participant{[this, &txn, &root]
+	(const event::idx &event_idx)
+	{
+		char sender_buf[id::MAX_SIZE];
+		const string_view sender
+		{
+			m::get(std::nothrow, event_idx, "sender", sender_buf)
+		};
+
+		if(!sender)
+			return;
+
+		char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+		db::txn::append
+		{
+			txn, dbs::room_threads,
+			{
+				db::op::SET,
+				dbs::room_threads_user_key(buf, room.room_id, root, id::user(sender)),
+			}
+		};
+	}};
+
+	summary ret;
+	relates.for_each("m.thread", [this, &ret, &participant]
+	(const event::idx &reply, const json::object &, const m::relates_to &)
+	{
+		const bool same_room
+		{
+			m::query(std::nothrow, reply, "room_id", [this]
+			(const string_view &room_id)
+			{
+				return room_id == room.room_id;
+			})
+		};
+
+		if(!same_room)
+			return true;
+
+		ret.latest = std::max(ret.latest, reply);
+		ret.count += 1;
+		participant(reply);
+		return true;
+	});
+
+	if(!ret.count)
+		return ret;
+
+	participant(root);
+
+	summary prior;
+	char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+	if(get(std::nothrow, root, prior) && prior.latest && prior.latest != ret.latest)
+		db::txn::append
+		{
+			txn, dbs::room_threads,
+			{
+				db::op::DELETE,
+				dbs::room_threads_latest_key(buf, room.room_id, prior.latest, root),
+			}
+		};
+
+	db::txn::append
+	{
+		txn, dbs::room_threads,
+		{
+			db::op::SET,
+			dbs::room_threads_latest_key(buf, room.room_id, ret.latest, root),
+		}
+	};
+
+	db::txn::append
+	{
+		txn, dbs::room_threads,
+		{
+			db::op::SET,
+			dbs::room_threads_root_key(buf, room.room_id, root),
+			const_buffer
+			{
+				reinterpret_cast<const char *>(&ret), sizeof(ret)
+			},
+		}
+	};
+
+	txn();
+	return ret;
+}
+
+bool
+ircd::m::room::threads::has(const event::idx &root)
+const
+{
+	char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_threads_root_key(buf, room.room_id, root)
+	};
+
+	return db::has(dbs::room_threads, key);
+}
+
+bool
+ircd::m::room::threads::participated(const event::idx &root,
+                                     const id::user &user_id)
+const
+{
+	char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_threads_user_key(buf, room.room_id, root, user_id)
+	};
+
+	return db::has(dbs::room_threads, key);
+}
+
+bool
+ircd::m::room::threads::get(std::nothrow_t,
+                            const event::idx &root,
+                            summary &ret)
+const
+{
+	char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_threads_root_key(buf, room.room_id, root)
+	};
+
+	return dbs::room_threads(key, std::nothrow, [&ret]
+	(const string_view &val)
+	{
+		if(likely(size(val) >= sizeof(ret)))
+			memcpy(&ret, data(val), sizeof(ret));
+	});
+}
+
+bool
+ircd::m::room::threads::for_each(const closure &closure)
+const
+{
+	return for_each(-1UL, closure);
+}
+
+bool
+ircd::m::room::threads::for_each(const event::idx &latest,
+                                 const closure &closure)
+const
+{
+	char buf[dbs::ROOM_THREADS_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_threads_latest_key(buf, room.room_id, latest)
+	};
+
+	for(auto it(dbs::room_threads.begin(key)); it; ++it)
+	{
+		const string_view &post
+		{
+			it->first
+		};
+
+		if(size(post) < 2 + 8 + 8 || post[1] != 'A')
+			break;
+
+		const auto &[_latest, root]
+		{
+			dbs::room_threads_latest_key(post)
+		};
+
+		if(_latest >= latest)
+			continue;
+
+		summary summary;
+		if(!get(std::nothrow, root, summary))
+			continue;
+
+		if(!closure(root, summary))
+			return false;
+	}
+
+	return true;
+}
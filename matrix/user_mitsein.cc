@@ -8,11 +8,260 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+namespace ircd::m
+{
+	struct mitsein_node;
+
+	static std::shared_ptr<mitsein_node> mitsein_get(const user::id &);
+	static void mitsein_handle_member(const event &, vm::eval &);
+
+	extern conf::item<size_t> mitsein_cache_max;
+	extern hookfn<vm::eval &> mitsein_hook;
+}
+
+/// The users in common joined rooms with a local user, each counted by the
+/// number of rooms shared. Nodes are built on demand by walking the user's
+/// rooms once; thereafter they are maintained incrementally from each
+/// m.room.member event which changes a joined membership.
+struct ircd::m::mitsein_node
+{
+	std::map<std::string, uint32_t, std::less<>> others;
+	uint64_t changes {0};
+	bool valid {false};
+};
+
+namespace ircd::m
+{
+	// local user_id => co-members
+	static std::map<std::string, std::shared_ptr<mitsein_node>, std::less<>> mitsein_cache;
+}
+
+decltype(ircd::m::mitsein_cache_max)
+ircd::m::mitsein_cache_max
+{
+	{ "name",     "ircd.m.user.mitsein.cache.max" },
+	{ "default",  4096L                           },
+};
+
+decltype(ircd::m::mitsein_hook)
+ircd::m::mitsein_hook
+{
+	mitsein_handle_member,
+	{
+		{ "_site",  "vm.effect"      },
+		{ "type",   "m.room.member"  },
+	}
+};
+
+void
+ircd::m::mitsein_handle_member(const event &event,
+                               vm::eval &eval)
+try
+{
+	if(mitsein_cache.empty())
+		return;
+
+	const auto &event_idx
+	{
+		eval.sequence
+	};
+
+	if(!event_idx || !room::state::present(event_idx))
+		return;
+
+	const m::user::id &user_id
+	{
+		at<"state_key"_>(event)
+	};
+
+	const bool joined
+	{
+		m::membership(event) == "join"
+	};
+
+	const auto prev_idx
+	{
+		room::state::prev(event_idx)
+	};
+
+	const bool was_joined
+	{
+		prev_idx && m::membership(prev_idx, "join")
+	};
+
+	if(joined == was_joined)
+		return;
+
+	const int delta
+	{
+		joined? 1 : -1
+	};
+
+	const auto apply{[&delta](mitsein_node &node, const string_view &other)
+	{
+		++node.changes;
+		if(!node.valid)
+			return;
+
+		auto it(node.others.lower_bound(other));
+		if(it == end(node.others) || it->first != other)
+		{
+			if(delta > 0)
+				node.others.emplace_hint(it, std::string{other}, 1U);
+
+			return;
+		}
+
+		if(it->second <= 1U && delta < 0)
+			node.others.erase(it);
+		else
+			it->second += delta;
+	}};
+
+	const m::room room
+	{
+		at<"room_id"_>(event)
+	};
+
+	const m::room::members members
+	{
+		room
+	};
+
+	// The joined members now include the user when joining and exclude them
+	// when leaving; they are visited explicitly in the latter case.
+	const auto target_user{[&](const auto &target)
+	{
+		const auto it(mitsein_cache.find(target));
+		if(it != end(mitsein_cache))
+			apply(*it->second, user_id);
+
+		return true;
+	}};
+
+	if(my(user_id) && !joined)
+		target_user(user_id);
+
+	members.for_each("join", my_host(), target_user);
+
+	// The user's own node is adjusted by every member of the room.
+	const auto it(mitsein_cache.find(user_id));
+	if(it == end(mitsein_cache))
+		return;
+
+	const auto node(it->second);
+	members.for_each("join", [&node, &apply, &user_id]
+	(const id::user &member)
+	{
+		if(member != user_id)
+			apply(*node, member);
+
+		return true;
+	});
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	// The graph is now suspect; it is rebuilt on demand.
+	mitsein_cache.clear();
+	log::error
+	{
+		log, "Common rooms update for %s :%s",
+		string_view{event.event_id},
+		e.what(),
+	};
+}
+
+std::shared_ptr<ircd::m::mitsein_node>
+ircd::m::mitsein_get(const user::id &user_id)
+{
+	const auto it(mitsein_cache.find(user_id));
+	if(it != end(mitsein_cache) && it->second->valid)
+		return it->second;
+
+	if(it != end(mitsein_cache))
+		return {};
+
+	if(mitsein_cache.size() >= size_t(mitsein_cache_max))
+		mitsein_cache.clear();
+
+	const auto node
+	{
+		mitsein_cache.emplace(std::string{user_id}, std::make_shared<mitsein_node>()).first->second
+	};
+
+	const m::user::rooms rooms
+	{
+		user_id
+	};
+
+	rooms.for_each("join", user::rooms::closure_bool{[&node]
+	(const m::room &room, const string_view &)
+	{
+		const m::room::members members
+		{
+			room
+		};
+
+		members.for_each("join", [&node]
+		(const user::id &other)
+		{
+			auto it(node->others.lower_bound(other));
+			if(it == end(node->others) || it->first != other)
+				node->others.emplace_hint(it, std::string{other}, 1U);
+			else
+				++it->second;
+
+			return true;
+		});
+
+		return true;
+	}});
+
+	// A membership changed while the rooms were being walked; the result
+	// can't be trusted so the node is dropped and the caller walks.
+	const auto jt(mitsein_cache.find(user_id));
+	const bool ours
+	{
+		jt != end(mitsein_cache) && jt->second == node
+	};
+
+	if(node->changes)
+	{
+		if(ours)
+			mitsein_cache.erase(jt);
+
+		return {};
+	}
+
+	node->valid = true;
+	return node;
+}
+
+//
+// user::mitsein
+//
+
 bool
 ircd::m::user::mitsein::has(const m::user &other,
                             const string_view &membership)
 const
 {
+	// Either side which is local can answer from the common rooms graph.
+	if(membership == "join")
+	{
+		if(my(user))
+			if(const auto node{mitsein_get(user)})
+				return node->others.count(other.user_id);
+
+		if(my(other))
+			if(const auto node{mitsein_get(other)})
+				return node->others.count(user.user_id);
+	}
+
 	// Return true if broken out of loop.
 	return !for_each(other, membership, []
 	(const m::room &, const string_view &) noexcept
@@ -26,6 +275,10 @@ size_t
 ircd::m::user::mitsein::count(const string_view &membership)
 const
 {
+	if(membership == "join" && my(user))
+		if(const auto node{mitsein_get(user)})
+			return node->others.size();
+
 	size_t ret{0};
 	for_each(membership, [&ret]
 	(const m::user &) noexcept
@@ -65,6 +318,22 @@ ircd::m::user::mitsein::for_each(const string_view &membership,
                                  const closure_bool &closure)
 const
 {
+	if(membership == "join" && my(user))
+		if(const auto node{mitsein_get(user)})
+		{
+			// The graph may change while the closure yields so the position
+			// is carried by key rather than by iterator.
+			std::string last;
+			for(auto it(begin(node->others)); it != end(node->others); it = node->others.upper_bound(last))
+			{
+				last = it->first;
+				if(!closure(m::user{m::user::id{last}}))
+					return false;
+			}
+
+			return true;
+		}
+
 	const m::user::rooms rooms
 	{
 		user
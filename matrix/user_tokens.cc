@@ -8,6 +8,282 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+namespace ircd::m
+{
+	struct tokens_cache_entry;
+
+	static const tokens_cache_entry *tokens_cache_fetch(const string_view &token);
+	static void tokens_cache_set(const string_view &token, const string_view &user_id, const string_view &device_id);
+	static void tokens_cache_del(const string_view &token);
+	static void tokens_cache_handle_token(const event &, vm::eval &);
+	static void tokens_cache_handle_redact(const event &, vm::eval &);
+
+	extern conf::item<size_t> tokens_cache_max;
+	extern conf::item<seconds> tokens_cache_ttl;
+	extern stats::item<uint64_t> tokens_cache_hit;
+	extern stats::item<uint64_t> tokens_cache_miss;
+	extern hookfn<vm::eval &> tokens_cache_token_hook;
+	extern hookfn<vm::eval &> tokens_cache_redact_hook;
+}
+
+/// Resolution of an access_token. Entries are added when the token is issued
+/// or first proffered and removed when the token is redacted (logout and
+/// deactivation); the ttl bounds the life of an entry regardless.
+struct ircd::m::tokens_cache_entry
+{
+	std::string user_id;
+	std::string device_id;
+	steady_point expires;
+};
+
+namespace ircd::m
+{
+	// access_token => resolution
+	static std::map<std::string, tokens_cache_entry, std::less<>> tokens_cache;
+
+	// Incremented by every invalidation; a lookup which raced with one is
+	// not cached.
+	static uint64_t tokens_cache_gen;
+}
+
+decltype(ircd::m::tokens_cache_max)
+ircd::m::tokens_cache_max
+{
+	{ "name",     "ircd.m.user.tokens.cache.max" },
+	{ "default",  16384L                         },
+};
+
+decltype(ircd::m::tokens_cache_ttl)
+ircd::m::tokens_cache_ttl
+{
+	{ "name",     "ircd.m.user.tokens.cache.ttl" },
+	{ "default",  900L                           },
+};
+
+decltype(ircd::m::tokens_cache_hit)
+ircd::m::tokens_cache_hit
+{
+	{ "name", "ircd.m.user.tokens.cache.hit" },
+};
+
+decltype(ircd::m::tokens_cache_miss)
+ircd::m::tokens_cache_miss
+{
+	{ "name", "ircd.m.user.tokens.cache.miss" },
+};
+
+decltype(ircd::m::tokens_cache_token_hook)
+ircd::m::tokens_cache_token_hook
+{
+	tokens_cache_handle_token,
+	{
+		{ "_site",  "vm.effect"          },
+		{ "type",   "ircd.access_token"  },
+	}
+};
+
+decltype(ircd::m::tokens_cache_redact_hook)
+ircd::m::tokens_cache_redact_hook
+{
+	tokens_cache_handle_redact,
+	{
+		{ "_site",  "vm.effect"         },
+		{ "type",   "m.room.redaction"  },
+	}
+};
+
+void
+ircd::m::tokens_cache_handle_token(const event &event,
+                                   vm::eval &eval)
+{
+	const m::room::id::buf tokens_room_id
+	{
+		"tokens", origin(my())
+	};
+
+	if(json::get<"room_id"_>(event) != tokens_room_id)
+		return;
+
+	const json::string &device_id
+	{
+		json::get<"content"_>(event).get("device_id")
+	};
+
+	tokens_cache_set(at<"state_key"_>(event), at<"sender"_>(event), device_id);
+}
+
+void
+ircd::m::tokens_cache_handle_redact(const event &event,
+                                    vm::eval &eval)
+{
+	if(tokens_cache.empty())
+		return;
+
+	const m::room::id::buf tokens_room_id
+	{
+		"tokens", origin(my())
+	};
+
+	if(json::get<"room_id"_>(event) != tokens_room_id)
+		return;
+
+	const auto &redacts
+	{
+		json::get<"redacts"_>(event)
+	};
+
+	const auto target_idx
+	{
+		valid(m::id::EVENT, redacts)?
+			index(std::nothrow, event::id{redacts}):
+			0UL
+	};
+
+	// Without the target the token is unknown; everything has to go.
+	if(unlikely(!target_idx))
+	{
+		++tokens_cache_gen;
+		tokens_cache.clear();
+		return;
+	}
+
+	m::get(std::nothrow, target_idx, "state_key", []
+	(const string_view &token)
+	{
+		tokens_cache_del(token);
+	});
+}
+
+const ircd::m::tokens_cache_entry *
+ircd::m::tokens_cache_fetch(const string_view &token)
+{
+	auto it
+	{
+		tokens_cache.find(token)
+	};
+
+	if(it != end(tokens_cache) && it->second.expires < now<steady_point>())
+	{
+		tokens_cache.erase(it);
+		it = end(tokens_cache);
+	}
+
+	if(it != end(tokens_cache))
+	{
+		++tokens_cache_hit;
+		return &it->second;
+	}
+
+	++tokens_cache_miss;
+	const auto gen
+	{
+		tokens_cache_gen
+	};
+
+	const m::room::id::buf tokens_room_id
+	{
+		"tokens", origin(my())
+	};
+
+	const m::room tokens
+	{
+		tokens_room_id
+	};
+
+	const auto event_idx
+	{
+		tokens.get(std::nothrow, "ircd.access_token", token)
+	};
+
+	if(!event_idx)
+		return nullptr;
+
+	user::id::buf user_id;
+	m::get(std::nothrow, event_idx, "sender", [&user_id]
+	(const string_view &sender)
+	{
+		user_id = sender;
+	});
+
+	if(!user_id)
+		return nullptr;
+
+	device::id::buf device_id;
+	m::get(std::nothrow, event_idx, "content", [&device_id]
+	(const json::object &content)
+	{
+		const json::string &_device_id
+		{
+			content["device_id"]
+		};
+
+		if(_device_id)
+			device_id = _device_id;
+	});
+
+	// The token was invalidated while this context was reading it.
+	if(gen != tokens_cache_gen)
+		return nullptr;
+
+	tokens_cache_set(token, user_id, device_id);
+	it = tokens_cache.find(token);
+	return it != end(tokens_cache)?
+		&it->second:
+		nullptr;
+}
+
+void
+ircd::m::tokens_cache_set(const string_view &token,
+                          const string_view &user_id,
+                          const string_view &device_id)
+{
+	if(unlikely(!size_t(tokens_cache_max)))
+		return;
+
+	const auto expires
+	{
+		now<steady_point>() + seconds(tokens_cache_ttl)
+	};
+
+	// Expired entries are swept when full; otherwise the tokens are random
+	// so the first entry is an arbitrary victim.
+	if(tokens_cache.size() >= size_t(tokens_cache_max))
+		for(auto it(begin(tokens_cache)); it != end(tokens_cache); )
+			if(it->second.expires < now<steady_point>())
+				it = tokens_cache.erase(it);
+			else
+				++it;
+
+	if(tokens_cache.size() >= size_t(tokens_cache_max))
+		tokens_cache.erase(begin(tokens_cache));
+
+	auto &entry
+	{
+		tokens_cache[std::string{token}]
+	};
+
+	entry.user_id = user_id;
+	entry.device_id = device_id;
+	entry.expires = expires;
+}
+
+void
+ircd::m::tokens_cache_del(const string_view &token)
+{
+	++tokens_cache_gen;
+	const auto it
+	{
+		tokens_cache.find(token)
+	};
+
+	if(it != end(tokens_cache))
+		tokens_cache.erase(it);
+}
+
+//
+// user::tokens
+//
+
 ircd::string_view
 ircd::m::user::tokens::create(const mutable_buffer &buf,
                               const json::object &content)
@@ -220,29 +496,14 @@ ircd::m::user::id::buf
 ircd::m::user::tokens::get(std::nothrow_t,
                            const string_view &token)
 {
-	const m::room::id::buf tokens_room_id
-	{
-		"tokens", origin(my())
-	};
-
-	const m::room tokens
+	const auto *const entry
 	{
-		tokens_room_id
+		tokens_cache_fetch(token)
 	};
 
-	const event::idx event_idx
-	{
-		tokens.get(std::nothrow, "ircd.access_token", token)
-	};
-
-	m::user::id::buf ret;
-	m::get(std::nothrow, event_idx, "sender", [&ret]
-	(const string_view &sender)
-	{
-		ret = sender;
-	});
-
-	return ret;
+	return entry?
+		m::user::id::buf{entry->user_id}:
+		m::user::id::buf{};
 }
 
 ircd::m::device::id::buf
@@ -266,35 +527,14 @@ ircd::m::device::id::buf
 ircd::m::user::tokens::device(std::nothrow_t,
                               const string_view &token)
 {
-	const m::room::id::buf tokens_room_id
+	const auto *const entry
 	{
-		"tokens", origin(my())
-	};
-
-	const m::room tokens
-	{
-		tokens_room_id
-	};
-
-	const event::idx event_idx
-	{
-		tokens.get(std::nothrow, "ircd.access_token", token)
+		tokens_cache_fetch(token)
 	};
 
-	device::id::buf ret;
-	m::get(std::nothrow, event_idx, "content", [&ret]
-	(const json::object &content)
-	{
-		const json::string &device_id
-		{
-			content["device_id"]
-		};
-
-		if(device_id)
-			ret = device_id;
-	});
-
-	return ret;
+	return entry && !entry->device_id.empty()?
+		device::id::buf{entry->device_id}:
+		device::id::buf{};
 }
 
 ircd::string_view
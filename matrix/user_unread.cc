@@ -0,0 +1,204 @@
+// The Construct
+//
+// Copyright (C) The Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+namespace ircd::m
+{
+	static void _unread_set(const string_view &key, const user::unread::counts &);
+	static bool _unread_get(const string_view &key, user::unread::counts &);
+
+	// Serializes the read-modify-write of the counters.
+	static ctx::mutex unread_mutex;
+}
+
+size_t
+ircd::m::user::unread::rebuild()
+const
+{
+	size_t ret(0);
+	const user::rooms rooms
+	{
+		user
+	};
+
+	rooms.for_each("join", [this, &ret]
+	(const m::room &room, const string_view &)
+	{
+		rebuild(room.room_id);
+		++ret;
+	});
+
+	return ret;
+}
+
+ircd::m::user::unread::counts
+ircd::m::user::unread::rebuild(const room::id &room_id)
+const
+{
+	return reset(room_id, marker(room_id));
+}
+
+/// The later of the user's fully-read marker and read receipt in the room;
+/// zero when the user has read nothing.
+ircd::m::event::idx
+ircd::m::user::unread::marker(const room::id &room_id)
+const
+{
+	event::idx ret(0);
+	const user::room_account_data account_data
+	{
+		user, room_id
+	};
+
+	account_data.get(std::nothrow, "m.fully_read", [&ret]
+	(const string_view &, const json::object &content)
+	{
+		const json::string &event_id
+		{
+			content["event_id"]
+		};
+
+		if(valid(id::EVENT, event_id))
+			ret = index(std::nothrow, event::id(event_id));
+	});
+
+	receipt::get(room_id, user.user_id, [&ret]
+	(const event::id &event_id)
+	{
+		ret = std::max(ret, index(std::nothrow, event_id));
+	});
+
+	return ret;
+}
+
+ircd::m::user::unread::counts
+ircd::m::user::unread::reset(const room::id &room_id,
+                             const event::idx &marker)
+const
+{
+	const user::notifications notifications
+	{
+		user
+	};
+
+	counts ret;
+	const auto count{[&notifications, &room_id, &marker]
+	(const string_view &only)
+	{
+		user::notifications::opts opts;
+		opts.room_id = room_id;
+		opts.only = only;
+		opts.to = marker;
+
+		size_t num(0);
+		notifications.for_each(opts, [&marker, &num]
+		(const auto &note_idx, const json::object &content)
+		{
+			num += content.get<event::idx>("event_idx", 0UL) > marker;
+			return true;
+		});
+
+		return num;
+	}};
+
+	char buf[dbs::ROOM_UNREAD_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_unread_key(buf, room_id, user.user_id)
+	};
+
+	const std::lock_guard lock
+	{
+		unread_mutex
+	};
+
+	ret.highlight = count("highlight");
+	ret.notification = count(string_view{}) + ret.highlight;
+	_unread_set(key, ret);
+	return ret;
+}
+
+void
+ircd::m::user::unread::incr(const room::id &room_id,
+                            const bool &highlight)
+const
+{
+	char buf[dbs::ROOM_UNREAD_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_unread_key(buf, room_id, user.user_id)
+	};
+
+	// Without an entry the count would start from zero rather than from the
+	// notifications which predate it. The notification being counted here is
+	// not yet sent so the recount does not include it.
+	counts counts;
+	if(!_unread_get(key, counts))
+		rebuild(room_id);
+
+	const std::lock_guard lock
+	{
+		unread_mutex
+	};
+
+	_unread_get(key, counts);
+	counts.notification += 1;
+	counts.highlight += highlight;
+	_unread_set(key, counts);
+}
+
+ircd::m::user::unread::counts
+ircd::m::user::unread::get(const room::id &room_id)
+const
+{
+	counts ret;
+	if(!get(std::nothrow, room_id, ret))
+		ret = rebuild(room_id);
+
+	return ret;
+}
+
+bool
+ircd::m::user::unread::get(std::nothrow_t,
+                           const room::id &room_id,
+                           counts &ret)
+const
+{
+	char buf[dbs::ROOM_UNREAD_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_unread_key(buf, room_id, user.user_id)
+	};
+
+	return _unread_get(key, ret);
+}
+
+bool
+ircd::m::_unread_get(const string_view &key,
+                     user::unread::counts &ret)
+{
+	return dbs::room_unread(key, std::nothrow, [&ret]
+	(const string_view &val)
+	{
+		if(likely(size(val) >= sizeof(ret)))
+			memcpy(&ret, data(val), sizeof(ret));
+	});
+}
+
+void
+ircd::m::_unread_set(const string_view &key,
+                     const user::unread::counts &counts)
+{
+	const const_buffer val
+	{
+		reinterpret_cast<const char *>(&counts), sizeof(counts)
+	};
+
+	db::write(dbs::room_unread, key, val);
+}
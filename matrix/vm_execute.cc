@@ -239,6 +239,13 @@ ircd::m::vm::execute(eval &eval,
 			vm::prefetch_refs(eval): 0UL
 	};
 
+	const bool batch_verify
+	{
+		opts.phase[phase::VERIFY]
+		&& opts.mverify
+		&& events.size() > 1
+	};
+
 	size_t accepted(0), existed(0), i, j, k;
 	for(i = 0; i < events.size(); i += j)
 	{
@@ -254,6 +261,18 @@ ircd::m::vm::execute(eval &eval,
 				0UL
 		};
 
+		// Signatures of the events to be executed are verified together.
+		bool verified[64] {false};
+		if(batch_verify)
+		{
+			const event *batch[64] {nullptr};
+			for(k = 0; k < j; ++k)
+				if(!(existing & (1UL << k)))
+					batch[k] = &events[i + k];
+
+			m::verify(vector_view<bool>(verified, j), vector_view<const event *const>(batch, j));
+		}
+
 		for(k = 0; k < j; ++k, ++eval.evaluated)
 		{
 			const bool exists
@@ -266,6 +285,11 @@ ircd::m::vm::execute(eval &eval,
 				events[i + k]
 			};
 
+			const scope_restore eval_verified
+			{
+				eval.verified, verified[k]
+			};
+
 			const auto fault
 			{
 				!exists?
@@ -863,7 +887,7 @@ ircd::m::vm::execute_pdu(eval &eval,
 			eval.phase, phase::VERIFY
 		};
 
-		if(!verify(event))
+		if(!eval.verified && !verify(event))
 			throw m::BAD_SIGNATURE
 			{
 				"Signature verification failed."
@@ -1086,6 +1110,12 @@ ircd::m::vm::execute_pdu(eval &eval,
 		write_commit(eval);
 	}
 
+	// Admit the next eval out of its COMMIT phase only once this eval's
+	// writes are visible, since its AUTH_PRES through INDEX phases read the
+	// state written here; it need not wait for this eval to retire.
+	if(!parent_post)
+		sequence::dock.notify_all();
+
 	// Wait for sequencing only if this is the stack base, otherwise we'll
 	// never return back to that stack base.
 	if(likely(!parent_post))
@@ -1150,12 +1180,45 @@ ircd::m::vm::retire(eval &eval,
 
 namespace ircd::m::vm
 {
+	struct write_wait;
+
+	static bool write_compat(const db::sopts &, const db::sopts &) noexcept;
+	static void write_commit(const vector_view<write_wait *const> &);
+	static void write_commit_batch();
+
 	[[gnu::visibility("internal")]]
 	extern stats::item<uint64_t>
 	write_commit_count,
-	write_commit_cycles;
+	write_commit_cycles,
+	write_commit_batches,
+	write_commit_batch_multi,
+	write_commit_batch_max,
+	write_commit_batch_last,
+	write_commit_latency_cycles;
+
+	extern conf::item<size_t> write_commit_batch_limit;
+	extern std::deque<write_wait *> write_queue;
+	extern ctx::dock write_dock;
+	extern bool write_leader;
 }
 
+/// An eval at the stack base waiting in the WRITE phase for its transaction
+/// to be committed, possibly by another eval on its behalf.
+struct ircd::m::vm::write_wait
+{
+	vm::eval *eval {nullptr};
+	std::exception_ptr eptr;
+	bool done {false};
+};
+
+decltype(ircd::m::vm::write_commit_batch_limit)
+ircd::m::vm::write_commit_batch_limit
+{
+	{ "name",     "ircd.m.vm.write_commit.batch.limit" },
+	{ "default",  64L                                  },
+	{ "help",     "Maximum evals coalesced into one database write; 1 disables." },
+};
+
 decltype(ircd::m::vm::write_commit_cycles)
 ircd::m::vm::write_commit_cycles
 {
@@ -1168,11 +1231,149 @@ ircd::m::vm::write_commit_count
 	{ "name", "ircd.m.vm.write_commit.count" },
 };
 
+decltype(ircd::m::vm::write_commit_batches)
+ircd::m::vm::write_commit_batches
+{
+	{ "name", "ircd.m.vm.write_commit.batches" },
+};
+
+decltype(ircd::m::vm::write_commit_batch_multi)
+ircd::m::vm::write_commit_batch_multi
+{
+	{ "name", "ircd.m.vm.write_commit.batch.multi" },
+};
+
+decltype(ircd::m::vm::write_commit_batch_max)
+ircd::m::vm::write_commit_batch_max
+{
+	{ "name", "ircd.m.vm.write_commit.batch.max" },
+};
+
+decltype(ircd::m::vm::write_commit_batch_last)
+ircd::m::vm::write_commit_batch_last
+{
+	{ "name", "ircd.m.vm.write_commit.batch.last" },
+};
+
+decltype(ircd::m::vm::write_commit_latency_cycles)
+ircd::m::vm::write_commit_latency_cycles
+{
+	{ "name", "ircd.m.vm.write_commit.latency.cycles" },
+};
+
+decltype(ircd::m::vm::write_queue)
+ircd::m::vm::write_queue;
+
+decltype(ircd::m::vm::write_dock)
+ircd::m::vm::write_dock;
+
+decltype(ircd::m::vm::write_leader)
+ircd::m::vm::write_leader;
+
+/// Group commit. The eval's transaction is queued; if no other eval is
+/// writing this one leads and commits everything in the queue as one batch,
+/// otherwise it waits for the leader. Evals arriving while a write is in
+/// progress are thus coalesced into the next write. The queue is in sequence
+/// order because the COMMIT phase admits evals one at a time.
 void
 ircd::m::vm::write_commit(eval &eval)
 {
 	assert(eval.txn);
 	assert(eval.txn.use_count() == 1);
+	assert(eval.opts);
+
+	// The queue refers to this frame until the commit is done.
+	const ctx::uninterruptible::nothrow ui;
+	const prof::scope_cycles latency
+	{
+		write_commit_latency_cycles
+	};
+
+	write_wait wait
+	{
+		&eval
+	};
+
+	write_queue.emplace_back(&wait);
+	while(!wait.done)
+	{
+		write_dock.wait([&wait]() noexcept
+		{
+			return wait.done || !write_leader;
+		});
+
+		if(wait.done)
+			break;
+
+		const scope_notify notify
+		{
+			write_dock, scope_notify::all
+		};
+
+		const scope_restore leader
+		{
+			write_leader, true
+		};
+
+		write_commit_batch();
+	}
+
+	if(unlikely(wait.eptr))
+		std::rethrow_exception(wait.eptr);
+}
+
+/// Takes the front of the queue up to the limit, stopping short of any eval
+/// with incompatible write options, and commits it.
+void
+ircd::m::vm::write_commit_batch()
+{
+	assert(write_leader);
+	assert(!write_queue.empty());
+	const auto &sopts
+	{
+		write_queue.front()->eval->opts->wopts.sopts
+	};
+
+	const size_t limit
+	{
+		std::clamp(size_t(write_commit_batch_limit), 1UL, write_queue.size())
+	};
+
+	size_t count(1);
+	for(; count < limit; ++count)
+		if(!write_compat(sopts, write_queue.at(count)->eval->opts->wopts.sopts))
+			break;
+
+	write_wait *batch[count];
+	std::copy(begin(write_queue), begin(write_queue) + count, batch);
+	write_queue.erase(begin(write_queue), begin(write_queue) + count);
+
+	std::exception_ptr eptr; try
+	{
+		write_commit(vector_view<write_wait *const>(batch, count));
+	}
+	catch(...)
+	{
+		eptr = std::current_exception();
+	}
+
+	for(auto *const &wait : batch)
+	{
+		wait->eptr = eptr;
+		wait->done = true;
+	}
+}
+
+void
+ircd::m::vm::write_commit(const vector_view<write_wait *const> &batch)
+{
+	assert(!batch.empty());
+	auto &eval
+	{
+		*batch.at(0)->eval
+	};
+
+	assert(eval.txn);
 	auto &txn
 	{
 		*eval.txn
@@ -1184,6 +1385,23 @@ ircd::m::vm::write_commit(eval &eval)
 		eval.opts->wopts.sopts
 	};
 
+	// Concatenate the transactions of the other evals onto the first.
+	if(batch.size() > 1)
+	{
+		const db::txn *other[batch.size() - 1];
+		std::transform(begin(batch) + 1, end(batch), other, []
+		(const write_wait *const &wait)
+		{
+			assert(wait->eval->txn);
+			return wait->eval->txn.get();
+		});
+
+		db::txn::append
+		{
+			txn, vector_view<const db::txn *>(other, batch.size() - 1)
+		};
+	}
+
 	const auto db_seq_before
 	{
 		#ifdef RB_DEBUG
@@ -1203,7 +1421,11 @@ ircd::m::vm::write_commit(eval &eval)
 		txn(sopts);
 	}
 
-	++write_commit_count;
+	++write_commit_batches;
+	write_commit_batch_multi += batch.size() > 1;
+	write_commit_count += batch.size();
+	write_commit_batch_last = batch.size();
+	write_commit_batch_max = std::max(uint64_t(write_commit_batch_max), uint64_t(batch.size()));
 	const auto db_seq_after
 	{
 		#ifdef RB_DEBUG
@@ -1215,18 +1437,35 @@ ircd::m::vm::write_commit(eval &eval)
 
 	log::debug
 	{
-		log, "%s wrote %lu | db seq:%lu:%lu txn:%lu cells:%zu in bytes:%zu cycles:%lu to events database",
+		log, "%s wrote %lu:%lu | db seq:%lu:%lu txn:%lu evals:%zu cells:%zu in bytes:%zu cycles:%lu to events database",
 		loghead(eval),
 		sequence::get(eval),
+		sequence::get(*batch.back()->eval),
 		db_seq_before,
 		db_seq_after,
-		uint64_t(write_commit_count),
+		uint64_t(write_commit_batches),
+		batch.size(),
 		txn.size(),
 		txn.bytes(),
 		uint64_t(write_commit_cycles) - cyc_before,
 	};
 }
 
+/// Whether two evals' write options allow them in the same batch.
+bool
+ircd::m::vm::write_compat(const db::sopts &a,
+                          const db::sopts &b)
+noexcept
+{
+	return true
+	&& a.fsync == b.fsync
+	&& a.journal == b.journal
+	&& a.blocking == b.blocking
+	&& a.prio_low == b.prio_low
+	&& a.prio_high == b.prio_high
+	;
+}
+
 void
 ircd::m::vm::write_append(eval &eval,
                           const event &event,
@@ -156,6 +156,7 @@ get__messages(client &client,
 					.user_id = user_room.user.user_id,
 					.user_room_id = user_room.room_id,
 					.room_depth = room_depth,
+					.bundle_thread = true,
 				}
 			}
 		};
@@ -12,11 +12,11 @@
 
 using namespace ircd;
 
-static int64_t
+static m::event::idx
 threads_chunk(json::stack::array &chunk,
               const m::resource::request &request,
               const m::room::id &room_id,
-              const int64_t &from,
+              const m::event::idx &from,
               const string_view &include,
               const size_t &limit);
 
@@ -58,9 +58,11 @@ get__threads(client &client,
 		request.query.get("include", "all"_sv)
 	};
 
+	// The token is the event_idx of the latest reply of the last thread
+	// in the prior chunk.
 	const auto from
 	{
-		request.query.get<int64_t>("from", m::depth(room_id))
+		request.query.get<m::event::idx>("from", -1UL)
 	};
 
 	const auto limit
@@ -78,7 +80,7 @@ get__threads(client &client,
 		client, http::OK
 	};
 
-	int64_t next_batch {0};
+	m::event::idx next_batch {0};
 	{
 		json::stack::array chunk
 		{
@@ -93,20 +95,80 @@ get__threads(client &client,
 		{
 			response, "next_batch", json::value
 			{
-				next_batch
+				lex_cast(next_batch), json::STRING
 			}
 		};
 
 	return response;
 }
 
-int64_t
+m::event::idx
 threads_chunk(json::stack::array &chunk,
               const m::resource::request &request,
               const m::room::id &room_id,
-              const int64_t &from,
+              const m::event::idx &from,
               const string_view &include,
               const size_t &limit)
 {
-	return 0;
+	const m::room room
+	{
+		room_id
+	};
+
+	const m::room::threads threads
+	{
+		room
+	};
+
+	const bool participated
+	{
+		include == "participated"
+	};
+
+	size_t count(0);
+	m::event::idx last(0);
+	m::event::fetch event;
+	const bool more
+	{
+		!threads.for_each(from, [&](const auto &root_idx, const auto &summary)
+		{
+			// Another thread remains after the chunk is full.
+			if(count >= limit)
+				return false;
+
+			if(participated && !threads.participated(root_idx, request.user_id))
+				return true;
+
+			if(!seek(std::nothrow, event, root_idx))
+				return true;
+
+			const bool appended
+			{
+				m::event::append
+				{
+					chunk, event,
+					{
+						.event_idx = root_idx,
+						.user_id = request.user_id,
+						.query_txnid = false,
+						.query_prev_state = false,
+						.query_visible = true,
+						.bundle_thread = true,
+					}
+				}
+			};
+
+			count += appended;
+			last = summary.latest;
+			return true;
+		})
+	};
+
+	// The bound for the next chunk is the latest reply of the last thread.
+	const m::event::idx ret
+	{
+		more? last: 0UL
+	};
+
+	return ret;
 }
@@ -10,8 +10,14 @@
 
 namespace ircd::m::search
 {
+	using candidate = std::pair<event::idx, long>;
+
 	static bool handle_result(result &, const query &);
 	static bool handle_content(result &, const query &, const json::object &);
+	static long index_rank(const query &, const event::idx &);
+	static bool index_match(const query &, const room::id &, const event::idx &);
+	static bool query_index_room(result &, std::vector<candidate> &, const query &, const room::id &, const size_t &);
+	static bool query_index(result &, const query &, const vector_view<const room::id> &);
 	static bool query_all_rooms(result &, const query &);
 	static bool query_room(result &, const query &, const room::id &);
 	static bool query_rooms(result &, const query &);
@@ -19,6 +25,7 @@ namespace ircd::m::search
 	static resource::response search_post_handle(client &, const resource::request &);
 
 	extern conf::item<size_t> limit_override;
+	extern conf::item<size_t> rank_window;
 	extern conf::item<bool> count_total;
 	extern resource::method search_post;
 	extern resource search_resource;
@@ -72,6 +79,20 @@ ircd::m::search::count_total
 	{ "default",  false                       },
 };
 
+decltype(ircd::m::search::rank_window)
+ircd::m::search::rank_window
+{
+	{ "name",     "ircd.m.search.rank.window" },
+	{ "default",  128L                        },
+	{ "description",
+
+	R"(
+	Number of the most recent matches from the index which are ranked
+	together when results are ordered by rank. Each page of ranked results
+	is drawn from this window before the next window is considered.
+	)"},
+};
+
 decltype(ircd::m::search::limit_override)
 ircd::m::search::limit_override
 {
@@ -242,6 +263,30 @@ try
 			kvs.first
 	};
 
+	// The search term is split the same way as the text of events for the
+	// index. When nothing indexable remains the rooms are scanned instead.
+	std::vector<std::string> term;
+	dbs::room_search_terms(search_term, [&term]
+	(const string_view &t)
+	{
+		if(std::find(begin(term), end(term), t) == end(term))
+			term.emplace_back(t);
+
+		return term.size() < 8;
+	});
+
+	const std::vector<string_view> terms
+	{
+		begin(term), end(term)
+	};
+
+	// The next_batch token is an offset into the result sequence; for the
+	// index it is qualified by the event_idx which bounds that sequence.
+	const auto &[batch_offset, batch_idx]
+	{
+		rsplit(request.query["next_batch"], '_')
+	};
+
 	const json::object &event_context
 	{
 		json::get<"event_context"_>(room_events)
@@ -257,23 +302,28 @@ try
 	const search::query query
 	{
 		.user_id = request.user_id,
-		.batch = request.query.get<size_t>("next_batch", 0UL),
+		.batch = lex_castable<size_t>(batch_offset)? lex_cast<size_t>(batch_offset): 0UL,
+		.batch_idx = lex_castable<event::idx>(batch_idx)? lex_cast<event::idx>(batch_idx): -1UL,
 		.room_events = room_events,
 		.filter = room_event_filter,
 		.search_term = search_term,
+		.terms = terms,
 		.limit = limit,
 		.before_limit = event_context.get("before_limit", context_default),
 		.after_limit = event_context.get("after_limit", context_default),
 		.case_sensitive = case_sensitive,
+		.order_rank = json::get<"order_by"_>(room_events) != "recent",
 	};
 
 	log::logf
 	{
 		log, log::DEBUG,
-		"Query '%s' by %s batch:%ld order_by:%s inc_state:%b rooms:%zu limit:%zu filter:%s",
+		"Query '%s' by %s batch:%ld:%lu terms:%zu order_by:%s inc_state:%b rooms:%zu limit:%zu filter:%s",
 		query.search_term,
 		string_view{query.user_id},
 		query.batch,
+		query.batch_idx,
+		query.terms.size(),
 		json::get<"order_by"_>(query.room_events),
 		json::get<"include_state"_>(query.room_events),
 		json::get<"rooms"_>(query.filter).size(),
@@ -291,23 +341,28 @@ try
 		query_rooms(result, query)
 	};
 
-	// Spec sez this is total results, but riot doesn't use it. Counting total
-	// results is very expensive right now, so we'll just report the count we
-	// have for now...
+	// The index provides a total; scanning the rooms does not, so the count
+	// we have is reported for that.
 	json::stack::member
 	{
 		room_events_result, "count", json::value
 		{
-			long(result.count + !finished)
+			result.total?
+				long(result.total):
+				long(result.count + !finished)
 		}
 	};
 
-	//TODO: XXX
-	json::stack::array
+	json::stack::array highlights
 	{
 		room_events_result, "highlights"
 	};
 
+	for(const auto &term : query.terms)
+		highlights.append(term);
+
+	highlights.~array();
+
 	//TODO: XXX
 	json::stack::object
 	{
@@ -319,7 +374,10 @@ try
 		{
 			room_events_result, "next_batch", json::value
 			{
-				lex_cast(result.skipped + result.checked), json::STRING
+				!result.next_batch.empty()?
+					string_view{result.next_batch}:
+					lex_cast(result.skipped + result.checked),
+				json::STRING
 			}
 		};
 
@@ -369,6 +427,16 @@ ircd::m::search::query_rooms(result &result,
 		*result.out, "results"
 	};
 
+	if(!query.terms.empty())
+	{
+		std::vector<room::id> room_ids;
+		room_ids.reserve(rooms.size());
+		for(const json::string room_id : rooms)
+			room_ids.emplace_back(room_id);
+
+		return query_index(result, query, room_ids);
+	}
+
 	if(rooms.empty())
 		return query_all_rooms(result, query);
 
@@ -379,6 +447,257 @@ ircd::m::search::query_rooms(result &result,
 	return true;
 }
 
+/// Query the room_search index. The postings of the longest term (which is
+/// likely the most selective) are walked from the most recent and the other
+/// terms are confirmed by point lookup. Matches are gathered into a window
+/// which is ordered by rank (or by recency), then the requested page of the
+/// window is output. The next_batch token carries the offset into the
+/// window and the event_idx bounding it.
+bool
+ircd::m::search::query_index(result &result,
+                             const query &query,
+                             const vector_view<const room::id> &rooms)
+{
+	if(rooms.empty() && !is_oper(query.user_id))
+		throw m::ACCESS_DENIED
+		{
+			"You are not an operator."
+		};
+
+	for(const auto &room_id : rooms)
+		if(!visible(m::room(room_id), query.user_id))
+			throw m::ACCESS_DENIED
+			{
+				"You are not permitted to view %s",
+				string_view{room_id},
+			};
+
+	const size_t window
+	{
+		query.order_rank?
+			std::max(size_t(rank_window), query.batch + query.limit):
+			query.batch + query.limit + 1
+	};
+
+	bool full {false};
+	std::vector<candidate> candidates;
+	if(rooms.empty())
+		full |= query_index_room(result, candidates, query, room::id{}, window);
+
+	for(const auto &room_id : rooms)
+		full |= query_index_room(result, candidates, query, room_id, window);
+
+	// Gather the most recent matches across all rooms into the window.
+	std::sort(begin(candidates), end(candidates), []
+	(const auto &a, const auto &b) noexcept
+	{
+		return a.first > b.first;
+	});
+
+	full |= candidates.size() > window;
+	candidates.resize(std::min(candidates.size(), window));
+	const auto bound
+	{
+		!candidates.empty()?
+			candidates.back().first:
+			0UL
+	};
+
+	if(query.order_rank)
+	{
+		for(auto &[event_idx, rank] : candidates)
+			rank = index_rank(query, event_idx);
+
+		std::stable_sort(begin(candidates), end(candidates), []
+		(const auto &a, const auto &b) noexcept
+		{
+			return a.second > b.second;
+		});
+	}
+
+	size_t i(query.batch);
+	for(; i < candidates.size() && result.count < query.limit; ++i)
+	{
+		result.event_idx = candidates[i].first;
+		result.rank = query.order_rank?
+			candidates[i].second:
+			index_rank(query, result.event_idx);
+
+		const bool handled
+		{
+			handle_result(result, query)
+		};
+
+		result.checked += 1;
+		result.matched += 1;
+		result.count += handled;
+	}
+
+	// Results remain in this window
+	if(i < candidates.size())
+	{
+		result.next_batch = query.order_rank?
+			fmt::snstringf{64, "%zu_%lu", i, query.batch_idx}:
+			fmt::snstringf{64, "0_%lu", candidates[i - 1].first};
+
+		return false;
+	}
+
+	// Results remain in the rooms beyond this window
+	if(full)
+	{
+		result.next_batch = fmt::snstringf{64, "0_%lu", bound};
+		return false;
+	}
+
+	return true;
+}
+
+/// Gathers the matches in a room (or in all rooms when the room_id is empty)
+/// below the batch_idx into the candidates. Returns true if the room has
+/// more matches than the window.
+bool
+ircd::m::search::query_index_room(result &result,
+                                  std::vector<candidate> &candidates,
+                                  const query &query,
+                                  const room::id &room_id,
+                                  const size_t &window)
+{
+	assert(!query.terms.empty());
+	const auto &term
+	{
+		*std::max_element(begin(query.terms), end(query.terms), []
+		(const auto &a, const auto &b) noexcept
+		{
+			return size(a) < size(b);
+		})
+	};
+
+	char buf[dbs::ROOM_SEARCH_KEY_MAX_SIZE];
+	const string_view key
+	{
+		dbs::room_search_key(buf, term, room_id, query.batch_idx)
+	};
+
+	bool full {false};
+	size_t found(0);
+	std::string last_room;
+	for(auto it(dbs::room_search.begin(key)); it; ++it)
+	{
+		const auto &[_room_id, event_idx]
+		{
+			dbs::room_search_key(it->first)
+		};
+
+		if(room_id && _room_id != room_id)
+			break;
+
+		// Windows are per-room when iterating all rooms.
+		if(!room_id && _room_id != last_room)
+		{
+			last_room = _room_id;
+			found = 0;
+		}
+
+		if(event_idx >= query.batch_idx)
+			continue;
+
+		// Once the window is full the room is only counted, if at all.
+		if(found > window && !count_total)
+		{
+			if(room_id)
+				break;
+
+			continue;
+		}
+
+		if(!index_match(query, m::room::id(_room_id), event_idx))
+			continue;
+
+		if(!m::match(query.filter, event_idx))
+			continue;
+
+		if(m::redacted(event_idx))
+			continue;
+
+		result.total += 1;
+		if(++found > window)
+		{
+			full = true;
+			continue;
+		}
+
+		candidates.emplace_back(event_idx, 0L);
+	}
+
+	return full;
+}
+
+/// Confirms the event matches the remaining terms of the query.
+bool
+ircd::m::search::index_match(const query &query,
+                             const room::id &room_id,
+                             const event::idx &event_idx)
+{
+	for(const auto &term : query.terms)
+	{
+		char buf[dbs::ROOM_SEARCH_KEY_MAX_SIZE];
+		const string_view key
+		{
+			dbs::room_search_key(buf, term, room_id, event_idx)
+		};
+
+		if(!db::has(dbs::room_search, key))
+			return false;
+	}
+
+	if(!query.case_sensitive)
+		return true;
+
+	bool ret{false};
+	m::get(std::nothrow, event_idx, "content", [&query, &ret]
+	(const json::object &content)
+	{
+		const json::string body
+		{
+			content["body"]
+		};
+
+		ret = has(body, query.search_term);
+	});
+
+	return ret;
+}
+
+/// Rank is the share of terms in the event's text which are terms of the
+/// query, scaled to an integer.
+long
+ircd::m::search::index_rank(const query &query,
+                            const event::idx &event_idx)
+{
+	size_t terms(0), matches(0);
+	m::get(std::nothrow, event_idx, "content", [&query, &terms, &matches]
+	(const json::object &content)
+	{
+		const json::string body
+		{
+			content["body"]
+		};
+
+		dbs::room_search_terms(body, [&query, &terms, &matches]
+		(const string_view &term)
+		{
+			matches += std::find(begin(query.terms), end(query.terms), term) != end(query.terms);
+			terms += 1;
+			return true;
+		});
+	});
+
+	return terms?
+		long(matches * 1000 / terms):
+		0L;
+}
+
 bool
 ircd::m::search::query_room(result &result,
                             const query &query,
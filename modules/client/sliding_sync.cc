@@ -0,0 +1,1012 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2023 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+namespace ircd::m::sync::sliding
+{
+	struct entry;
+	struct config;
+	struct conn;
+
+	using configs = std::map<string_view, config, std::less<>>;
+
+	static string_view make_pos(const mutable_buffer &, const conn &);
+	static std::shared_ptr<conn> get_conn(const resource::request &, const string_view &device_id, const string_view &conn_id, const bool &create);
+	static void expire_conns();
+	static void order_rebuild(conn &, data &, const event::idx &);
+	static void order_update(conn &, data &, const event::idx &);
+	static bool filtered(const entry &, const json::object &filters);
+	static void config_merge(config &, const json::object &);
+	static size_t select_list(configs &, const conn &, const json::object &list);
+	static bool select_room(configs &, const conn &, const string_view &room_id, const json::object &);
+	static void room_required_state(data &, json::stack::object &, const config &, const bool &initial);
+	static void room_items(data &, json::stack::object &, const config &);
+	static void room_render(data &, conn &, json::stack::object &, const entry &, const config &);
+	static resource::response handle_post(client &, const resource::request &);
+
+	extern conf::item<size_t> conn_max;
+	extern conf::item<seconds> conn_ttl;
+	extern conf::item<milliseconds> timeout_max;
+	extern conf::item<size_t> scan_max;
+	extern conf::item<size_t> timeline_limit_max;
+	extern conf::item<size_t> item_buffer_size;
+	extern resource::method method_post;
+	extern resource resource;
+}
+
+ircd::mapi::header
+IRCD_MODULE
+{
+	"Client :Sliding Sync"
+};
+
+/// A room in the list of a connection. The bump is the index of the newest
+/// event in the room; the list is sorted by it, most recent first.
+struct ircd::m::sync::sliding::entry
+{
+	event::idx bump {0};
+	std::string room_id;
+	bool invite {false};
+};
+
+/// Parameters for rendering a room; the union of all lists and subscriptions
+/// which selected the room in a request.
+struct ircd::m::sync::sliding::config
+{
+	size_t timeline_limit {0};
+	std::vector<std::pair<string_view, string_view>> required_state;
+};
+
+/// Server-side state of a sliding sync connection, identified by the user,
+/// device and the client's conn_id. The room list is maintained from the
+/// events in the range since the last response rather than recomputed, and
+/// `sent` records what the client already has so responses only carry the
+/// rooms which changed.
+struct ircd::m::sync::sliding::conn
+{
+	std::string key;
+	ctx::mutex mutex;
+	uint64_t serial {0};                    // count of requests received
+	uint64_t gen {0};                       // count of responses issued
+	event::idx pos {0};                     // upper bound of the last response
+	event::idx ordered {0};                 // order is current to this index
+	std::vector<entry> order;               // joined and invited rooms
+	std::map<std::string, event::idx, std::less<>> sent;
+	std::map<std::string, size_t, std::less<>> counts;
+	steady_point used;
+};
+
+namespace ircd::m::sync::sliding
+{
+	// user_id | device_id | conn_id => connection
+	static std::map<std::string, std::shared_ptr<conn>, std::less<>> conns;
+}
+
+decltype(ircd::m::sync::sliding::resource)
+ircd::m::sync::sliding::resource
+{
+	"/_matrix/client/unstable/org.matrix.simplified_msc3575/sync",
+	{
+		"(MSC3575) Sliding Sync. Synchronise windows of the client's room list"
+		" sorted by recency, and only the rooms which changed within those"
+		" windows since the connection's last position."
+	}
+};
+
+decltype(ircd::m::sync::sliding::method_post)
+ircd::m::sync::sliding::method_post
+{
+	resource, "POST", handle_post,
+	{
+		method_post.REQUIRES_AUTH,
+		-1s,
+	}
+};
+
+decltype(ircd::m::sync::sliding::conn_max)
+ircd::m::sync::sliding::conn_max
+{
+	{ "name",     "ircd.client.sync.sliding.conn.max" },
+	{ "default",  4096L                               },
+};
+
+decltype(ircd::m::sync::sliding::conn_ttl)
+ircd::m::sync::sliding::conn_ttl
+{
+	{ "name",     "ircd.client.sync.sliding.conn.ttl" },
+	{ "default",  1800L                               },
+};
+
+decltype(ircd::m::sync::sliding::timeout_max)
+ircd::m::sync::sliding::timeout_max
+{
+	{ "name",     "ircd.client.sync.sliding.timeout.max" },
+	{ "default",  180 * 1000L                            },
+};
+
+decltype(ircd::m::sync::sliding::scan_max)
+ircd::m::sync::sliding::scan_max
+{
+	{ "name",     "ircd.client.sync.sliding.scan.max" },
+	{ "default",  8192L                               },
+	{ "help",     "Maximum events to scan to update a room list before it is rebuilt." },
+};
+
+decltype(ircd::m::sync::sliding::timeline_limit_max)
+ircd::m::sync::sliding::timeline_limit_max
+{
+	{ "name",     "ircd.client.sync.sliding.timeline.limit.max" },
+	{ "default",  64L                                           },
+};
+
+decltype(ircd::m::sync::sliding::item_buffer_size)
+ircd::m::sync::sliding::item_buffer_size
+{
+	{ "name",     "ircd.client.sync.sliding.item.buffer_size" },
+	{ "default",  long(256_KiB)                               },
+};
+
+ircd::m::resource::response
+ircd::m::sync::sliding::handle_post(client &client,
+                                    const resource::request &request)
+{
+	const json::string &conn_id
+	{
+		request["conn_id"]
+	};
+
+	const string_view &pos
+	{
+		request.query["pos"]
+	};
+
+	const milliseconds timeout
+	{
+		std::min(request.query.get<long>("timeout", 0L), long(milliseconds(timeout_max).count()))
+	};
+
+	const device::id::buf device_id
+	{
+		m::user::tokens::device(std::nothrow, request.access_token)
+	};
+
+	expire_conns();
+	const auto conn_
+	{
+		get_conn(request, device_id, conn_id, !pos)
+	};
+
+	if(!conn_)
+		throw m::error
+		{
+			http::BAD_REQUEST, "M_UNKNOWN_POS",
+			"Unknown position; the connection must be restarted."
+		};
+
+	// Clients re-send on a connection without waiting for the response; a
+	// request still waiting for events is superseded by this one and made
+	// to return so the connection is released.
+	auto &conn{*conn_};
+	const auto serial
+	{
+		++conn.serial
+	};
+
+	if(conn.mutex.locked())
+		vm::sequence::dock.notify_all();
+
+	const std::lock_guard lock
+	{
+		conn.mutex
+	};
+
+	// A position other than the last one issued means the client did not
+	// receive the last response; everything it has is then unknown to us.
+	char posbuf[64];
+	if(!pos || pos != make_pos(posbuf, conn))
+	{
+		conn.sent.clear();
+		conn.counts.clear();
+	}
+
+	if(!pos)
+		conn.order.clear();
+
+	conn.used = now<steady_point>();
+	const args args
+	{
+		request
+	};
+
+	data data
+	{
+		request.user_id,
+		{ 0UL, vm::sequence::retired + 1 },
+		&client,
+		nullptr,
+		nullptr,
+		&args,
+		device_id,
+	};
+
+	const json::object &lists
+	{
+		request["lists"]
+	};
+
+	const json::object &subscriptions
+	{
+		request["room_subscriptions"]
+	};
+
+	const auto timesout
+	{
+		now<system_point>() + timeout
+	};
+
+	// Select the rooms to render; when nothing changed for the client wait
+	// for the next event and try again until the timeout.
+	configs want;
+	std::map<string_view, size_t, std::less<>> counts;
+	event::idx current;
+	bool superseded{false};
+	while(1)
+	{
+		current = vm::sequence::retired + 1;
+		order_update(conn, data, current);
+
+		want.clear();
+		counts.clear();
+		for(const auto &[name, list] : lists)
+			counts.emplace(name, select_list(want, conn, list));
+
+		for(const auto &[room_id, sub] : subscriptions)
+			select_room(want, conn, json::string(room_id), sub);
+
+		const bool changed_rooms
+		{
+			std::any_of(begin(conn.order), end(conn.order), [&want, &conn]
+			(const entry &entry)
+			{
+				if(!want.count(entry.room_id))
+					return false;
+
+				const auto it(conn.sent.find(entry.room_id));
+				return it == end(conn.sent) || it->second < entry.bump;
+			})
+		};
+
+		const bool changed_counts
+		{
+			std::any_of(begin(counts), end(counts), [&conn]
+			(const auto &count)
+			{
+				const auto it(conn.counts.find(count.first));
+				return it == end(conn.counts) || it->second != count.second;
+			})
+		};
+
+		if(changed_rooms || changed_counts || !pos)
+			break;
+
+		if(now<system_point>() >= timesout)
+			break;
+
+		vm::sequence::dock.wait_until(timesout, [&conn, &serial, &current]
+		{
+			return false
+			|| conn.serial != serial
+			|| vm::sequence::retired + 1 > current
+			;
+		});
+
+		if((superseded = conn.serial != serial))
+			break;
+	}
+
+	// The client will not see this response; it carries the position the
+	// newer request continues from without advancing the connection.
+	if(superseded)
+		return resource::response
+		{
+			client, json::members
+			{
+				{ "pos", make_pos(posbuf, conn) },
+			}
+		};
+
+	data.range.second = current;
+	conn.pos = current;
+	++conn.gen;
+
+	resource::response::chunked response
+	{
+		client, http::OK
+	};
+
+	json::stack out
+	{
+		response.buf, response.flusher()
+	};
+
+	data.out = &out;
+	json::stack::object top
+	{
+		out
+	};
+
+	json::stack::member
+	{
+		top, "pos", make_pos(posbuf, conn)
+	};
+
+	size_t rendered(0);
+	{
+		json::stack::object rooms
+		{
+			top, "rooms"
+		};
+
+		for(const auto &entry : conn.order)
+		{
+			const auto it(want.find(entry.room_id));
+			if(it == end(want))
+				continue;
+
+			const auto sent(conn.sent.find(entry.room_id));
+			if(sent != end(conn.sent) && sent->second >= entry.bump)
+				continue;
+
+			room_render(data, conn, rooms, entry, it->second);
+			++rendered;
+		}
+	}
+
+	{
+		json::stack::object lists_
+		{
+			top, "lists"
+		};
+
+		for(const auto &[name, count] : counts)
+		{
+			json::stack::object list
+			{
+				lists_, name
+			};
+
+			json::stack::member
+			{
+				list, "count", json::value{long(count)}
+			};
+
+			conn.counts[std::string{name}] = count;
+		}
+	}
+
+	json::stack::object
+	{
+		top, "extensions"
+	};
+
+	log::debug
+	{
+		log, "sliding %s pos:%lu rooms:%zu of %zu lists:%zu",
+		loghead(data),
+		conn.pos,
+		rendered,
+		conn.order.size(),
+		counts.size(),
+	};
+
+	return response;
+}
+
+void
+ircd::m::sync::sliding::room_render(data &data,
+                                    conn &conn,
+                                    json::stack::object &rooms,
+                                    const entry &entry,
+                                    const config &config)
+{
+	const auto sent
+	{
+		conn.sent.find(entry.room_id)
+	};
+
+	const bool initial
+	{
+		sent == end(conn.sent)
+	};
+
+	const m::room room
+	{
+		entry.room_id
+	};
+
+	const auto &[top_event_id, top_depth, top_event_idx]
+	{
+		m::top(std::nothrow, room)
+	};
+
+	const scope_restore their_room
+	{
+		data.room, &room
+	};
+
+	const scope_restore their_membership
+	{
+		data.membership, entry.invite? "invite"_sv: "join"_sv
+	};
+
+	const scope_restore their_head
+	{
+		data.room_head, top_event_idx
+	};
+
+	const scope_restore their_depth
+	{
+		data.room_depth, top_depth
+	};
+
+	// Only events after those the client already has for this room.
+	const scope_restore their_range
+	{
+		data.range.first, initial? 0UL: sent->second + 1
+	};
+
+	json::stack::object object
+	{
+		rooms, entry.room_id
+	};
+
+	if(initial)
+		json::stack::member
+		{
+			object, "initial", json::value{true}
+		};
+
+	char namebuf[256];
+	const auto name
+	{
+		m::display_name(namebuf, room)
+	};
+
+	if(name)
+		json::stack::member
+		{
+			object, "name", json::value{name, json::STRING}
+		};
+
+	json::stack::member
+	{
+		object, "bump_stamp", json::value{long(entry.bump)}
+	};
+
+	room_required_state(data, object, config, initial);
+	room_items(data, object, config);
+	conn.sent[entry.room_id] = std::max(entry.bump, top_event_idx);
+}
+
+/// The room's content is composed by the same sync::item handlers as the
+/// polylog /sync into a scratch buffer, then reshaped for this response.
+void
+ircd::m::sync::sliding::room_items(data &data,
+                                   json::stack::object &object,
+                                   const config &config)
+{
+	static const string_view names[]
+	{
+		"rooms.timeline",
+		"rooms.unread_notifications",
+		"rooms.summary",
+	};
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		size_t(item_buffer_size)
+	};
+
+	json::stack out
+	{
+		buf
+	};
+
+	{
+		const scope_restore their_out
+		{
+			data.out, &out
+		};
+
+		json::stack::object top
+		{
+			out
+		};
+
+		for(const auto &name : names)
+		{
+			if(name == "rooms.timeline" && !config.timeline_limit)
+				continue;
+
+			const auto it
+			{
+				item::map.find(name)
+			};
+
+			if(it == end(item::map))
+				continue;
+
+			auto &item
+			{
+				*it->second
+			};
+
+			json::stack::checkpoint checkpoint
+			{
+				out
+			};
+
+			json::stack::object object
+			{
+				out, item.member_name()
+			};
+
+			if(item.polylog(data))
+				out.invalidate_checkpoints();
+			else
+				checkpoint.committing(false);
+		}
+	}
+
+	const json::object items
+	{
+		out.completed()
+	};
+
+	const json::object &timeline
+	{
+		items["timeline"]
+	};
+
+	if(!empty(timeline))
+	{
+		const json::array &events
+		{
+			timeline["events"]
+		};
+
+		const size_t count
+		{
+			size_t(events.count())
+		};
+
+		const size_t limit
+		{
+			std::min(config.timeline_limit, size_t(timeline_limit_max))
+		};
+
+		const size_t skip
+		{
+			count > limit? count - limit: 0
+		};
+
+		// The newest event trimmed from the front becomes the prev_batch,
+		// as the oldest event is for the item's own timeline.
+		json::string prev_batch
+		{
+			timeline["prev_batch"]
+		};
+
+		{
+			json::stack::array array
+			{
+				object, "timeline"
+			};
+
+			size_t i(0);
+			for(const json::object event : events)
+				if(i++ < skip)
+					prev_batch = json::string{event["event_id"]};
+				else
+					array.append(event);
+		}
+
+		const bool limited
+		{
+			skip || timeline.get<bool>("limited", false)
+		};
+
+		json::stack::member
+		{
+			object, "limited", json::value{limited}
+		};
+
+		if(prev_batch)
+			json::stack::member
+			{
+				object, "prev_batch", json::value{prev_batch, json::STRING}
+			};
+	}
+
+	const json::object &unread
+	{
+		items["unread_notifications"]
+	};
+
+	for(const auto &key : {"notification_count"_sv, "highlight_count"_sv})
+		if(unread.has(key))
+			json::stack::member
+			{
+				object, key, json::value{unread.get<long>(key)}
+			};
+
+	const json::object &summary
+	{
+		items["summary"]
+	};
+
+	if(summary.has("m.joined_member_count"))
+		json::stack::member
+		{
+			object, "joined_count", json::value{summary.get<long>("m.joined_member_count")}
+		};
+
+	if(summary.has("m.invited_member_count"))
+		json::stack::member
+		{
+			object, "invited_count", json::value{summary.get<long>("m.invited_member_count")}
+		};
+}
+
+/// The requested state pairs; a state_key of "*" matches all keys of the
+/// type and "$ME" the user. Lazy loading ("$LAZY") is not offered here. An
+/// incremental response only carries state which changed in the range.
+void
+ircd::m::sync::sliding::room_required_state(data &data,
+                                            json::stack::object &object,
+                                            const config &config,
+                                            const bool &initial)
+{
+	if(config.required_state.empty())
+		return;
+
+	assert(data.room);
+	const m::room::state state
+	{
+		*data.room
+	};
+
+	std::vector<event::idx> idx;
+	const auto add{[&data, &idx, &initial]
+	(const event::idx &event_idx)
+	{
+		if(event_idx && (initial || apropos(data, event_idx)))
+			idx.emplace_back(event_idx);
+	}};
+
+	for(const auto &[type, state_key_] : config.required_state)
+	{
+		const string_view &state_key
+		{
+			state_key_ == "$ME"?
+				string_view{data.user.user_id}:
+				state_key_
+		};
+
+		if(state_key == "$LAZY")
+			continue;
+
+		if(type == "*")
+			state.for_each([&add, &state_key]
+			(const string_view &type, const string_view &state_key_, const event::idx &event_idx)
+			{
+				if(state_key == "*" || state_key == state_key_)
+					add(event_idx);
+
+				return true;
+			});
+		else if(state_key == "*")
+			state.for_each(type, [&add]
+			(const string_view &type, const string_view &state_key, const event::idx &event_idx)
+			{
+				add(event_idx);
+				return true;
+			});
+		else
+			add(state.get(std::nothrow, type, state_key));
+	}
+
+	std::sort(begin(idx), end(idx));
+	idx.erase(std::unique(begin(idx), end(idx)), end(idx));
+
+	json::stack::array array
+	{
+		object, "required_state"
+	};
+
+	m::seek(std::nothrow, idx, [&data, &array]
+	(const auto &event_idx, const m::event &event)
+	{
+		m::event::append
+		{
+			array, event,
+			{
+				.event_idx = event_idx,
+				.user_id = data.user.user_id,
+				.user_room_id = data.user_room.room_id,
+				.room_depth = data.room_depth,
+				.query_txnid = false,
+				.query_prev_state = false,
+			}
+		};
+
+		return true;
+	});
+}
+
+size_t
+ircd::m::sync::sliding::select_list(configs &want,
+                                    const conn &conn,
+                                    const json::object &list)
+{
+	const json::object &filters
+	{
+		list["filters"]
+	};
+
+	const json::array &ranges
+	{
+		list["ranges"]
+	};
+
+	size_t pos(0);
+	for(const auto &entry : conn.order)
+	{
+		if(!filtered(entry, filters))
+			continue;
+
+		for(const json::array range : ranges)
+		{
+			const auto start(range.at<size_t>(0));
+			const auto stop(range.at<size_t>(1));
+			if(pos < start || pos > stop)
+				continue;
+
+			config_merge(want[entry.room_id], list);
+			break;
+		}
+
+		++pos;
+	}
+
+	return pos;
+}
+
+bool
+ircd::m::sync::sliding::select_room(configs &want,
+                                    const conn &conn,
+                                    const string_view &room_id,
+                                    const json::object &sub)
+{
+	const auto it
+	{
+		std::find_if(begin(conn.order), end(conn.order), [&room_id]
+		(const entry &entry)
+		{
+			return entry.room_id == room_id;
+		})
+	};
+
+	// Subscriptions are only honored for rooms in the user's room list.
+	if(it == end(conn.order))
+		return false;
+
+	config_merge(want[it->room_id], sub);
+	return true;
+}
+
+void
+ircd::m::sync::sliding::config_merge(config &config,
+                                     const json::object &params)
+{
+	config.timeline_limit = std::max
+	(
+		config.timeline_limit, params.get<size_t>("timeline_limit", 0UL)
+	);
+
+	for(const json::array pair : json::array(params["required_state"]))
+		config.required_state.emplace_back
+		(
+			json::string(pair.at(0)), json::string(pair.at(1))
+		);
+}
+
+bool
+ircd::m::sync::sliding::filtered(const entry &entry,
+                                 const json::object &filters)
+{
+	if(filters.has("is_invite"))
+		if(filters.get<bool>("is_invite") != entry.invite)
+			return false;
+
+	return true;
+}
+
+/// Bring the room list of the connection current to `upto` by scanning the
+/// events since it was last ordered. Changes to the user's own membership,
+/// or a range too large to scan, rebuild the list instead.
+void
+ircd::m::sync::sliding::order_update(conn &conn,
+                                     data &data,
+                                     const event::idx &upto)
+{
+	if(conn.order.empty() || !conn.ordered)
+		return order_rebuild(conn, data, upto);
+
+	if(conn.ordered >= upto)
+		return;
+
+	if(upto - conn.ordered > size_t(scan_max))
+		return order_rebuild(conn, data, upto);
+
+	static const event::fetch::opts fopts
+	{
+		event::keys::include
+		{
+			"room_id",
+			"state_key",
+			"type",
+		}
+	};
+
+	std::map<string_view, entry *, std::less<>> rooms;
+	for(auto &entry : conn.order)
+		rooms.emplace(entry.room_id, &entry);
+
+	bool rebuild(false);
+	m::events::for_each({conn.ordered, upto, &fopts}, [&data, &rooms, &rebuild]
+	(const event::idx &event_idx, const m::event &event)
+	{
+		const bool own_membership
+		{
+			json::get<"type"_>(event) == "m.room.member"
+			&& json::get<"state_key"_>(event) == data.user.user_id
+		};
+
+		if(own_membership)
+		{
+			rebuild = true;
+			return false;
+		}
+
+		const auto it
+		{
+			rooms.find(json::get<"room_id"_>(event))
+		};
+
+		if(it != end(rooms))
+			it->second->bump = std::max(it->second->bump, event_idx);
+
+		return true;
+	});
+
+	if(rebuild)
+		return order_rebuild(conn, data, upto);
+
+	std::stable_sort(begin(conn.order), end(conn.order), []
+	(const entry &a, const entry &b)
+	{
+		return a.bump > b.bump;
+	});
+
+	conn.ordered = upto;
+}
+
+void
+ircd::m::sync::sliding::order_rebuild(conn &conn,
+                                      data &data,
+                                      const event::idx &upto)
+{
+	conn.order.clear();
+	for(const auto &membership : {"join"_sv, "invite"_sv})
+		data.user_rooms.for_each(membership, [&conn, &membership]
+		(const m::room &room, const string_view &)
+		{
+			conn.order.emplace_back(entry
+			{
+				m::head_idx(std::nothrow, room.room_id),
+				std::string{room.room_id},
+				membership == "invite",
+			});
+
+			return true;
+		});
+
+	std::stable_sort(begin(conn.order), end(conn.order), []
+	(const entry &a, const entry &b)
+	{
+		return a.bump > b.bump;
+	});
+
+	conn.ordered = upto;
+}
+
+std::shared_ptr<ircd::m::sync::sliding::conn>
+ircd::m::sync::sliding::get_conn(const resource::request &request,
+                                 const string_view &device_id,
+                                 const string_view &conn_id,
+                                 const bool &create)
+{
+	char buf[768];
+	const string_view key
+	{
+		fmt::sprintf
+		{
+			buf, "%s|%s|%s",
+			string_view{request.user_id},
+			device_id,
+			conn_id,
+		}
+	};
+
+	auto it
+	{
+		conns.lower_bound(key)
+	};
+
+	if(it != end(conns) && it->first == key)
+		return it->second;
+
+	if(!create)
+		return {};
+
+	auto ptr
+	{
+		std::make_shared<conn>()
+	};
+
+	ptr->key = key;
+	ptr->used = now<steady_point>();
+	conns.emplace_hint(it, ptr->key, ptr);
+	return ptr;
+}
+
+void
+ircd::m::sync::sliding::expire_conns()
+{
+	const auto now
+	{
+		ircd::now<steady_point>()
+	};
+
+	for(auto it(begin(conns)); it != end(conns); )
+		if(it->second->used + seconds(conn_ttl) < now)
+			it = conns.erase(it);
+		else
+			++it;
+
+	while(conns.size() > size_t(conn_max))
+		conns.erase(std::min_element(begin(conns), end(conns), []
+		(const auto &a, const auto &b)
+		{
+			return a.second->used < b.second->used;
+		}));
+}
+
+ircd::string_view
+ircd::m::sync::sliding::make_pos(const mutable_buffer &buf,
+                                 const conn &conn)
+{
+	return fmt::sprintf
+	{
+		buf, "%lu_%lu",
+		conn.gen,
+		conn.pos,
+	};
+}
@@ -41,6 +41,52 @@ namespace ircd::m::sync::longpoll
 	static void fini() noexcept;
 }
 
+namespace ircd::m::sync::snapshot
+{
+	struct entry;
+	struct capture;
+
+	static size_t capture_bytes;
+	static std::string make_key(const data &);
+	static void evict(const size_t &budget);
+	static bool serve(data &, resource::response::chunked &, const string_view &key);
+	static void store(data &, const string_view &key, const std::string &content);
+
+	extern conf::item<bool> enable;
+	extern conf::item<size_t> budget;
+	extern conf::item<size_t> entry_max;
+	extern conf::item<seconds> ttl;
+	extern conf::item<int64_t> level;
+	extern ircd::stats::item<uint64_t> hit;
+	extern ircd::stats::item<uint64_t> miss;
+	extern ircd::stats::item<uint64_t> bytes;
+}
+
+/// Accumulates the output of an initial sync for storage as a snapshot. The
+/// bytes held by all captures in progress are bounded by the snapshot budget;
+/// a capture exceeding either limit is abandoned and its buffer released.
+struct ircd::m::sync::snapshot::capture
+{
+	std::string buf;
+	bool active {false};
+
+	explicit operator bool() const
+	{
+		return active;
+	}
+
+	bool append(const const_buffer &);
+	void abandon() noexcept;
+
+	capture(const bool &active)
+	:active{active}
+	{}
+
+	capture(capture &&) = delete;
+	capture(const capture &) = delete;
+	~capture() noexcept;
+};
+
 ircd::mapi::header
 IRCD_MODULE
 {
@@ -297,6 +343,27 @@ ircd::m::sync::handle_get(client &client,
 		{ "Cache-Control", "no-cache" },
 	};
 
+	// An initial sync may be answered from a recent snapshot for this user,
+	// device and filter; otherwise the output of the polylog is captured to
+	// make one.
+	const std::string snapshot_key
+	{
+		snapshot::enable
+		&& initial_sync
+		&& !data.phased
+		&& !args.semaphore
+		&& !paused
+		&& !invalid_since
+		&& range.second == vm::sequence::retired + 1?
+			snapshot::make_key(data):
+			std::string{}
+	};
+
+	snapshot::capture capture
+	{
+		!snapshot_key.empty()
+	};
+
 	// Start the chunked encoded response.
 	resource::response::chunked response
 	{
@@ -311,8 +378,17 @@ ircd::m::sync::handle_get(client &client,
 	// kernel's TCP buffer, providing flow control for the sync composition.
 	json::stack out
 	{
-		response.buf,
-		std::bind(sync::flush, std::ref(data), std::ref(response), ph::_1),
+		response.buf, [&data, &response, &capture]
+		(const const_buffer &buf)
+		{
+			const auto ret
+			{
+				sync::flush(data, response, buf)
+			};
+
+			capture.append(ret);
+			return ret;
+		},
 		size_t(flush_hiwat)
 	};
 	data.out = &out;
@@ -396,8 +472,23 @@ ircd::m::sync::handle_get(client &client,
 	if(paused)
 		ctx::sleep_until(data.args->timesout);
 
+	if(!complete && should_polylog && !snapshot_key.empty())
+		complete = snapshot::serve(data, response, snapshot_key);
+
 	if(!complete && should_polylog)
+	{
 		complete = polylog_handle(data);
+		if(!complete)
+			capture.abandon();
+
+		if(capture)
+			out.flush(true);
+
+		if(capture)
+			snapshot::store(data, snapshot_key, capture.buf);
+
+		capture.abandon();
+	}
 
 	if(!complete && should_linear)
 		complete = linear_handle(data);
@@ -500,6 +591,336 @@ ircd::m::sync::flush(data &data,
 	return wrote;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// snapshot
+//
+
+/// A complete initial sync response retained for replay. The response is the
+/// state of the user's sync as of `seq` and carries `seq` as its next_batch;
+/// events in the gap to the present are delivered to the client by the
+/// linear-sync it makes with that token. The content is zstd compressed when
+/// the library is available.
+struct ircd::m::sync::snapshot::entry
+{
+	event::idx seq {0};
+	size_t size {0};
+	bool compressed {false};
+	std::shared_ptr<const std::string> content;
+	steady_point made;
+	steady_point used;
+};
+
+namespace ircd::m::sync::snapshot
+{
+	// user_id | device_id | filter => entry
+	static std::map<std::string, entry, std::less<>> cache;
+	static size_t cache_bytes;
+}
+
+decltype(ircd::m::sync::snapshot::enable)
+ircd::m::sync::snapshot::enable
+{
+	{ "name",     "ircd.client.sync.snapshot.enable" },
+	{ "default",  true                               },
+};
+
+decltype(ircd::m::sync::snapshot::budget)
+ircd::m::sync::snapshot::budget
+{
+	{ "name",     "ircd.client.sync.snapshot.budget"             },
+	{ "default",  long(128_MiB)                                  },
+	{ "help",     "Total bytes of stored snapshots before eviction." },
+};
+
+decltype(ircd::m::sync::snapshot::entry_max)
+ircd::m::sync::snapshot::entry_max
+{
+	{ "name",     "ircd.client.sync.snapshot.entry.max"          },
+	{ "default",  long(32_MiB)                                   },
+	{ "help",     "Responses larger than this are not retained." },
+};
+
+decltype(ircd::m::sync::snapshot::ttl)
+ircd::m::sync::snapshot::ttl
+{
+	{ "name",     "ircd.client.sync.snapshot.ttl" },
+	{ "default",  600L                            },
+};
+
+decltype(ircd::m::sync::snapshot::level)
+ircd::m::sync::snapshot::level
+{
+	{ "name",     "ircd.client.sync.snapshot.level" },
+	{ "default",  3L                                },
+	{ "help",     "zstd compression level."         },
+};
+
+decltype(ircd::m::sync::snapshot::hit)
+ircd::m::sync::snapshot::hit
+{
+	{ "name", "ircd.client.sync.snapshot.hit" },
+};
+
+decltype(ircd::m::sync::snapshot::miss)
+ircd::m::sync::snapshot::miss
+{
+	{ "name", "ircd.client.sync.snapshot.miss" },
+};
+
+decltype(ircd::m::sync::snapshot::bytes)
+ircd::m::sync::snapshot::bytes
+{
+	{ "name", "ircd.client.sync.snapshot.bytes" },
+};
+
+/// The snapshot is usable while it is fresh and the gap to the present is
+/// small enough for the client's next request to be a linear-sync.
+bool
+ircd::m::sync::snapshot::serve(data &data,
+                               resource::response::chunked &response,
+                               const string_view &key)
+{
+	const auto it
+	{
+		cache.find(key)
+	};
+
+	if(it == end(cache))
+	{
+		++miss;
+		return false;
+	}
+
+	auto &entry
+	{
+		it->second
+	};
+
+	const bool stale
+	{
+		entry.made + seconds(ttl) < now<steady_point>()
+		|| entry.seq > data.range.second
+		|| data.range.second - entry.seq > size_t(linear_delta_max)
+	};
+
+	if(stale)
+	{
+		assert(cache_bytes >= entry.content->size());
+		cache_bytes -= entry.content->size();
+		bytes = cache_bytes;
+		cache.erase(it);
+		++miss;
+		return false;
+	}
+
+	// Held for the duration; the entry may be replaced or evicted while
+	// this context yields to write.
+	const auto content(entry.content);
+	const auto seq(entry.seq);
+	entry.used = now<steady_point>();
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		entry.compressed? entry.size: 0UL
+	};
+
+	const const_buffer json
+	{
+		entry.compressed?
+			zstd::decompress(buf, string_view{*content}):
+			const_buffer{string_view{*content}}
+	};
+
+	const_buffer remain
+	{
+		json
+	};
+
+	while(!empty(remain))
+	{
+		const const_buffer chunk
+		{
+			ircd::data(remain), std::min(size(remain), size(response.buf))
+		};
+
+		const auto wrote
+		{
+			sync::flush(data, response, chunk)
+		};
+
+		if(unlikely(empty(wrote)))
+			break;
+
+		consume(remain, size(wrote));
+	}
+
+	++hit;
+	log::debug
+	{
+		log, "request %s snapshot @%lu gap:%lu bytes:%zu stored:%zu",
+		loghead(data),
+		seq,
+		data.range.second - seq,
+		size(json),
+		content->size(),
+	};
+
+	return true;
+}
+
+void
+ircd::m::sync::snapshot::store(data &data,
+                               const string_view &key,
+                               const std::string &content)
+try
+{
+	if(content.empty() || content.size() > size_t(entry_max))
+		return;
+
+	entry entry;
+	entry.seq = data.range.second;
+	entry.size = content.size();
+	entry.compressed = zstd::available();
+	entry.made = now<steady_point>();
+	entry.used = entry.made;
+	entry.content = std::make_shared<const std::string>
+	(
+		entry.compressed?
+			util::string(zstd::bound(content.size()), [&content]
+			(const mutable_buffer &buf)
+			{
+				return string_view
+				{
+					zstd::compress(buf, string_view{content}, int(level))
+				};
+			}):
+			content
+	);
+
+	const size_t stored
+	{
+		entry.content->size()
+	};
+
+	auto it
+	{
+		cache.lower_bound(key)
+	};
+
+	if(it != end(cache) && it->first == key)
+	{
+		assert(cache_bytes >= it->second.content->size());
+		cache_bytes -= it->second.content->size();
+		it->second = std::move(entry);
+	}
+	else cache.emplace_hint(it, key, std::move(entry));
+
+	cache_bytes += stored;
+	evict(budget);
+	bytes = cache_bytes;
+
+	log::debug
+	{
+		log, "request %s snapshot stored @%lu bytes:%zu stored:%zu total:%zu",
+		loghead(data),
+		data.range.second,
+		content.size(),
+		stored,
+		cache_bytes,
+	};
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "request %s snapshot :%s",
+		loghead(data),
+		e.what(),
+	};
+}
+
+/// Least recently used entries are dropped until the total is in budget.
+void
+ircd::m::sync::snapshot::evict(const size_t &budget)
+{
+	while(cache_bytes > budget && !cache.empty())
+	{
+		const auto it
+		{
+			std::min_element(begin(cache), end(cache), []
+			(const auto &a, const auto &b)
+			{
+				return a.second.used < b.second.used;
+			})
+		};
+
+		assert(cache_bytes >= it->second.content->size());
+		cache_bytes -= it->second.content->size();
+		cache.erase(it);
+	}
+}
+
+//
+// snapshot::capture
+//
+
+ircd::m::sync::snapshot::capture::~capture()
+noexcept
+{
+	abandon();
+}
+
+bool
+ircd::m::sync::snapshot::capture::append(const const_buffer &buf)
+{
+	if(!active)
+		return false;
+
+	const bool within_entry
+	{
+		this->buf.size() + size(buf) <= size_t(entry_max)
+	};
+
+	const bool within_budget
+	{
+		capture_bytes + size(buf) <= size_t(budget)
+	};
+
+	if(!within_entry || !within_budget)
+	{
+		abandon();
+		return false;
+	}
+
+	this->buf.append(ircd::data(buf), size(buf));
+	capture_bytes += size(buf);
+	return true;
+}
+
+void
+ircd::m::sync::snapshot::capture::abandon()
+noexcept
+{
+	assert(capture_bytes >= buf.size());
+	capture_bytes -= buf.size();
+	std::string{}.swap(buf);
+	active = false;
+}
+
+std::string
+ircd::m::sync::snapshot::make_key(const data &data)
+{
+	assert(data.args);
+	return fmt::snstringf
+	{
+		1024 + size(data.args->filter_id), "%s|%s|%s",
+		string_view{data.user.user_id},
+		string_view{data.device_id},
+		data.args->filter_id,
+	};
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // longpoll
@@ -513,17 +934,95 @@ namespace ircd::m::sync
 
 namespace ircd::m::sync::longpoll
 {
-	static bool polled(data &, const args &);
-	static int poll(data &);
+	struct shared;
+	struct waiter;
+
+	using index_type = std::multimap<string_view, waiter *>;
+	using waiter_closure = std::function<void (waiter &)>;
+
+	static bool pending(const vm::eval &) noexcept;
+	static event::idx horizon();
+	static void reindex(const m::event &);
+	static bool polled(data &, const args &, const m::event::fetch &, const mutable_buffer &);
+	static int poll(data &, waiter &, const mutable_buffer &);
+	static void dispatch(const m::event &, const waiter_closure &);
 	static void handle_notify(const m::event &, m::vm::eval &);
 	static void fini() noexcept;
 
+	extern conf::item<bool> index_enable;
 	extern m::hookfn<m::vm::eval &> notified;
-	extern ctx::dock dock;
+	extern index_type index;
+	extern event::idx horizon_value;
+	extern event::idx horizon_retired;
 }
 
-decltype(ircd::m::sync::longpoll::dock)
-ircd::m::sync::longpoll::dock;
+/// An event dispatched to one or more longpolling clients. The event is
+/// fetched once by the first waiter to need it and then shared read-only
+/// by all of the others.
+struct ircd::m::sync::longpoll::shared
+{
+	event::idx event_idx {0};
+	ctx::mutex mutex;
+	bool fetched {false};
+	m::event::fetch _event;
+
+	const m::event::fetch &get();
+
+	shared(const event::idx &event_idx)
+	:event_idx{event_idx}
+	{}
+};
+
+/// A longpolling client registered in the dispatch index under every room_id
+/// and user_id for which it may have interest. The notify hook delivers
+/// events into the queue of only those waiters found under the event's keys.
+struct ircd::m::sync::longpoll::waiter
+:instance_list<waiter>
+{
+	using queue_type = std::map<event::idx, std::shared_ptr<shared>>;
+
+	std::deque<std::string> keys;
+	std::vector<index_type::iterator> its;
+	queue_type queue;
+	event::idx entered {0};
+	ctx::dock dock;
+
+	bool add(const string_view &key);
+
+	waiter(const data &);
+	waiter(waiter &&) = delete;
+	waiter(const waiter &) = delete;
+	~waiter() noexcept;
+};
+
+template<>
+decltype(ircd::util::instance_list<ircd::m::sync::longpoll::waiter>::allocator)
+ircd::util::instance_list<ircd::m::sync::longpoll::waiter>::allocator
+{};
+
+template<>
+decltype(ircd::util::instance_list<ircd::m::sync::longpoll::waiter>::list)
+ircd::util::instance_list<ircd::m::sync::longpoll::waiter>::list
+{
+	allocator
+};
+
+decltype(ircd::m::sync::longpoll::index)
+ircd::m::sync::longpoll::index;
+
+decltype(ircd::m::sync::longpoll::horizon_value)
+ircd::m::sync::longpoll::horizon_value;
+
+decltype(ircd::m::sync::longpoll::horizon_retired)
+ircd::m::sync::longpoll::horizon_retired;
+
+decltype(ircd::m::sync::longpoll::index_enable)
+ircd::m::sync::longpoll::index_enable
+{
+	{ "name",     "ircd.client.sync.longpoll.index.enable" },
+	{ "default",  true                                     },
+	{ "help",     "Wake only longpollers indexed by the event's room or user." },
+};
 
 decltype(ircd::m::sync::longpoll::notified)
 ircd::m::sync::longpoll::notified
@@ -538,14 +1037,15 @@ void
 ircd::m::sync::longpoll::fini()
 noexcept
 {
-	if(!dock.empty())
+	if(!waiter::list.empty())
 		log::warning
 		{
 			log, "Interrupting %zu longpolling clients...",
-			dock.size(),
+			waiter::list.size(),
 		};
 
-	interrupt(dock);
+	for(auto *const &waiter : waiter::list)
+		interrupt(waiter->dock);
 }
 
 void
@@ -553,11 +1053,36 @@ ircd::m::sync::longpoll::handle_notify(const m::event &event,
                                        m::vm::eval &eval)
 try
 {
+	// Another eval reached the notify phase; the horizon may have advanced.
+	horizon_retired = 0;
+
 	assert(eval.opts);
 	if(!eval.opts->notify_clients)
 		return;
 
-	dock.notify_all();
+	const auto &event_idx
+	{
+		vm::sequence::get(eval)
+	};
+
+	if(!event_idx || waiter::list.empty())
+		return;
+
+	if(index_enable && json::get<"type"_>(event) == "m.room.member")
+		reindex(event);
+
+	std::shared_ptr<shared> ptr;
+	dispatch(event, [&ptr, &event_idx]
+	(waiter &waiter)
+	{
+		if(!ptr)
+			ptr = std::make_shared<shared>(event_idx);
+
+		if(!waiter.queue.emplace(event_idx, ptr).second)
+			return;
+
+		waiter.dock.notify();
+	});
 }
 catch(const ctx::interrupted &)
 {
@@ -573,14 +1098,133 @@ catch(const std::exception &e)
 	};
 }
 
+/// Find the waiters which may have interest in the event. The keys here
+/// mirror the conditions of the linear handlers; an event which cannot be
+/// attributed to any room or user is delivered to everyone.
+void
+ircd::m::sync::longpoll::dispatch(const m::event &event,
+                                  const waiter_closure &closure)
+{
+	const auto each_key{[&closure]
+	(const string_view &key)
+	{
+		auto pit
+		{
+			index.equal_range(key)
+		};
+
+		for(; pit.first != pit.second; ++pit.first)
+			closure(*pit.first->second);
+	}};
+
+	const auto each_room{[&each_key]
+	(const m::user::id &user_id)
+	{
+		each_key(user_id);
+		m::user::rooms(user_id).for_each("join", [&each_key]
+		(const m::room &room, const string_view &membership)
+		{
+			each_key(room.room_id);
+			return true;
+		});
+	}};
+
+	const auto &room_id
+	{
+		json::get<"room_id"_>(event)
+	};
+
+	const auto &type
+	{
+		json::get<"type"_>(event)
+	};
+
+	if(!index_enable || !room_id)
+	{
+		for(auto *const &waiter : waiter::list)
+			closure(*waiter);
+
+		return;
+	}
+
+	each_key(room_id);
+
+	if(type == "m.room.member" && valid(id::USER, json::get<"state_key"_>(event)))
+		each_key(json::get<"state_key"_>(event));
+
+	else if(type == "m.room.create" && valid(id::USER, json::get<"sender"_>(event)))
+		each_key(json::get<"sender"_>(event));
+
+	else if(type == "ircd.read" && valid(id::ROOM, json::get<"state_key"_>(event)))
+		each_key(json::get<"state_key"_>(event));
+
+	else if(type == "ircd.typing")
+		each_key(json::string(json::get<"content"_>(event).get("room_id")));
+
+	else if(type == "ircd.presence" && my_host(json::get<"origin"_>(event)))
+	{
+		const json::string &user_id
+		{
+			json::get<"content"_>(event).get("user_id")
+		};
+
+		if(valid(id::USER, user_id))
+			each_room(user_id);
+	}
+
+	else if(startswith(type, "ircd.device") || startswith(type, "ircd.keys.signatures"))
+	{
+		if(valid(id::USER, json::get<"sender"_>(event)))
+			each_room(json::get<"sender"_>(event));
+	}
+}
+
+/// Waiters indexed under the user who joined or was invited to a room are
+/// indexed under that room too, so its events reach them for the remainder
+/// of their poll.
+void
+ircd::m::sync::longpoll::reindex(const m::event &event)
+{
+	const auto &user_id
+	{
+		json::get<"state_key"_>(event)
+	};
+
+	if(!valid(id::USER, user_id))
+		return;
+
+	if(!m::membership(event, vector_view<const string_view>{"join", "invite"}))
+		return;
+
+	// Entries added under the room_id never fall within the user_id's range
+	// so the iteration is not disturbed.
+	auto pit
+	{
+		index.equal_range(user_id)
+	};
+
+	for(; pit.first != pit.second; ++pit.first)
+		pit.first->second->add(json::get<"room_id"_>(event));
+}
+
 /// Longpolling blocks the client's request until a relevant event is processed
 /// by the m::vm. If no event is processed by a timeout this returns false.
 bool
 ircd::m::sync::longpoll_handle(data &data)
 try
 {
+	const unique_buffer<mutable_buffer> scratch
+	{
+		128_KiB
+	};
+
+	longpoll::waiter waiter
+	{
+		data
+	};
+
 	int ret;
-	while((ret = longpoll::poll(data)) == -1)
+	while((ret = longpoll::poll(data, waiter, scratch)) == -1)
 	{
 		// When the client explicitly gives a next_batch token we have to
 		// adhere to it and return an empty response before going past their
@@ -590,7 +1234,6 @@ try
 			if(data.range.first >= data.range.second || data.range.second >= vm::sequence::retired)
 				return false;
 
-		data.range.second = std::min(data.range.second + 1, vm::sequence::retired + 1);
 		assert(data.range.second <= vm::sequence::retired + 1);
 		assert(data.range.first <= data.range.second);
 	}
@@ -620,16 +1263,17 @@ catch(const std::exception &e)
 	throw;
 }
 
-/// When the vm's sequence number is incremented our dock is notified and the
-/// event at that next sequence number is fetched. That event gets proffered
-/// around the linear sync handlers for whether it's relevant to the user
-/// making the request on this stack.
+/// When the vm notifies an event of interest to this client it is queued to
+/// our waiter and we are woken. That event gets proffered around the linear
+/// sync handlers for whether it's relevant to the user making the request on
+/// this stack. Events which retired before the waiter entered the index are
+/// first fetched and proffered directly.
 ///
 /// If relevant, we respond immediately with that one event and finish the
 /// request right there, providing them the next since token of one-past the
 /// event_idx that was just synchronized.
 ///
-/// If not relevant, we send nothing and continue checking events that come
+/// If not relevant, we send nothing and continue waiting for events that come
 /// through until the timeout. This will be an empty response providing the
 /// client with the next since token of one past where we left off (vm's
 /// current sequence number) to start the next /sync.
@@ -643,17 +1287,45 @@ catch(const std::exception &e)
 /// has been sent to the client yet here either.
 ///
 int
-ircd::m::sync::longpoll::poll(data &data)
+ircd::m::sync::longpoll::poll(data &data,
+                              waiter &waiter,
+                              const mutable_buffer &scratch)
 {
-	const auto ready{[&data]() noexcept
+	assert(data.args);
+	const auto &args
+	{
+		*data.args
+	};
+
+	// Catch up with anything which retired while the waiter was being
+	// constructed; those events were notified before we were indexed.
+	if(data.range.second <= waiter.entered)
 	{
-		assert(data.range.second <= m::vm::sequence::retired + 1);
-		return data.range.second <= m::vm::sequence::retired;
+		const m::event::fetch event
+		{
+			std::nothrow, data.range.second
+		};
+
+		if(event.valid && polled(data, args, event, scratch))
+			return true;
+
+		data.range.second++;
+		return -1;
+	}
+
+	const auto queued{[&waiter]() noexcept
+	{
+		return !waiter.queue.empty();
 	}};
 
-	assert(data.args);
-	if(!dock.wait_until(data.args->timesout, ready))
+	// Any event not delivered to our queue was of no interest to this client
+	// so on timeout the range advances to the point where all lower events
+	// have been dispatched.
+	if(!waiter.dock.wait_until(args.timesout, queued))
+	{
+		data.range.second = std::max(data.range.second, horizon());
 		return false;
+	}
 
 	// Check if client went away while we were sleeping,
 	// if so, just returning true is the easiest way out w/o throwing
@@ -666,12 +1338,59 @@ ircd::m::sync::longpoll::poll(data &data)
 	const auto &client(*data.client);
 	net::check(*client.sock);
 
-	// Keep in mind if the handler returns true that means
-	// it made a hit and we can return true to exit longpoll
-	// and end the request cleanly.
-	if(polled(data, *data.args))
+	const auto it
+	{
+		begin(waiter.queue)
+	};
+
+	const auto event_idx
+	{
+		it->first
+	};
+
+	if(event_idx < data.range.second)
+	{
+		waiter.queue.erase(it);
+		return -1;
+	}
+
+	// Events are notified by their evals independently, so a lower event may
+	// still be in flight; it must reach us first to preserve order. This
+	// also holds back events from nested evals until their stack retires.
+	const auto settled{[&event_idx]
+	{
+		return event_idx <= vm::sequence::retired && horizon() >= event_idx;
+	}};
+
+	// On timeout the queued event remains undelivered, so the range can only
+	// advance up to it.
+	if(!settled())
+		if(!vm::sequence::dock.wait_until(args.timesout, settled))
+		{
+			data.range.second = std::max(data.range.second, std::min(event_idx, horizon()));
+			return false;
+		}
+
+	// Lower events may have been queued while we waited.
+	if(begin(waiter.queue)->first != event_idx)
+		return -1;
+
+	const std::shared_ptr<shared> ptr
+	{
+		std::move(it->second)
+	};
+
+	waiter.queue.erase(it);
+	const auto &event
+	{
+		ptr->get()
+	};
+
+	data.range.second = event_idx;
+	if(event.valid && polled(data, args, event, scratch))
 		return true;
 
+	data.range.second = std::min(event_idx + 1, vm::sequence::retired + 1);
 	return -1;
 }
 
@@ -680,7 +1399,9 @@ ircd::m::sync::longpoll::poll(data &data)
 /// that starts at the `vm::sequence::retired` event_idx
 bool
 ircd::m::sync::longpoll::polled(data &data,
-                                const args &args)
+                                const args &args,
+                                const m::event::fetch &event,
+                                const mutable_buffer &scratch)
 {
 	// Increment one past-the-end.
 	const scope_restore range
@@ -688,15 +1409,9 @@ ircd::m::sync::longpoll::polled(data &data,
 		data.range.second, data.range.second + 1
 	};
 
+	assert(event.valid);
+	assert(event.event_idx == data.range.second - 1);
 	assert(data.range.second - 1 <= m::vm::sequence::retired);
-	const m::event::fetch event
-	{
-		std::nothrow, data.range.second - 1
-	};
-
-	if(!event.valid)
-		return false;
-
 	const scope_restore their_event
 	{
 		data.event, &event
@@ -708,11 +1423,6 @@ ircd::m::sync::longpoll::polled(data &data,
 		data.event_idx, event.event_idx
 	};
 
-	const unique_buffer<mutable_buffer> scratch
-	{
-		128_KiB
-	};
-
 	const size_t consumed
 	{
 		linear_proffer_event(data, scratch)
@@ -782,6 +1492,119 @@ ircd::m::sync::longpoll::polled(data &data,
 	return true;
 }
 
+/// The lowest event_idx which may not have been dispatched yet. Events are
+/// retired in order but their evals reach the notify phase independently.
+/// The result is cached until either the retired sequence moves or another
+/// eval passes through the notify hook.
+ircd::m::event::idx
+ircd::m::sync::longpoll::horizon()
+{
+	if(likely(horizon_retired && horizon_retired == vm::sequence::retired))
+		return horizon_value;
+
+	event::idx ret
+	{
+		vm::sequence::retired + 1
+	};
+
+	vm::eval::for_each([&ret]
+	(vm::eval &eval)
+	{
+		if(pending(eval))
+			ret = std::min(ret, vm::sequence::get(eval));
+
+		return true;
+	});
+
+	horizon_retired = vm::sequence::retired;
+	horizon_value = ret;
+	return ret;
+}
+
+/// An eval which has retired its sequence but has not yet reached the
+/// notify phase.
+bool
+ircd::m::sync::longpoll::pending(const vm::eval &eval)
+noexcept
+{
+	const auto &sequence
+	{
+		vm::sequence::get(eval)
+	};
+
+	return sequence
+	&& sequence <= vm::sequence::retired
+	&& eval.phase < vm::phase::NOTIFY;
+}
+
+//
+// longpoll::waiter
+//
+
+ircd::m::sync::longpoll::waiter::waiter(const data &data)
+{
+	keys.emplace_back(data.user.user_id);
+	keys.emplace_back(data.user_room.room_id);
+	for(const auto &membership : {"join"_sv, "invite"_sv})
+		data.user_rooms.for_each(membership, [this]
+		(const m::room &room, const string_view &)
+		{
+			keys.emplace_back(room.room_id);
+			return true;
+		});
+
+	// The index refers to the storage of the keys; the deque never moves
+	// them as more are added.
+	its.reserve(keys.size());
+	for(const auto &key : keys)
+		its.emplace_back(index.emplace(key, this));
+
+	entered = vm::sequence::retired;
+}
+
+bool
+ircd::m::sync::longpoll::waiter::add(const string_view &key)
+{
+	if(std::find(begin(keys), end(keys), key) != end(keys))
+		return false;
+
+	const auto &stored
+	{
+		keys.emplace_back(key)
+	};
+
+	its.emplace_back(index.emplace(stored, this));
+	return true;
+}
+
+ircd::m::sync::longpoll::waiter::~waiter()
+noexcept
+{
+	for(const auto &it : its)
+		index.erase(it);
+}
+
+//
+// longpoll::shared
+//
+
+const ircd::m::event::fetch &
+ircd::m::sync::longpoll::shared::get()
+{
+	const std::lock_guard lock
+	{
+		mutex
+	};
+
+	if(!fetched)
+	{
+		seek(std::nothrow, _event, event_idx);
+		fetched = true;
+	}
+
+	return _event;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // linear
@@ -10,9 +10,14 @@
 
 namespace ircd::m::sync
 {
+	struct rooms_fragment;
+
 	static bool should_ignore(const data &);
 
 	static bool _rooms_polylog_room(data &, const m::room &);
+	static bool _rooms_polylog_fragment(data &, rooms_fragment &, json::stack::object &, ctx::mutex &, const string_view &room_id);
+	static bool _rooms_polylog_concurrent(data &, json::stack::object &, const size_t &fanout);
+	static size_t _rooms_polylog_concurrent_fanout();
 	static bool _rooms_polylog_each(data &, const m::room &, const string_view &, int64_t &, bool &);
 	static bool _rooms_polylog(data &, const string_view &membership, int64_t &phase);
 	static bool rooms_polylog(data &);
@@ -24,9 +29,28 @@ namespace ircd::m::sync
 	extern conf::item<bool> rooms_polylog_leave;
 	extern conf::item<bool> rooms_polylog_join;
 	extern conf::item<bool> rooms_polylog_ban;
+	extern conf::item<bool> rooms_polylog_concurrent_enable;
+	extern conf::item<size_t> rooms_polylog_concurrent_fanout;
+	extern conf::item<size_t> rooms_polylog_concurrent_reserve;
+	extern conf::item<size_t> rooms_polylog_concurrent_buffer_size;
+	extern conf::item<size_t> rooms_polylog_concurrent_pool_max;
 	extern item rooms;
+
+	// Sum of the fan-out of all concurrent polylogs in progress.
+	static size_t rooms_polylog_concurrent_inflight;
 }
 
+/// Rendering state for rooms dispatched to the sync pool. Each slot renders
+/// one room at a time into its own json::stack; the sync::data is constructed
+/// once for the slot and reused for each of its rooms.
+struct ircd::m::sync::rooms_fragment
+{
+	std::unique_ptr<sync::data> data;
+	unique_buffer<mutable_buffer> buf;
+	std::string out;
+	bool busy {false};
+};
+
 ircd::mapi::header
 IRCD_MODULE
 {
@@ -71,6 +95,45 @@ ircd::m::sync::rooms_polylog_invite
 	{ "default",  true                                      },
 };
 
+decltype(ircd::m::sync::rooms_polylog_concurrent_enable)
+ircd::m::sync::rooms_polylog_concurrent_enable
+{
+	{ "name",     "ircd.m.sync.rooms.polylog.concurrent.enable" },
+	{ "default",  true                                          },
+	{ "help",     "Render rooms of a non-phased polylog concurrently on the sync pool." },
+};
+
+decltype(ircd::m::sync::rooms_polylog_concurrent_fanout)
+ircd::m::sync::rooms_polylog_concurrent_fanout
+{
+	{ "name",     "ircd.m.sync.rooms.polylog.concurrent.fanout" },
+	{ "default",  16L                                           },
+	{ "help",     "Maximum rooms rendered concurrently for one request." },
+};
+
+decltype(ircd::m::sync::rooms_polylog_concurrent_reserve)
+ircd::m::sync::rooms_polylog_concurrent_reserve
+{
+	{ "name",     "ircd.m.sync.rooms.polylog.concurrent.reserve" },
+	{ "default",  64L                                            },
+	{ "help",     "Sync pool contexts kept available beyond those rendering rooms." },
+};
+
+decltype(ircd::m::sync::rooms_polylog_concurrent_buffer_size)
+ircd::m::sync::rooms_polylog_concurrent_buffer_size
+{
+	{ "name",     "ircd.m.sync.rooms.polylog.concurrent.buffer_size" },
+	{ "default",  long(64_KiB)                                       },
+};
+
+decltype(ircd::m::sync::rooms_polylog_concurrent_pool_max)
+ircd::m::sync::rooms_polylog_concurrent_pool_max
+{
+	{ "name",     "ircd.m.sync.rooms.polylog.concurrent.pool_max" },
+	{ "default",  256L                                            },
+	{ "help",     "Sync pool size beyond which rooms are rendered sequentially." },
+};
+
 bool
 ircd::m::sync::rooms_linear(data &data)
 {
@@ -225,6 +288,10 @@ ircd::m::sync::_rooms_polylog(data &data,
 		*data.out, membership
 	};
 
+	if(!data.phased && !data.prefetch && rooms_polylog_concurrent_enable)
+		if(const auto fanout{_rooms_polylog_concurrent_fanout()}; fanout)
+			return _rooms_polylog_concurrent(data, object, fanout);
+
 	bool ret{false};
 	const bool done
 	{
@@ -238,6 +305,198 @@ ircd::m::sync::_rooms_polylog(data &data,
 	return ret;
 }
 
+/// The fan-out available to a new concurrent polylog. The pool only grows
+/// and its contexts persist, so the total it is grown to is bounded; when
+/// the bound is reached this returns zero and the rooms are rendered in
+/// sequence instead.
+size_t
+ircd::m::sync::_rooms_polylog_concurrent_fanout()
+{
+	const size_t used
+	{
+		rooms_polylog_concurrent_inflight + size_t(rooms_polylog_concurrent_reserve)
+	};
+
+	const size_t avail
+	{
+		size_t(rooms_polylog_concurrent_pool_max) > used?
+			size_t(rooms_polylog_concurrent_pool_max) - used:
+			0UL
+	};
+
+	return std::min(size_t(rooms_polylog_concurrent_fanout), avail);
+}
+
+/// Rooms are rendered as independent fragments on the sync pool so their
+/// database reads overlap. Each fragment is spliced into the membership
+/// object as soon as it completes; the order of rooms in the output is thus
+/// the order of completion rather than of the user's room list.
+bool
+ircd::m::sync::_rooms_polylog_concurrent(data &data,
+                                         json::stack::object &object,
+                                         const size_t &fanout)
+{
+	assert(fanout > 0);
+
+	// Items for a room may themselves dispatch to the sync pool; contexts
+	// are reserved so those are never starved by the rooms awaiting them.
+	rooms_polylog_concurrent_inflight += fanout;
+	const unwind inflight{[&fanout]
+	{
+		assert(rooms_polylog_concurrent_inflight >= fanout);
+		rooms_polylog_concurrent_inflight -= fanout;
+	}};
+
+	sync::pool.min(rooms_polylog_concurrent_inflight + size_t(rooms_polylog_concurrent_reserve));
+
+	bool ret{false};
+	ctx::mutex mutex;
+	std::vector<rooms_fragment> fragments(fanout);
+	ctx::concurrent<std::string> concurrent
+	{
+		sync::pool, [&data, &ret, &mutex, &object, &fragments]
+		(const std::string &room_id)
+		{
+			const auto it
+			{
+				std::find_if(begin(fragments), end(fragments), []
+				(const auto &fragment)
+				{
+					return !fragment.busy;
+				})
+			};
+
+			assert(it != end(fragments));
+			auto &fragment(*it);
+			const scope_restore busy
+			{
+				fragment.busy, true
+			};
+
+			if(_rooms_polylog_fragment(data, fragment, object, mutex, room_id))
+				ret = true;
+		}
+	};
+
+	data.user_rooms.for_each(data.membership, [&concurrent, &fanout]
+	(const m::room &room, const string_view &membership)
+	{
+		concurrent.d.wait([&concurrent, &fanout]
+		{
+			return concurrent.snd - concurrent.fin < fanout;
+		});
+
+		concurrent(std::string(room.room_id));
+		return true;
+	});
+
+	const ctx::uninterruptible ui;
+	concurrent.wait();
+	if(concurrent.eptr)
+		std::rethrow_exception(concurrent.eptr);
+
+	return ret;
+}
+
+bool
+ircd::m::sync::_rooms_polylog_fragment(data &data,
+                                       rooms_fragment &fragment,
+                                       json::stack::object &object,
+                                       ctx::mutex &mutex,
+                                       const string_view &room_id)
+{
+	if(!fragment.data)
+	{
+		fragment.data = std::make_unique<sync::data>
+		(
+			data.user,
+			data.range,
+			data.client,
+			nullptr,
+			data.stats,
+			data.args,
+			data.device_id
+		);
+
+		fragment.buf = unique_buffer<mutable_buffer>
+		{
+			size_t(rooms_polylog_concurrent_buffer_size)
+		};
+	}
+
+	auto &fdata(*fragment.data);
+	fdata.membership = data.membership;
+	fragment.out.clear();
+
+	// The fragment is accumulated whole so it can be spliced atomically.
+	json::stack out
+	{
+		fragment.buf, [&fragment](const const_buffer &buf)
+		{
+			fragment.out.append(ircd::data(buf), ircd::size(buf));
+			return buf;
+		}
+	};
+
+	const scope_restore their_out
+	{
+		fdata.out, &out
+	};
+
+	bool ret{false};
+	{
+		const m::room room
+		{
+			room_id
+		};
+
+		json::stack::object top
+		{
+			out
+		};
+
+		ret = _rooms_polylog_room(fdata, room);
+	}
+
+	out.flush(true);
+	if(unlikely(out.failed()))
+	{
+		log::error
+		{
+			log, "polylog %s failed to render room %s (%zu bytes)",
+			loghead(data),
+			room_id,
+			fragment.out.size(),
+		};
+
+		return false;
+	}
+
+	if(!ret)
+		return false;
+
+	const json::object members
+	{
+		fragment.out
+	};
+
+	const std::lock_guard lock
+	{
+		mutex
+	};
+
+	for(const auto &member : members)
+		json::stack::member
+		{
+			object, member
+		};
+
+	// Nothing already spliced can be rolled back; release the enclosing
+	// checkpoints so the stack can flush this room to the client.
+	data.out->invalidate_checkpoints();
+	return true;
+}
+
 bool
 ircd::m::sync::_rooms_polylog_each(data &data,
                                    const m::room &room,
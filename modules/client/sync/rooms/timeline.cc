@@ -341,11 +341,8 @@ ircd::m::sync::_room_timeline_polylog_events(data &data,
 	};
 
 	// messages seeks to the newest event, but the client wants the oldest
-	// event first so we seek down first and then iterate back up. Due to
-	// an issue with rocksdb's prefix-iteration this iterator becomes
-	// toxic as soon as it becomes invalid. As a result we have to copy the
-	// event_idx on the way down in case of renewing the iterator for the
-	// way back. This is not a big deal but rocksdb should fix their shit.
+	// event first so we collect the event_idx on the way down and then
+	// fetch the events all at once on the way back up.
 	m::event::idx batch_idx {data.room_head};
 	m::room::events it
 	{
@@ -359,7 +356,10 @@ ircd::m::sync::_room_timeline_polylog_events(data &data,
 			ssize_t(limit_default)
 	};
 
-	ssize_t i(0), prefetched(0);
+	std::vector<m::event::idx> idx;
+	idx.reserve(std::max(limit + 1, 0L));
+
+	ssize_t i(0);
 	for(; it && i <= limit; --it)
 	{
 		batch_idx = it.event_idx();
@@ -372,30 +372,18 @@ ircd::m::sync::_room_timeline_polylog_events(data &data,
 			break;
 		}
 
-		prefetched += limit > 1 && m::prefetch(batch_idx);
+		idx.emplace_back(batch_idx);
 		++i;
 	}
 
-	if(i > 1 && !it)
-		it.seek(batch_idx);
-
-	if(i > 1 && it)
-		--i, ++it;
+	// The oldest event is the prev_batch rather than part of the timeline.
+	if(!idx.empty() && idx.back() == batch_idx)
+		idx.pop_back();
 
-	m::event::fetch event;
-	for(; i >= 0 && it; --i, ++it)
+	std::reverse(begin(idx), end(idx));
+	seek(std::nothrow, idx, [&data, &array, &ret]
+	(const auto &event_idx, const m::event &event)
 	{
-		const auto &event_idx
-		{
-			it.event_idx()
-		};
-
-		if(event_idx == batch_idx)
-			continue;
-
-		if(!seek(std::nothrow, event, event_idx))
-			continue;
-
 		ret |= m::event::append
 		{
 			array, event,
@@ -405,11 +393,13 @@ ircd::m::sync::_room_timeline_polylog_events(data &data,
 				.user_id = data.user.user_id,
 				.user_room_id = data.user_room.room_id,
 				.room_depth = data.room_depth,
+				.bundle_thread = true,
 			}
 		};
-	}
 
-	assert(i >= -1);
+		return true;
+	});
+
 	batch_idx &= boolmask<event::idx>(ret);
 	return m::event_id(std::nothrow, batch_idx);
 }
@@ -10,9 +10,6 @@
 
 namespace ircd::m::sync
 {
-	static long _notification_count(const room &, const event::idx &a, const event::idx &b);
-	static long _highlight_count(const room &, const user &u, const event::idx &a, const event::idx &b);
-	static event::idx _read_marker(data &, const room &);
 	static bool room_unread_notifications_polylog(data &);
 	static bool room_unread_notifications_linear(data &);
 
@@ -106,12 +103,11 @@ ircd::m::sync::room_unread_notifications_linear(data &data)
 			if(json::get<"depth"_>(*data.event) + room::events::viewport_size < data.room_depth)
 				return false;
 
-	const event::idx marker_idx
-	{
-		!is_self_read?
-			_read_marker(data, room):
-			0UL
-	};
+	// The counters for a self-read are reset by an effect hook which has yet
+	// to run for this event; they are zero by definition.
+	user::unread::counts counts;
+	if(!is_self_read)
+		counts = user::unread{data.user}.get(room.room_id);
 
 	json::stack::object rooms
 	{
@@ -133,23 +129,11 @@ ircd::m::sync::room_unread_notifications_linear(data &data)
 		*data.out, "unread_notifications"
 	};
 
-	const event::idx upper_bound
-	{
-		std::max(data.range.second, data.event_idx)
-	};
-
-	const auto notification_count
-	{
-		marker_idx?
-			_notification_count(room, marker_idx, upper_bound):
-			0L
-	};
-
 	json::stack::member
 	{
 		*data.out, "notification_count", json::value
 		{
-			notification_count
+			long(counts.notification)
 		}
 	};
 
@@ -157,9 +141,7 @@ ircd::m::sync::room_unread_notifications_linear(data &data)
 	{
 		*data.out, "highlight_count", json::value
 		{
-			notification_count?
-				_highlight_count(room, data.user, marker_idx, upper_bound):
-				0L
+			long(counts.highlight)
 		}
 	};
 
@@ -178,31 +160,16 @@ ircd::m::sync::room_unread_notifications_polylog(data &data)
 		*data.room
 	};
 
-	const event::idx marker_idx
-	{
-		_read_marker(data, room)
-	};
-
-	if(!marker_idx)
-		return false;
-
-	const bool initial_phase
-	{
-		data.phased && data.range.first == 0
-	};
-
-	const auto notification_count
+	const auto counts
 	{
-		!initial_phase?
-			_notification_count(room, marker_idx, data.range.second):
-			0L
+		user::unread{data.user}.get(room.room_id)
 	};
 
 	json::stack::member
 	{
 		*data.out, "notification_count", json::value
 		{
-			notification_count
+			long(counts.notification)
 		}
 	};
 
@@ -210,94 +177,9 @@ ircd::m::sync::room_unread_notifications_polylog(data &data)
 	{
 		*data.out, "highlight_count", json::value
 		{
-			notification_count?
-				_highlight_count(room, data.user, marker_idx, data.range.second):
-				0L
+			long(counts.highlight)
 		}
 	};
 
 	return true;
 }
-
-ircd::m::event::idx
-ircd::m::sync::_read_marker(data &data,
-                            const room &room)
-try
-{
-	const m::user::room_account_data account_data
-	{
-		data.user, room
-	};
-
-	m::event::idx ret(0);
-	account_data.get(std::nothrow, "m.fully_read", [&ret]
-	(const string_view &, const json::object &content)
-	{
-		ret = index(std::nothrow, event::id
-		{
-			json::string
-			{
-				content["event_id"]
-			}
-		});
-	});
-
-	return ret;
-}
-catch(const m::INVALID_MXID &e)
-{
-	log::derror
-	{
-		log, "account_data for %s in %s :invalid m.fully_read marker :%s",
-		string_view{data.user.user_id},
-		string_view{room.room_id},
-		e.what(),
-	};
-
-	return 0;
-}
-
-long
-ircd::m::sync::_notification_count(const room &room,
-                                   const event::idx &a,
-                                   const event::idx &b)
-{
-	const event::idx_range range
-	{
-		std::minmax(a, b)
-	};
-
-	return room::events::count(room, range);
-}
-
-long
-ircd::m::sync::_highlight_count(const room &room,
-                                const user &user,
-                                const event::idx &a,
-                                const event::idx &b)
-{
-	const event::idx_range range
-	{
-		std::minmax(a, b)
-	};
-
-	const user::notifications notifications
-	{
-		user
-	};
-
-	const user::notifications::opts opts
-	{
-		.from = range.second,
-		.to = range.first,
-		.only = "highlight",
-		.room_id = room.room_id,
-	};
-
-	const auto ret
-	{
-		notifications.count(opts)
-	};
-
-	return ret;
-}
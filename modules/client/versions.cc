@@ -250,4 +250,13 @@ ircd::m::client_versions::append_unstable_features(client &client,
 			true
 		}
 	};
+
+	// Simplified sliding sync as per MSC3575 (MSC4186)
+	json::stack::member
+	{
+		out, "org.matrix.simplified_msc3575", json::value
+		{
+			true
+		}
+	};
 }
@@ -2294,6 +2294,82 @@ console_cmd__aio(opt &out, const string_view &line)
 	return true;
 }
 
+//
+// iou
+//
+
+bool
+console_cmd__iou(opt &out, const string_view &line)
+{
+	if(!fs::support::iou)
+		throw error
+		{
+			"io_uring is not available."
+		};
+
+	const auto &s
+	{
+		fs::iou::stats
+	};
+
+	out << std::setw(18) << std::left << "backend"
+	    << std::setw(9) << std::right << fs::iou::backend()
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "requests"
+	    << std::setw(9) << std::right << s.requests
+	    << "   " << pretty(iec(s.bytes_requests))
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "requests cur"
+	    << std::setw(9) << std::right << (s.cur_reads + s.cur_writes)
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "batches"
+	    << std::setw(9) << std::right << s.batches
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "batches max"
+	    << std::setw(9) << std::right << s.max_batch
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "reads"
+	    << std::setw(9) << std::right << s.reads
+	    << "   " << pretty(iec(s.bytes_read))
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "reads cur"
+	    << std::setw(9) << std::right << s.cur_reads
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "reads max"
+	    << std::setw(9) << std::right << s.max_reads
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "writes"
+	    << std::setw(9) << std::right << s.writes
+	    << "   " << pretty(iec(s.bytes_write))
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "writes cur"
+	    << std::setw(9) << std::right << s.cur_writes
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "writes max"
+	    << std::setw(9) << std::right << s.max_writes
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "errors"
+	    << std::setw(9) << std::right << s.errors
+	    << std::endl;
+
+	out << std::setw(18) << std::left << "cancel"
+	    << std::setw(9) << std::right << s.cancel
+	    << std::endl;
+
+	return true;
+}
+
 //
 // conf
 //
@@ -3782,6 +3858,27 @@ console_cmd__db__io(opt &out, const string_view &line)
 		db::iostats_current()
 	};
 
+	// The backend is selected by ircd.fs.iou.enable and ircd.fs.aio.enable;
+	// toggle those to compare the figures below between backends.
+	const string_view backend
+	{
+		fs::iou::backend()
+	};
+
+	if(backend == "io_uring")
+		out << "backend " << backend
+		    << " reads " << fs::iou::stats.reads
+		    << " writes " << fs::iou::stats.writes
+		    << std::endl;
+	else if(backend == "aio")
+		out << "backend " << backend
+		    << " reads " << fs::aio::stats.reads
+		    << " writes " << fs::aio::stats.writes
+		    << std::endl;
+	else
+		out << "backend " << backend
+		    << std::endl;
+
 	const auto s
 	{
 		db::string(ic)
@@ -4213,15 +4310,30 @@ try
 			db::ticker(cache(column), db::ticker_id("rocksdb.block.cache.data.bytes.insert")),
 		};
 
+		// The compressed tier is internal to the column's cache; its hits
+		// are counted by rocksdb where the version has the ticker.
+		const auto secondary_hits{[&column]
+		() -> uint64_t
+		{
+			try
+			{
+				return db::ticker(cache(column), db::ticker_id("rocksdb.secondary.cache.hits"));
+			}
+			catch(const std::out_of_range &)
+			{
+				return 0;
+			}
+		}};
+
 		const stats compressed
 		{
-			db::count(cache_compressed(column)),
-			db::usage(cache_compressed(column)),
 			0,
-			db::capacity(cache_compressed(column)),
-			db::ticker(cache_compressed(column), db::ticker_id("rocksdb.block.cache.hit")),
 			0,
-			db::ticker(cache_compressed(column), db::ticker_id("rocksdb.block.cache.add")),
+			0,
+			db::secondary_capacity(cache(column)),
+			secondary_hits(),
+			0,
+			0,
 			0
 		};
 
@@ -5107,6 +5219,111 @@ catch(const std::out_of_range &e)
 	return true;
 }
 
+bool
+console_cmd__db__compression(opt &out, const string_view &line)
+try
+{
+	const params param{line, " ",
+	{
+		"dbname", "column"
+	}};
+
+	auto &database
+	{
+		db::database::get(param.at("dbname"))
+	};
+
+	const auto colname
+	{
+		param.at("column", "*"_sv)
+	};
+
+	db::database::sst::info::vector vector
+	{
+		database
+	};
+
+	std::sort(begin(vector), end(vector), []
+	(const auto &a, const auto &b)
+	{
+		return std::tie(a.column, a.level, a.created) < std::tie(b.column, b.level, b.created);
+	});
+
+	const auto ratio{[]
+	(const uint64_t &virt, const uint64_t &phys)
+	{
+		return phys? virt / double(phys): 0.0;
+	}};
+
+	const auto print{[&out, &ratio]
+	(const db::database::sst::info &f)
+	{
+		char pbuf[3][48];
+		out << std::left << std::setfill(' ')
+		    << std::setw(12) << f.name
+		    << "  " << std::setw(3) << std::right << f.level
+		    << "  " << std::setw(20) << std::left << trunc(f.compression, 20)
+		    << "  " << std::setw(10) << std::right << pretty(pbuf[0], iec(f.compression_dict))
+		    << "  " << std::setw(10) << std::right << f.entries
+		    << "  " << std::setw(24) << std::right << pretty(pbuf[1], iec(f.blocks_size))
+		    << "  " << std::setw(24) << std::right << pretty(pbuf[2], iec(f.data_size))
+		    << "  " << std::setw(7) << std::right << std::fixed << std::setprecision(2) << ratio(f.blocks_size, f.data_size)
+		    << "  " << std::setw(20) << std::left << f.column
+		    << std::endl;
+	}};
+
+	out << std::left << std::setfill(' ')
+	    << std::setw(12) << "name"
+	    << "  " << std::setw(3) << "lev"
+	    << "  " << std::setw(20) << "compression"
+	    << std::right
+	    << "  " << std::setw(10) << "dict"
+	    << "  " << std::setw(10) << "entries"
+	    << "  " << std::setw(24) << "raw"
+	    << "  " << std::setw(24) << "compressed"
+	    << "  " << std::setw(7) << "ratio"
+	    << std::left
+	    << "  " << std::setw(20) << "column"
+	    << std::endl;
+
+	db::database::sst::info total;
+	const auto print_total{[&out, &print, &total]
+	{
+		if(!total.entries && total.column.empty())
+			return;
+
+		total.name = "total"s;
+		print(total);
+		out << std::endl;
+		total = db::database::sst::info{};
+	}};
+
+	for(const auto &f : vector)
+	{
+		if(colname != "*" && f.column != colname)
+			continue;
+
+		if(f.column != total.column)
+			print_total();
+
+		print(f);
+		total.column = f.column;
+		total.compression = f.compression;
+		total.compression_dict = std::max(total.compression_dict, f.compression_dict);
+		total.entries += f.entries;
+		total.blocks_size += f.blocks_size;
+		total.data_size += f.data_size;
+	}
+
+	print_total();
+	return true;
+}
+catch(const std::out_of_range &e)
+{
+	out << "No open database by that name" << std::endl;
+	return true;
+}
+
 bool
 console_cmd__db__bytes(opt &out, const string_view &line)
 try
@@ -9948,6 +10165,44 @@ console_cmd__room__head__fetch(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__room__threads__rebuild(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"room_id", "[event_id]"
+	}};
+
+	const auto &room_id
+	{
+		m::room_id(param.at(0))
+	};
+
+	const m::room::threads threads
+	{
+		m::room{room_id}
+	};
+
+	if(param[1])
+	{
+		const auto summary
+		{
+			threads.rebuild(m::index(m::event::id(param[1])))
+		};
+
+		out << "latest " << summary.latest << " count " << summary.count << std::endl;
+		return true;
+	}
+
+	const size_t count
+	{
+		threads.rebuild()
+	};
+
+	out << "done " << count << std::endl;
+	return true;
+}
+
 bool
 console_cmd__room__sounding(opt &out, const string_view &line)
 {
@@ -11217,6 +11472,58 @@ console_cmd__room__state__rebuild(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__room__search__rebuild(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"room_id"
+	}};
+
+	const auto rebuild{[&out](const m::room::id &room_id)
+	{
+		db::txn txn
+		{
+			*m::dbs::events
+		};
+
+		size_t count(0);
+		m::event::fetch event;
+		for(m::room::events it{room_id}; it; --it)
+		{
+			if(!seek(std::nothrow, event, it.event_idx()))
+				continue;
+
+			m::dbs::opts opts;
+			opts.event_idx = it.event_idx();
+			opts.appendix.reset();
+			opts.appendix.set(m::dbs::appendix::ROOM_SEARCH);
+			m::dbs::write(txn, event, opts);
+			++count;
+
+			if(txn.size() < 65536)
+				continue;
+
+			txn();
+			txn.clear();
+		}
+
+		txn();
+		out << room_id << " indexed " << count << " events." << std::endl;
+		return true;
+	}};
+
+	if(param.at("room_id") == "*")
+		return m::rooms::for_each(m::rooms::opts{}, rebuild);
+
+	const auto room_id
+	{
+		m::room_id(param.at("room_id"))
+	};
+
+	return rebuild(room_id);
+}
+
 bool
 console_cmd__room__state__prefetch(opt &out, const string_view &line)
 {
@@ -14847,6 +15154,105 @@ console_cmd__user__notifications(opt &out, const string_view &line)
 	return true;
 }
 
+bool
+console_cmd__user__unread(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"user_id", "room_id"
+	}};
+
+	const m::user::unread unread
+	{
+		m::user::id(param.at("user_id"))
+	};
+
+	const auto show{[&out]
+	(const m::room::id &room_id, const m::user::unread::counts &counts)
+	{
+		out
+		<< std::left << std::setw(48) << room_id << " "
+		<< std::right << std::setw(8) << counts.notification << " "
+		<< std::right << std::setw(8) << counts.highlight
+		<< std::endl;
+	}};
+
+	if(param["room_id"])
+	{
+		const auto room_id
+		{
+			m::room_id(param["room_id"])
+		};
+
+		show(room_id, unread.get(room_id));
+		return true;
+	}
+
+	const m::user::rooms rooms
+	{
+		unread.user
+	};
+
+	rooms.for_each("join", [&unread, &show]
+	(const m::room &room, const string_view &)
+	{
+		show(room.room_id, unread.get(room.room_id));
+	});
+
+	return true;
+}
+
+/// Recount the materialized unread counters from the current read markers.
+/// With `*` for the user_id every local user is rebuilt.
+bool
+console_cmd__user__unread__rebuild(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"user_id", "room_id"
+	}};
+
+	const auto rebuild{[&out, &param]
+	(const m::user &user)
+	{
+		const m::user::unread unread
+		{
+			user
+		};
+
+		if(param["room_id"])
+		{
+			const auto counts
+			{
+				unread.rebuild(m::room_id(param["room_id"]))
+			};
+
+			out
+			<< user.user_id << " "
+			<< counts.notification << " "
+			<< counts.highlight
+			<< std::endl;
+			return true;
+		}
+
+		const auto rooms
+		{
+			unread.rebuild()
+		};
+
+		out << user.user_id << " rebuilt " << rooms << " rooms" << std::endl;
+		return true;
+	}};
+
+	if(param.at("user_id") != "*")
+		return rebuild(m::user::id(param.at("user_id")));
+
+	m::users::opts opts;
+	opts.hostpart = my_host();
+	m::users::for_each(opts, rebuild);
+	return true;
+}
+
 //
 // users
 //
@@ -32,10 +32,16 @@ struct txndata
 	std::string content;
 	string_view txnid;
 	char txnidbuf[64];
+	std::vector<m::event::idx> pdus;
+	std::vector<std::shared_ptr<unit>> edus;
 
-	txndata(std::string content)
+	txndata(std::string content,
+	        std::vector<m::event::idx> pdus,
+	        std::vector<std::shared_ptr<unit>> edus)
 	:content{std::move(content)}
 	,txnid{m::txn::create_id(txnidbuf, this->content)}
+	,pdus{std::move(pdus)}
+	,edus{std::move(edus)}
 	{}
 };
 
@@ -49,11 +55,13 @@ struct alignas(32_KiB) txn
 
 	txn(struct node &node,
 	    std::string content,
-	    m::fed::send::opts opts)
-	:txndata{std::move(content)}
+	    m::fed::send::opts opts,
+	    std::vector<m::event::idx> pdus,
+	    std::vector<std::shared_ptr<unit>> edus)
+	:txndata{std::move(content), std::move(pdus), std::move(edus)}
 	,send{this->txnid, string_view{this->content}, this->buf, std::move(opts)}
 	,node{&node}
-	,timeout{now<steady_point>()} //TODO: conf
+	,timeout{now<steady_point>()}
 	{}
 };
 
@@ -62,6 +70,11 @@ static_assert
 	sizeof(struct txn) == 32_KiB
 );
 
+static size_t queue_count(const string_view &remote);
+
+/// PDUs bound for a remote are persisted in the dbs::fed_queue column until
+/// a transaction carrying them is accepted; the node only tracks which of
+/// those are in flight. EDUs are ephemeral and only queued in memory here.
 struct node
 {
 	std::deque<std::shared_ptr<unit>> q;
@@ -69,21 +82,33 @@ struct node
 	string_view remote;
 	m::node::room room;
 	server::request::opts sopts;
-	txn *curtxn {nullptr};
-
+	std::set<m::event::idx> sending;
+	size_t queued {0};
+	size_t inflight {0};
+	size_t failures {0};
+	steady_point backoff;
+
+	size_t drop(db::txn &, const size_t &);
+	seconds fault();
 	bool flush();
 	void push(std::shared_ptr<unit>);
 
 	node(const string_view &remote)
 	:remote{ircd::strlcpy{mutable_buffer{rembuf}, remote}}
 	,room{this->remote}
+	,queued{queue_count(this->remote)}
 	{}
 };
 
 static std::list<txn> txns;
 static std::map<std::string, node, std::less<>> nodes;
 
+static node &get_node(const string_view &remote);
 static void remove_node(const node &);
+static void recover();
+static void recv_retries();
+static void recv_retry(txn &, node &);
+static void recv_accept(txn &, node &);
 static void recv_timeout(txn &, node &);
 static void recv_timeouts();
 static bool recv_handle(txn &, node &);
@@ -100,6 +125,86 @@ static void send_worker();
 static bool should_notify(const m::event &, const m::vm::eval &);
 static void handle_notify(const m::event &, m::vm::eval &);
 
+static conf::item<size_t>
+txn_pdus_max
+{
+	{ "name",     "ircd.federation.sender.txn.pdus.max" },
+	{ "default",  50L                                   },
+};
+
+static conf::item<size_t>
+txn_edus_max
+{
+	{ "name",     "ircd.federation.sender.txn.edus.max" },
+	{ "default",  100L                                  },
+};
+
+static conf::item<seconds>
+txn_timeout
+{
+	{ "name",     "ircd.federation.sender.txn.timeout" },
+	{ "default",  45L                                  },
+};
+
+/// Number of transactions which may be outstanding to a single remote at
+/// once. The specification orders one; raising this is only appropriate for
+/// remotes known to process transactions out of order.
+static conf::item<size_t>
+inflight_max
+{
+	{ "name",     "ircd.federation.sender.inflight.max" },
+	{ "default",  1L                                    },
+};
+
+static conf::item<seconds>
+backoff_min
+{
+	{ "name",     "ircd.federation.sender.backoff.min" },
+	{ "default",  5L                                   },
+};
+
+static conf::item<seconds>
+backoff_max
+{
+	{ "name",     "ircd.federation.sender.backoff.max" },
+	{ "default",  3600L                                },
+};
+
+/// EDUs are not persisted; this bounds the memory held for an unreachable
+/// remote by dropping the oldest.
+static conf::item<size_t>
+edus_max
+{
+	{ "name",     "ircd.federation.sender.edus.max" },
+	{ "default",  1024L                             },
+};
+
+/// Bounds the durable queue of each remote; beyond this the oldest PDUs
+/// not in flight are dropped to make room for new ones.
+static conf::item<size_t>
+queue_max
+{
+	{ "name",     "ircd.federation.sender.queue.max" },
+	{ "default",  65536L                             },
+};
+
+/// PDUs older than this are dropped from the durable queue rather than sent.
+static conf::item<seconds>
+queue_age_max
+{
+	{ "name",     "ircd.federation.sender.queue.age.max" },
+	{ "default",  long(72 * 60 * 60)                     },
+};
+
+/// Interval the receiver wakes up to check timeouts and retries when no
+/// transaction completes.
+static conf::item<milliseconds>
+recv_interval
+{
+	{ "name",     "ircd.federation.sender.recv.interval" },
+	{ "default",  2000L                                  },
+};
+
 static context
 receiver[1]
 {
@@ -279,9 +384,37 @@ send_to_room(const m::event &event,
 		room
 	};
 
+	// PDUs are referenced by index in the durable queue of each remote.
+	const m::event::idx event_idx
+	{
+		event.event_id?
+			m::index(std::nothrow, event.event_id):
+			0UL
+	};
+
+	if(unlikely(event.event_id && !event_idx))
+	{
+		log::derror
+		{
+			m::log, "Federation sender cannot queue unindexed %s",
+			string_view{event.event_id},
+		};
+
+		return;
+	}
+
+	// The queue entries for every remote are written together; the nodes
+	// are flushed once the write has been committed.
+	db::txn queue
+	{
+		*m::dbs::events
+	};
+
+	std::vector<node *> queued;
+
 	// Unit is not allocated until we find another server in the room.
 	std::shared_ptr<struct unit> unit;
-	const auto each_origin{[&unit, &event]
+	const auto each_origin{[&unit, &event, &event_idx, &queue, &queued]
 	(const string_view &origin)
 	{
 		if(my_host(origin))
@@ -290,18 +423,30 @@ send_to_room(const m::event &event,
 		if(m::fed::errant(origin))
 			return;
 
-		auto it
+		auto &node
 		{
-			nodes.lower_bound(origin)
+			get_node(origin)
 		};
 
-		if(it == end(nodes) || it->first != origin)
-			it = nodes.emplace_hint(it, origin, origin);
-
-		auto &node
+		if(event_idx)
 		{
-			it->second
-		};
+			if(node.queued >= size_t(queue_max))
+				node.drop(queue, node.queued + 1 - size_t(queue_max));
+
+			++node.queued;
+			char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+			db::txn::append
+			{
+				queue, m::dbs::fed_queue,
+				{
+					db::op::SET,
+					m::dbs::fed_queue_key(buf, origin, event_idx),
+				}
+			};
+
+			queued.emplace_back(&node);
+			return;
+		}
 
 		if(!unit)
 			unit = std::make_shared<struct unit>(event);
@@ -330,6 +475,13 @@ send_to_room(const m::event &event,
 		if(!origins.has(origin))
 			each_origin(origin);
 	}
+
+	if(queued.empty())
+		return;
+
+	queue();
+	for(auto *const &node : queued)
+		node->flush();
 }
 
 /// EDU path where the target is a user/device
@@ -348,17 +500,9 @@ send_to_user(const m::event &event,
 	if(m::fed::errant(origin))
 		return;
 
-	auto it
-	{
-		nodes.lower_bound(origin)
-	};
-
-	if(it == end(nodes) || it->first != origin)
-		it = nodes.emplace_hint(it, origin, origin);
-
 	auto &node
 	{
-		it->second
+		get_node(origin)
 	};
 
 	auto unit
@@ -391,17 +535,9 @@ send_from_user(const m::event &event,
 		if(m::fed::errant(origin))
 			return true;
 
-		auto it
-		{
-			nodes.lower_bound(origin)
-		};
-
-		if(it == end(nodes) || it->first != origin)
-			it = nodes.emplace_hint(it, origin, origin);
-
 		auto &node
 		{
-			it->second
+			get_node(origin)
 		};
 
 		auto unit
@@ -419,76 +555,165 @@ void
 node::push(std::shared_ptr<unit> su)
 {
 	q.emplace_back(std::move(su));
+	while(q.size() > size_t(edus_max))
+	{
+		log::dwarning
+		{
+			m::log, "Federation sender queue to '%s' full; dropping %s",
+			remote,
+			q.front()->type == unit::PDU? "pdu"_sv: "edu"_sv,
+		};
+
+		q.pop_front();
+	}
 }
 
 bool
 node::flush()
 try
 {
-	if(q.empty())
-		return true;
-
-	if(curtxn)
+	if(now<steady_point>() < backoff)
 		return true;
 
-	size_t pdus{0}, edus{0};
-	for(const auto &unit : q) switch(unit->type)
+	while(inflight < std::max(size_t(inflight_max), 1UL))
 	{
-		case unit::PDU:   ++pdus;  break;
-		case unit::EDU:   ++edus;  break;
-		default:                   break;
-	}
+		// Select the next PDUs from the durable queue for this remote which
+		// are not already carried by a transaction in flight.
+		std::vector<m::event::idx> pdus;
+		pdus.reserve(size_t(txn_pdus_max));
+		{
+			char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+			const string_view key
+			{
+				m::dbs::fed_queue_key(buf, remote)
+			};
 
-	size_t pc(0), ec(0);
-	std::vector<json::value> units(pdus + edus);
-	for(const auto &unit : q) switch(unit->type)
-	{
-		case unit::PDU:
-			units.at(pc++) = string_view{unit->s};
-			break;
+			auto it(m::dbs::fed_queue.begin(key));
+			for(; it && pdus.size() < size_t(txn_pdus_max); ++it)
+			{
+				const auto event_idx
+				{
+					m::dbs::fed_queue_key(it->first)
+				};
 
-		case unit::EDU:
-			units.at(pdus + ec++) = string_view{unit->s};
-			break;
+				if(!sending.count(event_idx))
+					pdus.emplace_back(event_idx);
+			}
+		}
 
-		default:
+		const size_t units
+		{
+			std::min(q.size(), size_t(txn_edus_max))
+		};
+
+		if(pdus.empty() && !units)
 			break;
-	}
 
-	m::fed::send::opts opts;
-	opts.remote = remote;
-	opts.dynamic = false;
-	opts.sopts = &sopts;
+		std::vector<std::string> pdu;
+		pdu.reserve(pdus.size());
+		for(auto it(begin(pdus)); it != end(pdus); )
+		{
+			const m::event::fetch event
+			{
+				std::nothrow, *it
+			};
 
-	const vector_view<const json::value> pduv
-	{
-		units.data(), units.data() + pc
-	};
+			// The event was purged while queued, or has been queued for too
+			// long to be worth sending; it is dropped.
+			const bool expired
+			{
+				event.valid
+				&& json::get<"origin_server_ts"_>(event) + milliseconds(seconds(queue_age_max)).count() < ircd::time<milliseconds>()
+			};
 
-	const vector_view<const json::value> eduv
-	{
-		units.data() + pdus, units.data() + pdus + ec
-	};
+			if(unlikely(!event.valid || expired))
+			{
+				char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+				db::del(m::dbs::fed_queue, m::dbs::fed_queue_key(buf, remote, *it));
+				queued -= bool(queued);
+				it = pdus.erase(it);
+				continue;
+			}
+
+			pdu.emplace_back(json::strung{event});
+			++it;
+		}
+
+		std::vector<std::shared_ptr<unit>> edus
+		{
+			begin(q), begin(q) + units
+		};
 
-	std::string content
-	{
-		m::txn::create(pduv, eduv)
-	};
+		if(pdu.empty() && edus.empty())
+			continue;
 
-	txns.emplace_back(*this, std::move(content), std::move(opts));
-	const unwind_nominal_assertion na;
-	curtxn = &txns.back();
-	q.clear();
-	log::debug
-	{
-		m::log, "sending txn %s pdus:%zu edus:%zu to '%s'",
-		curtxn->txnid,
-		pdus,
-		edus,
-		this->remote,
-	};
+		size_t pc(0), ec(0);
+		for(const auto &unit : edus) switch(unit->type)
+		{
+			case unit::PDU:   ++pc;  break;
+			case unit::EDU:   ++ec;  break;
+			default:                 break;
+		}
+
+		const size_t pdc(pdu.size() + pc);
+		std::vector<json::value> values(pdc + ec);
+		for(size_t i(0); i < pdu.size(); ++i)
+			values.at(i) = string_view{pdu[i]};
+
+		pc = pdu.size(), ec = 0;
+		for(const auto &unit : edus) switch(unit->type)
+		{
+			case unit::PDU:
+				values.at(pc++) = string_view{unit->s};
+				break;
+
+			case unit::EDU:
+				values.at(pdc + ec++) = string_view{unit->s};
+				break;
+
+			default:
+				break;
+		}
+
+		m::fed::send::opts opts;
+		opts.remote = remote;
+		opts.dynamic = false;
+		opts.sopts = &sopts;
+
+		const vector_view<const json::value> pduv
+		{
+			values.data(), values.data() + pc
+		};
+
+		const vector_view<const json::value> eduv
+		{
+			values.data() + pdc, values.data() + pdc + ec
+		};
+
+		std::string content
+		{
+			m::txn::create(pduv, eduv)
+		};
+
+		txns.emplace_back(*this, std::move(content), std::move(opts), std::move(pdus), std::move(edus));
+		const unwind_nominal_assertion na;
+		auto &txn(txns.back());
+		q.erase(begin(q), begin(q) + units);
+		sending.insert(begin(txn.pdus), end(txn.pdus));
+		++inflight;
+		log::debug
+		{
+			m::log, "sending txn %s pdus:%zu edus:%zu to '%s' inflight:%zu",
+			txn.txnid,
+			pc,
+			ec,
+			this->remote,
+			inflight,
+		};
+
+		recv_action.notify_one();
+	}
 
-	recv_action.notify_one();
 	return true;
 }
 catch(const std::exception &e)
@@ -500,31 +725,164 @@ catch(const std::exception &e)
 			log::level::DERROR
 	};
 
+	// Backed off like a failed transaction so the retry timer picks it up.
+	const auto delay
+	{
+		fault()
+	};
+
 	log::logf
 	{
 		m::log, level,
-		"flush error to %s :%s",
+		"flush error to %s (retry in %ld seconds) :%s",
 		remote,
+		delay.count(),
 		e.what()
 	};
 
 	return false;
 }
 
+/// Increments the failure count and backs the remote off exponentially.
+seconds
+node::fault()
+{
+	const auto exponent
+	{
+		std::min(failures++, 16UL)
+	};
+
+	const seconds delay
+	{
+		std::min(seconds(backoff_max), seconds(backoff_min) * (1L << exponent))
+	};
+
+	backoff = now<steady_point>() + delay;
+	return delay;
+}
+
+/// Deletes up to count of the oldest PDUs not in flight from the durable
+/// queue as part of txn.
+size_t
+node::drop(db::txn &txn,
+           const size_t &count)
+{
+	char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+	const string_view key
+	{
+		m::dbs::fed_queue_key(buf, remote)
+	};
+
+	size_t ret(0);
+	auto it(m::dbs::fed_queue.begin(key));
+	for(; it && ret < count; ++it)
+	{
+		const auto event_idx
+		{
+			m::dbs::fed_queue_key(it->first)
+		};
+
+		if(sending.count(event_idx))
+			continue;
+
+		char del_buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+		db::txn::append
+		{
+			txn, m::dbs::fed_queue,
+			{
+				db::op::DELETE,
+				m::dbs::fed_queue_key(del_buf, remote, event_idx),
+			}
+		};
+
+		++ret;
+	}
+
+	queued -= std::min(queued, ret);
+	log::dwarning
+	{
+		m::log, "Federation sender queue to '%s' full; dropped %zu pdus",
+		remote,
+		ret,
+	};
+
+	return ret;
+}
+
 void
 __attribute__((noreturn))
 recv_worker()
 {
+	recover();
 	while(1)
 	{
-		recv_action.wait([]() noexcept
+		recv_action.wait_for(milliseconds(recv_interval), []() noexcept
 		{
 			return !txns.empty();
 		});
 
-		recv();
+		if(!txns.empty())
+			recv();
+
 		recv_timeouts();
+		recv_retries();
+	}
+}
+
+/// Creates a node for every remote with PDUs remaining in the durable queue
+/// from a previous run and starts sending them.
+void
+recover()
+try
+{
+	db::gopts gopts;
+	gopts.ordered = true;
+
+	size_t count(0);
+	auto it(m::dbs::fed_queue.column::begin(gopts));
+	while(it)
+	{
+		const auto remote
+		{
+			split(it->first, '\0').first
+		};
+
+		if(!my_host(remote) && rfc3986::valid_remote(std::nothrow, remote))
+		{
+			get_node(remote).flush();
+			++count;
+		}
+
+		// Seek past every key of this remote.
+		char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+		mutable_buffer out{buf};
+		consume(out, copy(out, remote));
+		consume(out, copy(out, '\x01'));
+		const string_view next
+		{
+			buf, data(out)
+		};
+
+		it = m::dbs::fed_queue.column::lower_bound(next, gopts);
 	}
+
+	if(count) log::info
+	{
+		m::log, "Federation sender resuming queued transactions to %zu servers.",
+		count,
+	};
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		m::log, "Federation sender recovering queue :%s",
+		e.what(),
+	};
 }
 
 void
@@ -562,11 +920,24 @@ try
 		recv_handle(txn, node)
 	};
 
-	node.curtxn = nullptr;
-	txns.erase(it);
+	assert(node.inflight > 0);
+	--node.inflight;
+	for(const auto &event_idx : txn.pdus)
+		node.sending.erase(event_idx);
 
-	if(!ret)
-		return;
+	{
+		// The txn is finished even if its disposition throws; it must not be
+		// processed again.
+		const unwind erase{[&it]
+		{
+			txns.erase(it);
+		}};
+
+		if(ret)
+			recv_accept(txn, node);
+		else
+			recv_retry(txn, node);
+	}
 
 	node.flush();
 }
@@ -579,6 +950,8 @@ catch(const std::exception &e)
 	};
 }
 
+/// Returns true when the remote has finished with the transaction; false
+/// when it should be retried later.
 bool
 recv_handle(txn &txn,
             node &node)
@@ -638,7 +1011,16 @@ catch(const http::error &e)
 		e.what()
 	};
 
-	return false;
+	// The remote refused the transaction itself; resending the same
+	// content will never succeed so it is dropped.
+	const bool rejected
+	{
+		ushort(e.code) >= 400 && ushort(e.code) < 500
+		&& e.code != http::REQUEST_TIMEOUT
+		&& e.code != http::TOO_MANY_REQUESTS
+	};
+
+	return rejected;
 }
 catch(const std::exception &e)
 {
@@ -653,6 +1035,77 @@ catch(const std::exception &e)
 	return false;
 }
 
+/// Removes the PDUs carried by the transaction from the durable queue.
+void
+recv_accept(txn &txn,
+            node &node)
+{
+	node.failures = 0;
+	node.backoff = steady_point{};
+	if(txn.pdus.empty())
+		return;
+
+	db::txn queue
+	{
+		*m::dbs::events
+	};
+
+	for(const auto &event_idx : txn.pdus)
+	{
+		char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+		db::txn::append
+		{
+			queue, m::dbs::fed_queue,
+			{
+				db::op::DELETE,
+				m::dbs::fed_queue_key(buf, node.remote, event_idx),
+			}
+		};
+	}
+
+	queue();
+	node.queued -= std::min(node.queued, txn.pdus.size());
+}
+
+/// The PDUs remain in the durable queue; the EDUs are returned to the front
+/// of the memory queue. The remote is backed off exponentially.
+void
+recv_retry(txn &txn,
+           node &node)
+{
+	const auto delay
+	{
+		node.fault()
+	};
+
+	node.q.insert(begin(node.q), begin(txn.edus), end(txn.edus));
+	while(node.q.size() > size_t(edus_max))
+		node.q.pop_back();
+
+	log::dwarning
+	{
+		m::log, "Retrying %zu pdus %zu edus to '%s' in %ld seconds (failures:%zu)",
+		txn.pdus.size(),
+		txn.edus.size(),
+		node.remote,
+		delay.count(),
+		node.failures,
+	};
+}
+
+void
+recv_retries()
+{
+	const auto &now
+	{
+		ircd::now<steady_point>()
+	};
+
+	for(auto &[remote, node] : nodes)
+		if(node.failures && node.backoff <= now && !node.inflight)
+			node.flush();
+}
+
 void
 recv_timeouts()
 {
@@ -666,7 +1119,7 @@ recv_timeouts()
 	{
 		auto &txn(*it);
 		assert(txn.node);
-		if(txn.timeout + seconds(45) < now) //TODO: conf
+		if(txn.timeout + seconds(txn_timeout) < now)
 			recv_timeout(txn, *txn.node);
 	}
 }
@@ -685,6 +1138,36 @@ recv_timeout(txn &txn,
 	cancel(txn);
 }
 
+node &
+get_node(const string_view &remote)
+{
+	auto it
+	{
+		nodes.lower_bound(remote)
+	};
+
+	if(it == end(nodes) || it->first != remote)
+		it = nodes.emplace_hint(it, remote, remote);
+
+	return it->second;
+}
+
+size_t
+queue_count(const string_view &remote)
+{
+	char buf[m::dbs::FED_QUEUE_KEY_MAX_SIZE];
+	const string_view key
+	{
+		m::dbs::fed_queue_key(buf, remote)
+	};
+
+	size_t ret(0);
+	for(auto it(m::dbs::fed_queue.begin(key)); it; ++it)
+		++ret;
+
+	return ret;
+}
+
 void
 remove_node(const node &node)
 {
@@ -10,20 +10,113 @@
 
 namespace ircd::m::push
 {
+	struct ruleset;
+	struct evaluation;
+
 	static void execute(const event &, vm::eval &, const user::id &, const path &, const rule &, const event::idx &);
-	static bool matching(const event &, vm::eval &, const user::id &, const path &, const rule &);
-	static bool handle_kind(const event &, vm::eval &, const user::id &, const path &);
-	static void handle_rules(const event &, vm::eval &, const user::id &, const string_view &scope);
+	static bool matching(const event &, evaluation &, const user::id &, const ruleset &, const size_t &);
+	static void handle_rules(const event &, vm::eval &, evaluation &, const user::id &);
 	static void handle_event(const m::event &, vm::eval &);
+	static void handle_read(const m::event &, vm::eval &);
+	static void handle_fully_read(const m::event &, vm::eval &);
+	static void handle_rule_change(const m::event &, vm::eval &);
+	static std::shared_ptr<const ruleset> compile(const user::id &);
+	static std::shared_ptr<const ruleset> get_ruleset(const user::id &);
 	extern hookfn<vm::eval &> hook_event;
+	extern hookfn<vm::eval &> hook_read;
+	extern hookfn<vm::eval &> hook_fully_read;
+	extern hookfn<vm::eval &> hook_rule_change;
+	extern conf::item<size_t> rules_cache_max;
+	extern stats::item<uint64_t> rules_cache_hit;
+	extern stats::item<uint64_t> rules_cache_miss;
+	extern stats::item<uint64_t> rules_cache_shared;
+	extern stats::item<uint64_t> cond_memo_hit;
 }
 
+/// A user's push rules compiled into priority order. The rules are loaded
+/// from the user's room once and the instance is cached until the user
+/// changes a rule. Users with identical rules (notably those with only the
+/// server defaults) share one instance.
+struct ircd::m::push::ruleset
+{
+	struct cond;
+	struct rule;
+
+	std::string source;
+	std::vector<rule> rules;
+};
+
+struct ircd::m::push::ruleset::cond
+{
+	push::cond cond;
+	std::string memo;  // identity for conditions independent of the user
+};
+
+struct ircd::m::push::ruleset::rule
+{
+	push::path path;
+	push::rule rule;
+	event::idx idx {0};
+	std::vector<cond> conds;
+};
+
+/// State of matching one event for all of the members of its room. The
+/// results of conditions which do not depend on the user are computed
+/// once per event.
+struct ircd::m::push::evaluation
+{
+	std::map<std::string, bool, std::less<>> memo;
+};
+
 ircd::mapi::header
 IRCD_MODULE
 {
 	"Matrix 13.13 :Push Notifications",
 };
 
+decltype(ircd::m::push::rules_cache_max)
+ircd::m::push::rules_cache_max
+{
+	{ "name",     "ircd.m.push.rules.cache.max" },
+	{ "default",  65536L                        },
+};
+
+decltype(ircd::m::push::rules_cache_hit)
+ircd::m::push::rules_cache_hit
+{
+	{ "name", "ircd.m.push.rules.cache.hit" },
+};
+
+decltype(ircd::m::push::rules_cache_miss)
+ircd::m::push::rules_cache_miss
+{
+	{ "name", "ircd.m.push.rules.cache.miss" },
+};
+
+decltype(ircd::m::push::rules_cache_shared)
+ircd::m::push::rules_cache_shared
+{
+	{ "name", "ircd.m.push.rules.cache.shared" },
+};
+
+decltype(ircd::m::push::cond_memo_hit)
+ircd::m::push::cond_memo_hit
+{
+	{ "name", "ircd.m.push.cond.memo.hit" },
+};
+
+namespace ircd::m::push
+{
+	// user_id => compiled rules
+	static std::map<std::string, std::shared_ptr<const ruleset>, std::less<>> rules_cache;
+
+	// compiled source => compiled rules; for sharing identical rulesets.
+	static std::map<std::string, std::weak_ptr<const ruleset>, std::less<>> rules_shared;
+
+	// Incremented on invalidation to discard compilations raced by a change.
+	static uint64_t rules_epoch;
+}
+
 decltype(ircd::m::push::hook_event)
 ircd::m::push::hook_event
 {
@@ -56,7 +149,8 @@ try
 		room_id
 	};
 
-	members.for_each("join", my_host(), [&event, &eval]
+	evaluation evaluation;
+	members.for_each("join", my_host(), [&event, &eval, &evaluation]
 	(const user::id &user_id, const event::idx &membership_event_idx)
 	{
 		// r0.6.0-13.13.15 Homeservers MUST NOT notify the Push Gateway for
@@ -64,7 +158,7 @@ try
 		if(user_id == at<"sender"_>(event))
 			return true;
 
-		handle_rules(event, eval, user_id, "global");
+		handle_rules(event, eval, evaluation, user_id);
 		return true;
 	});
 }
@@ -85,67 +179,92 @@ catch(const std::exception &e)
 void
 ircd::m::push::handle_rules(const event &event,
                             vm::eval &eval,
-                            const user::id &user_id,
-                            const string_view &scope)
+                            evaluation &evaluation,
+                            const user::id &user_id)
 {
-	const push::path path[]
+	const auto ruleset
 	{
-		{ scope, "override",   string_view{}         },
-		{ scope, "content",    string_view{}         },
-		{ scope, "room",       at<"room_id"_>(event) },
-		{ scope, "sender",     at<"sender"_>(event)  },
-		{ scope, "underride",  string_view{}         },
+		get_ruleset(user_id)
 	};
 
-	for(const auto &p : path)
-		if(!handle_kind(event, eval, user_id, p))
-			break;
-}
-
-bool
-ircd::m::push::handle_kind(const event &event,
-                           vm::eval &eval,
-                           const user::id &user_id,
-                           const path &path)
-{
-	const user::pushrules pushrules
+	assert(ruleset);
+	for(size_t i(0); i < ruleset->rules.size(); ++i)
 	{
-		user_id
-	};
+		const auto &rule
+		{
+			ruleset->rules[i]
+		};
 
-	return pushrules.for_each(path, [&event, &eval, &user_id]
-	(const auto &event_idx, const auto &path, const auto &rule)
-	{
-		if(matching(event, eval, user_id, path, rule))
+		const auto &[scope, kind, ruleid]
 		{
-			execute(event, eval, user_id, path, rule, event_idx);
-			return false; // false to break due to match
-		}
-		else return true;
-	});
+			rule.path
+		};
+
+		// Room and sender rules are only candidates for their own target.
+		if(kind == "room" && ruleid != json::get<"room_id"_>(event))
+			continue;
+
+		if(kind == "sender" && ruleid != json::get<"sender"_>(event))
+			continue;
+
+		if(!matching(event, evaluation, user_id, *ruleset, i))
+			continue;
+
+		execute(event, eval, user_id, rule.path, rule.rule, rule.idx);
+		break;
+	}
 }
 
 bool
 ircd::m::push::matching(const event &event,
-                        vm::eval &eval,
+                        evaluation &evaluation,
                         const user::id &user_id,
-                        const path &path,
-                        const rule &rule)
+                        const ruleset &ruleset,
+                        const size_t &i)
 try
 {
+	const auto &rule
+	{
+		ruleset.rules.at(i)
+	};
+
 	const auto &[scope, kind, ruleid]
 	{
-		path
+		rule.path
 	};
 
-	if(!json::get<"enabled"_>(rule))
+	if(!json::get<"enabled"_>(rule.rule))
 		return false;
 
 	push::match::opts opts;
 	opts.user_id = user_id;
-	const push::match match
+	const bool match
 	{
-		event, rule, opts
+		std::all_of(begin(rule.conds), end(rule.conds), [&]
+		(const auto &cond)
+		{
+			if(cond.memo.empty())
+				return bool(push::match(event, cond.cond, opts));
+
+			const auto it
+			{
+				evaluation.memo.lower_bound(cond.memo)
+			};
+
+			if(it != end(evaluation.memo) && it->first == cond.memo)
+			{
+				++cond_memo_hit;
+				return it->second;
+			}
+
+			const bool ret
+			{
+				push::match(event, cond.cond, opts)
+			};
+
+			evaluation.memo.emplace_hint(it, std::string{cond.memo}, ret);
+			return ret;
+		})
 	};
 
 	if constexpr((false))
@@ -157,10 +276,10 @@ try
 			kind,
 			ruleid,
 			string_view{user_id},
-			bool(match)? "MATCH"_sv : string_view{}
+			match? "MATCH"_sv : string_view{}
 		};
 
-	return bool(match);
+	return match;
 }
 catch(const ctx::interrupted &)
 {
@@ -170,7 +289,7 @@ catch(const std::exception &e)
 {
 	const auto &[scope, kind, ruleid]
 	{
-		path
+		ruleset.rules.at(i).path
 	};
 
 	log::error
@@ -235,6 +354,15 @@ try
 		user::notifications::make_type(type_buf, opts)
 	};
 
+	// The counter is bumped before the notification is sent so it is
+	// current by the time any sync for the notification is conducted.
+	const user::unread unread
+	{
+		user_id
+	};
+
+	unread.incr(eval.room_id, highlighting(rule));
+
 	const user::room user_room
 	{
 		user_id
@@ -269,3 +397,389 @@ catch(const std::exception &e)
 		e.what(),
 	};
 }
+
+//
+// compiled rulesets
+//
+
+std::shared_ptr<const ircd::m::push::ruleset>
+ircd::m::push::get_ruleset(const user::id &user_id)
+{
+	const auto it
+	{
+		rules_cache.find(user_id)
+	};
+
+	if(it != end(rules_cache))
+	{
+		++rules_cache_hit;
+		return it->second;
+	}
+
+	++rules_cache_miss;
+	const auto epoch
+	{
+		rules_epoch
+	};
+
+	auto ruleset
+	{
+		compile(user_id)
+	};
+
+	// Share an identical ruleset already compiled for another user.
+	auto &shared
+	{
+		rules_shared[ruleset->source]
+	};
+
+	if(auto existing{shared.lock()}; existing)
+	{
+		++rules_cache_shared;
+		ruleset = std::move(existing);
+	}
+	else shared = ruleset;
+
+	// Rules were changed while this compilation was yielding; the result is
+	// still valid for the present event but not for the cache.
+	if(epoch != rules_epoch)
+		return ruleset;
+
+	if(rules_cache.size() >= size_t(rules_cache_max))
+	{
+		rules_cache.clear();
+		for(auto it(begin(rules_shared)); it != end(rules_shared); )
+			it = it->second.expired()? rules_shared.erase(it): std::next(it);
+	}
+
+	rules_cache.emplace(std::string{user_id}, ruleset);
+	return ruleset;
+}
+
+std::shared_ptr<const ircd::m::push::ruleset>
+ircd::m::push::compile(const user::id &user_id)
+{
+	static const string_view kinds[]
+	{
+		"override", "content", "room", "sender", "underride",
+	};
+
+	static const string_view user_cond_kinds[]
+	{
+		"contains_user_mxid", "state_key_user_mxid", "contains_display_name",
+	};
+
+	struct record
+	{
+		event::idx idx;
+		size_t kind;
+		size_t ruleid[2];
+		size_t content[2];
+	};
+
+	// All rules are copied into a single buffer before any are parsed so
+	// the views taken into it remain valid for the life of the ruleset.
+	auto ret
+	{
+		std::make_shared<ruleset>()
+	};
+
+	std::vector<record> records;
+	const user::pushrules pushrules
+	{
+		user_id
+	};
+
+	for(size_t kind(0); kind < size(kinds); ++kind)
+		pushrules.for_each(push::path{"global", kinds[kind], {}}, [&]
+		(const auto &idx, const auto &path, const json::object &content)
+		{
+			const auto &ruleid
+			{
+				std::get<2>(path)
+			};
+
+			auto &rec
+			{
+				records.emplace_back(record{idx, kind})
+			};
+
+			rec.ruleid[0] = ret->source.size();
+			ret->source.append(ruleid);
+			rec.ruleid[1] = ret->source.size();
+			rec.content[0] = ret->source.size();
+			ret->source.append(content);
+			rec.content[1] = ret->source.size();
+			ret->source.append(lex_cast(idx));
+			ret->source.push_back('\0');
+			return true;
+		});
+
+	const string_view source
+	{
+		ret->source
+	};
+
+	ret->rules.reserve(records.size());
+	for(const auto &rec : records)
+	{
+		auto &rule
+		{
+			ret->rules.emplace_back()
+		};
+
+		rule.idx = rec.idx;
+		rule.path = push::path
+		{
+			"global",
+			kinds[rec.kind],
+			source.substr(rec.ruleid[0], rec.ruleid[1] - rec.ruleid[0]),
+		};
+
+		rule.rule = push::rule
+		{
+			json::object
+			{
+				source.substr(rec.content[0], rec.content[1] - rec.content[0])
+			}
+		};
+
+		const auto add_cond{[&rule](const push::cond &cond)
+		{
+			const bool user_dependent
+			{
+				std::find(begin(user_cond_kinds), end(user_cond_kinds), json::get<"kind"_>(cond))
+				!= end(user_cond_kinds)
+			};
+
+			std::string memo;
+			if(!user_dependent)
+				memo = std::string(json::get<"kind"_>(cond))
+				+ '\0' + std::string(json::get<"key"_>(cond))
+				+ '\0' + std::string(json::get<"pattern"_>(cond))
+				+ '\0' + std::string(json::get<"is"_>(cond))
+				+ '\0' + std::string(json::get<"value"_>(cond));
+
+			rule.conds.emplace_back(ruleset::cond{cond, std::move(memo)});
+		}};
+
+		if(json::get<"pattern"_>(rule.rule))
+			add_cond(push::cond
+			{
+				{ "kind",     "event_match"                    },
+				{ "key",      "content.body"                   },
+				{ "pattern",  json::get<"pattern"_>(rule.rule) },
+			});
+
+		for(const json::object cond : json::get<"conditions"_>(rule.rule))
+			add_cond(push::cond(cond));
+	}
+
+	return ret;
+}
+
+decltype(ircd::m::push::hook_rule_change)
+ircd::m::push::hook_rule_change
+{
+	handle_rule_change,
+	{
+		{ "_site",  "vm.effect" },
+	}
+};
+
+/// Drop the user's compiled rules when a rule is set or deleted (deletion is
+/// by redaction) in their user room.
+void
+ircd::m::push::handle_rule_change(const m::event &event,
+                                  vm::eval &eval)
+{
+	const auto &type
+	{
+		json::get<"type"_>(event)
+	};
+
+	if(!startswith(type, rule::type_prefix) && type != "m.room.redaction")
+		return;
+
+	const m::user::id &user_id
+	{
+		json::get<"sender"_>(event)
+	};
+
+	if(!user_id || !my(user_id))
+		return;
+
+	if(!m::user::room::is(json::get<"room_id"_>(event), user_id))
+		return;
+
+	++rules_epoch;
+	const auto it
+	{
+		rules_cache.find(user_id)
+	};
+
+	if(it != end(rules_cache))
+		rules_cache.erase(it);
+}
+
+//
+// unread counter resets
+//
+
+decltype(ircd::m::push::hook_read)
+ircd::m::push::hook_read
+{
+	handle_read,
+	{
+		{ "_site",  "vm.effect" },
+		{ "type",   "ircd.read" },
+	}
+};
+
+/// Recount the user's unread notifications in a room after a read receipt
+/// is stored to their user room (state_key is the target room_id).
+void
+ircd::m::push::handle_read(const m::event &event,
+                           vm::eval &eval)
+try
+{
+	const m::user::id &user_id
+	{
+		at<"sender"_>(event)
+	};
+
+	if(!my(user_id))
+		return;
+
+	const m::user::room user_room
+	{
+		user_id
+	};
+
+	if(json::get<"room_id"_>(event) != user_room.room_id)
+		return;
+
+	const m::room::id &room_id
+	{
+		at<"state_key"_>(event)
+	};
+
+	const json::string &event_id
+	{
+		json::get<"content"_>(event).get("event_id")
+	};
+
+	const auto marker
+	{
+		valid(m::id::EVENT, event_id)?
+			index(std::nothrow, m::event::id(event_id)):
+			0UL
+	};
+
+	if(!marker)
+		return;
+
+	const m::user::unread unread
+	{
+		user_id
+	};
+
+	unread.reset(room_id, marker);
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "Unread counter reset for %s by %s :%s",
+		string_view{event.event_id},
+		json::get<"sender"_>(event),
+		e.what(),
+	};
+}
+
+decltype(ircd::m::push::hook_fully_read)
+ircd::m::push::hook_fully_read
+{
+	handle_fully_read,
+	{
+		{ "_site",      "vm.effect"     },
+		{ "state_key",  "m.fully_read"  },
+	}
+};
+
+/// Recount the user's unread notifications in a room after their read
+/// marker is stored to the room's account data in their user room.
+void
+ircd::m::push::handle_fully_read(const m::event &event,
+                                 vm::eval &eval)
+try
+{
+	const auto &type
+	{
+		at<"type"_>(event)
+	};
+
+	if(!startswith(type, user::room_account_data::type_prefix))
+		return;
+
+	const m::user::id &user_id
+	{
+		at<"sender"_>(event)
+	};
+
+	if(!my(user_id))
+		return;
+
+	const m::user::room user_room
+	{
+		user_id
+	};
+
+	if(json::get<"room_id"_>(event) != user_room.room_id)
+		return;
+
+	const m::room::id &room_id
+	{
+		lstrip(type, user::room_account_data::type_prefix)
+	};
+
+	const json::string &event_id
+	{
+		json::get<"content"_>(event).get("event_id")
+	};
+
+	const auto marker
+	{
+		valid(m::id::EVENT, event_id)?
+			index(std::nothrow, m::event::id(event_id)):
+			0UL
+	};
+
+	if(!marker)
+		return;
+
+	const m::user::unread unread
+	{
+		user_id
+	};
+
+	unread.reset(room_id, marker);
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "Unread counter reset for %s by %s :%s",
+		string_view{event.event_id},
+		json::get<"sender"_>(event),
+		e.what(),
+	};
+}
@@ -11,7 +11,9 @@
 namespace ircd::m::relation
 {
 	static void handle_fetch(const event &, vm::eval &);
+	static void handle_thread(const event &, vm::eval &);
 	extern hookfn<vm::eval &> fetch_hook;
+	extern hookfn<vm::eval &> thread_hook;
 	extern conf::item<seconds> fetch_timeout;
 	extern conf::item<bool> fetch_enable;
 }
@@ -155,3 +157,120 @@ catch(const std::exception &e)
 		e.what(),
 	};
 }
+
+decltype(ircd::m::relation::thread_hook)
+ircd::m::relation::thread_hook
+{
+	handle_thread,
+	{
+		{ "_site",  "vm.effect" },
+	}
+};
+
+/// Update the summary of the thread when a reply is evaluated, or index the
+/// thread when its root arrives after replies to it.
+void
+ircd::m::relation::handle_thread(const event &event,
+                                 vm::eval &eval)
+try
+{
+	if(!json::get<"room_id"_>(event) || !eval.sequence)
+		return;
+
+	// Replies evaluated before this event were related to it once it arrived
+	// (see: dbs::event_horizon); if it roots a thread that is indexed now.
+	const m::relates replies
+	{
+		.refs = eval.sequence,
+	};
+
+	if(replies.has("m.thread"))
+	{
+		const m::room::threads threads
+		{
+			m::room{at<"room_id"_>(event)}
+		};
+
+		threads.rebuild(eval.sequence);
+	}
+
+	const json::object &m_relates_to
+	{
+		json::get<"content"_>(event).get("m.relates_to")
+	};
+
+	if(!m_relates_to || !json::type(m_relates_to, json::OBJECT))
+		return;
+
+	const m::relates_to relates
+	{
+		m_relates_to
+	};
+
+	if(json::get<"rel_type"_>(relates) != "m.thread")
+		return;
+
+	const auto &root_id
+	{
+		json::get<"event_id"_>(relates)
+	};
+
+	const auto root_idx
+	{
+		valid(m::id::EVENT, root_id)?
+			m::index(std::nothrow, m::event::id(root_id)):
+			0UL
+	};
+
+	if(!root_idx)
+		return;
+
+	// A thread can only be rooted in the room of its replies.
+	const bool same_room
+	{
+		m::query(std::nothrow, root_idx, "room_id", [&event]
+		(const string_view &room_id)
+		{
+			return room_id == at<"room_id"_>(event);
+		})
+	};
+
+	if(!same_room)
+	{
+		log::dwarning
+		{
+			log, "%s in %s is a thread reply to %s in another room; ignored.",
+			string_view{event.event_id},
+			at<"room_id"_>(event),
+			string_view{root_id},
+		};
+
+		return;
+	}
+
+	const m::room room
+	{
+		at<"room_id"_>(event)
+	};
+
+	const m::room::threads threads
+	{
+		room
+	};
+
+	threads.add(root_idx, eval.sequence, at<"sender"_>(event));
+}
+catch(const ctx::interrupted &)
+{
+	throw;
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "Failed to update thread for %s in %s :%s",
+		string_view(event.event_id),
+		string_view(json::get<"room_id"_>(event)),
+		e.what(),
+	};
+}
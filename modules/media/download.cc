@@ -28,6 +28,10 @@ get__download_local(client &client,
                     const m::media::mxc &mxc,
                     const m::room &room);
 
+static std::pair<size_t, size_t>
+parse_range(const string_view &range,
+            const size_t &file_size);
+
 static m::resource::response
 get__download(client &client,
               const m::resource::request &request)
@@ -112,48 +116,164 @@ get__download_local(client &client,
 		};
 	});
 
-	static const auto &addl_headers
+	// The requested byte range as [first, last); the whole file when the
+	// client didn't ask for a range or asked for one we don't serve.
+	const auto range
 	{
-		"Cache-Control: public, max-age=31536000, immutable\r\n"_sv
+		parse_range(request.head.range, file_size)
+	};
+
+	if(unlikely(range.first > range.second))
+	{
+		char buf[64];
+		const string_view addl_headers
+		{
+			fmt::sprintf
+			{
+				buf, "Content-Range: bytes */%zu\r\n",
+				file_size,
+			}
+		};
+
+		return m::resource::response
+		{
+			client,
+			http::RANGE_NOT_SATISFIABLE,
+			content_type,
+			0UL,
+			addl_headers,
+		};
+	}
+
+	const bool partial
+	{
+		range.second - range.first != file_size
+	};
+
+	const size_t length
+	{
+		range.second - range.first
+	};
+
+	char buf[192];
+	const string_view addl_headers
+	{
+		!partial?
+			"Cache-Control: public, max-age=31536000, immutable\r\n"
+			"Accept-Ranges: bytes\r\n"_sv:
+			fmt::sprintf
+			{
+				buf,
+				"Cache-Control: public, max-age=31536000, immutable\r\n"
+				"Accept-Ranges: bytes\r\n"
+				"Content-Range: bytes %zu-%zu/%zu\r\n",
+				range.first,
+				range.second - 1,
+				file_size,
+			}
 	};
 
 	// Send HTTP head to client
 	m::resource::response
 	{
 		client,
-		http::OK,
+		partial?
+			http::PARTIAL_CONTENT:
+			http::OK,
 		content_type,
-		file_size,
+		length,
 		addl_headers,
 	};
 
+	// Blocks are written out one at a time as they are read; the file is
+	// never held in memory beyond the block being transmitted.
 	size_t sent{0}, read
 	{
-		m::media::file::read(room, [&client, &sent]
+		m::media::file::read(room, range.first, length, [&client, &sent]
 		(const string_view &block)
 		{
-			sent += write_all(*client.sock, block);
+			sent += client.write_all(block);
 		})
 	};
 
-	if(unlikely(read != file_size))
+	if(unlikely(read != length))
 		log::error
 		{
-			m::media::log, "File %s/%s [%s] size mismatch: expected %zu got %zu",
+			m::media::log, "File %s/%s [%s] size mismatch: expected %zu got %zu (range %zu-%zu/%zu)",
 			mxc.server,
 			mxc.mediaid,
 			string_view{room.room_id},
+			length,
+			read,
+			range.first,
+			range.second,
 			file_size,
-			read
 		};
 
 	// Have to kill client here after failing content length expectation.
-	if(unlikely(read != file_size))
+	if(unlikely(read != length))
 		client.close(net::dc::RST, net::close_ignore);
 
 	return {};
 }
 
+/// Parse a single byte range from the Range header. Multiple ranges and
+/// unknown units are ignored and the whole file is returned. An unsatisfiable
+/// range is indicated by first > second.
+static std::pair<size_t, size_t>
+parse_range(const string_view &range,
+            const size_t &file_size)
+{
+	const std::pair<size_t, size_t> whole
+	{
+		0, file_size
+	};
+
+	const auto &[unit, spec]
+	{
+		split(range, '=')
+	};
+
+	if(!range || unit != "bytes" || has(spec, ','))
+		return whole;
+
+	const auto &[first_, last_]
+	{
+		split(strip(spec), '-')
+	};
+
+	const auto first
+	{
+		lex_castable<size_t>(first_)?
+			std::optional<size_t>{lex_cast<size_t>(first_)}:
+			std::nullopt
+	};
+
+	const auto last
+	{
+		lex_castable<size_t>(last_)?
+			std::optional<size_t>{lex_cast<size_t>(last_)}:
+			std::nullopt
+	};
+
+	// bytes=-N is the final N bytes of the file.
+	if(!first && last)
+		return *last?
+			std::pair<size_t, size_t>{file_size - std::min(*last, file_size), file_size}:
+			std::pair<size_t, size_t>{1, 0};
+
+	if(!first || (last && *last < *first))
+		return whole;
+
+	if(*first >= file_size)
+		return {1, 0};
+
+	return
+	{
+		*first, last? std::min(*last + 1, file_size): file_size
+	};
+}
+
 static m::resource::method
 method_get
 {
@@ -19,4 +19,12 @@ namespace ircd::m::media::thumbnail
 	extern conf::item<size_t> height_max;
 	extern conf::item<std::string> mime_whitelist;
 	extern conf::item<std::string> mime_blacklist;
+	extern conf::item<bool> cache_enable;
+	extern conf::item<std::string> pregen_sizes;
+	extern stats::item<uint64_t> cache_hit;
+	extern stats::item<uint64_t> cache_miss;
+	extern stats::item<uint64_t> pregen_count;
+	extern ctx::pool pool;
+
+	void pregenerate(const m::room::id &, const string_view &content_type, unique_buffer<mutable_buffer>);
 }
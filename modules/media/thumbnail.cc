@@ -76,6 +76,64 @@ ircd::m::media::thumbnail::mime_blacklist
 	{ "default",  ""                                      },
 };
 
+decltype(ircd::m::media::thumbnail::cache_enable)
+ircd::m::media::thumbnail::cache_enable
+{
+	{ "name",     "ircd.m.media.thumbnail.cache.enable" },
+	{ "default",  true                                  },
+};
+
+decltype(ircd::m::media::thumbnail::pregen_sizes)
+ircd::m::media::thumbnail::pregen_sizes
+{
+	{ "name",     "ircd.m.media.thumbnail.pregen.sizes" },
+	{ "default",  "32x32:crop 96x96:crop 320x240:scale 640x480:scale 800x600:scale" },
+	{ "description",
+
+	R"(
+	Thumbnails generated for a file when it is uploaded, as space-separated
+	WIDTHxHEIGHT:METHOD specifications. Requests for these sizes are then
+	served from the thumbnail cache without decoding the original.
+	)"}
+};
+
+decltype(ircd::m::media::thumbnail::cache_hit)
+ircd::m::media::thumbnail::cache_hit
+{
+	{ "name", "ircd.m.media.thumbnail.cache.hit" },
+};
+
+decltype(ircd::m::media::thumbnail::cache_miss)
+ircd::m::media::thumbnail::cache_miss
+{
+	{ "name", "ircd.m.media.thumbnail.cache.miss" },
+};
+
+decltype(ircd::m::media::thumbnail::pregen_count)
+ircd::m::media::thumbnail::pregen_count
+{
+	{ "name", "ircd.m.media.thumbnail.pregen.count" },
+};
+
+static const ctx::pool::opts
+pool_opts
+{
+	512_KiB,  // stack_size
+	0,        // initial_ctxs
+	16,       // queue_max_hard
+	16,       // queue_max_soft
+	false,    // queue_max_blocking
+	false,    // queue_max_dwarning
+	0,        // ionice
+	1,        // nice
+};
+
+decltype(ircd::m::media::thumbnail::pool)
+ircd::m::media::thumbnail::pool
+{
+	"m.media.thumbnail", pool_opts
+};
+
 m::resource
 thumbnail_resource
 {
@@ -92,6 +150,25 @@ get__thumbnail_local(client &client,
                      const m::media::mxc &,
                      const m::room &room);
 
+static pair<size_t>
+thumbnail_dimension(const pair<size_t> &);
+
+static bool
+thumbnail_permitted(const string_view &mime_type);
+
+static bool
+thumbnail_cached(const m::room::id &,
+                 const string_view &method,
+                 const pair<size_t> &dimension,
+                 const m::media::file::closure &);
+
+static void
+thumbnail_generate(const m::room::id &,
+                   const const_buffer &file,
+                   const string_view &method,
+                   const pair<size_t> &dimension,
+                   const m::media::file::closure &);
+
 m::resource::response
 get__thumbnail(client &client,
                const m::resource::request &request)
@@ -177,13 +254,7 @@ get__thumbnail_local(client &client,
 
 	const pair<size_t> dimension
 	{
-		_dimension[0]?
-			std::clamp(_dimension[0], size_t(width_min), size_t(width_max)):
-			_dimension[0],
-
-		_dimension[1]?
-			std::clamp(_dimension[1], size_t(height_min), size_t(height_max)):
-			_dimension[1]
+		thumbnail_dimension({_dimension[0], _dimension[1]})
 	};
 
 	static const m::event::fetch::opts fopts
@@ -225,6 +296,61 @@ get__thumbnail_local(client &client,
 		};
 	});
 
+	const auto mime_type
+	{
+		split(content_type, ';').first
+	};
+
+	const bool supported
+	{
+		// Available in build
+		IRCD_USE_MAGICK
+
+		// Enabled by configuration
+		&& enable
+	};
+
+	const bool permitted
+	{
+		thumbnail_permitted(mime_type)
+	};
+
+	const bool valid_args
+	{
+		// Both dimension parameters given in query string
+		(dimension.first && dimension.second)
+
+		// Known thumbnailing method in query string
+		&& (method == "scale" || method == "crop")
+	};
+
+	static const auto &addl_headers
+	{
+		"Cache-Control: public, max-age=31536000, immutable\r\n"_sv
+	};
+
+	const auto closure{[&client, &content_type]
+	(const const_buffer &buf)
+	{
+		m::resource::response
+		{
+			client, buf, content_type, http::OK, addl_headers
+		};
+	}};
+
+	// Thumbnails are only ever stored for files which can be thumbnailed,
+	// so a hit skips reading and decoding the original entirely.
+	if(supported && permitted && valid_args && cache_enable)
+	{
+		if(thumbnail_cached(room.room_id, method, dimension, closure))
+		{
+			++cache_hit;
+			return {}; // responded from closure.
+		}
+
+		++cache_miss;
+	}
+
 	const unique_buffer<mutable_buffer> buf
 	{
 		file_size
@@ -254,29 +380,6 @@ get__thumbnail_local(client &client,
 			copied
 		};
 
-	const auto mime_type
-	{
-		split(content_type, ';').first
-	};
-
-	const bool supported
-	{
-		// Available in build
-		IRCD_USE_MAGICK
-
-		// Enabled by configuration
-		&& enable
-	};
-
-	const bool permitted
-	{
-		// If there's a blacklist, mime type must not in the blacklist.
-		(!mime_blacklist || !has(mime_blacklist, mime_type))
-
-		// If there's a whitelist, mime type must be in the whitelist.
-		&& (!mime_whitelist || has(mime_whitelist, mime_type))
-	};
-
 	const bool animated
 	{
 		// Administrator's fuse to disable animation detection.
@@ -292,15 +395,6 @@ get__thumbnail_local(client &client,
 		&& (has(mime_type, "image/png") && png::is_animated(buf))
 	};
 
-	const bool valid_args
-	{
-		// Both dimension parameters given in query string
-		(dimension.first && dimension.second)
-
-		// Known thumbnailing method in query string
-		&& (method == "scale" || method == "crop")
-	};
-
 	const bool fallback // Reasons to just send the original image
 	{
 		// Thumbnailer support not enabled or available
@@ -332,36 +426,215 @@ get__thumbnail_local(client &client,
 				"Unknown reason",
 		};
 
-	static const auto &addl_headers
-	{
-		"Cache-Control: public, max-age=31536000, immutable\r\n"_sv
-	};
-
 	if(fallback)
 		return m::resource::response
 		{
 			client, buf, content_type, http::OK, addl_headers
 		};
 
-	const auto closure{[&client, &content_type]
-	(const const_buffer &buf)
+	thumbnail_generate(room.room_id, buf, method, dimension, closure);
+	return {}; // responded from closure.
+}
+
+void
+ircd::m::media::thumbnail::pregenerate(const m::room::id &room_id,
+                                       const string_view &content_type,
+                                       unique_buffer<mutable_buffer> buf)
+{
+	const auto mime_type
 	{
-		m::resource::response
+		split(content_type, ';').first
+	};
+
+	const bool pregen
+	{
+		IRCD_USE_MAGICK
+		&& enable
+		&& cache_enable
+		&& !empty(string_view(pregen_sizes))
+		&& thumbnail_permitted(mime_type)
+		&& !(animation_enable && has(mime_type, "image/png") && png::is_animated(buf))
+	};
+
+	if(!pregen)
+		return;
+
+	// The pool's closure must be copyable.
+	auto file
+	{
+		std::make_shared<unique_buffer<mutable_buffer>>(std::move(buf))
+	};
+
+	pool.min(1);
+	if(pool.wouldblock())
+	{
+		log::dwarning
 		{
-			client, buf, content_type, http::OK, addl_headers
+			m::media::log, "Not pregenerating thumbnails for %s; queue full (%zu)",
+			string_view{room_id},
+			pool.queued(),
 		};
+
+		return;
+	}
+
+	pool([room_id(m::room::id::buf(room_id)), file(std::move(file))]
+	{
+		ircd::tokens(pregen_sizes, ' ', [&room_id, &file]
+		(const string_view &spec)
+		{
+			try
+			{
+				const auto &[size, method]
+				{
+					split(spec, ':')
+				};
+
+				const auto &[width, height]
+				{
+					split(size, 'x')
+				};
+
+				const pair<size_t> dimension
+				{
+					thumbnail_dimension
+					({
+						lex_castable<size_t>(width)? lex_cast<size_t>(width): 0UL,
+						lex_castable<size_t>(height)? lex_cast<size_t>(height): 0UL,
+					})
+				};
+
+				if(!dimension.first || !dimension.second)
+					return;
+
+				if(method != "scale" && method != "crop")
+					return;
+
+				if(thumbnail_cached(room_id, method, dimension, {}))
+					return;
+
+				thumbnail_generate(room_id, *file, method, dimension, [](const const_buffer &)
+				{
+					++pregen_count;
+				});
+			}
+			catch(const ctx::interrupted &)
+			{
+				throw;
+			}
+			catch(const std::exception &e)
+			{
+				log::derror
+				{
+					m::media::log, "Failed to pregenerate %s thumbnail for %s :%s",
+					spec,
+					string_view{room_id},
+					e.what(),
+				};
+			}
+		});
+	});
+}
+
+pair<size_t>
+thumbnail_dimension(const pair<size_t> &dimension)
+{
+	return
+	{
+		dimension.first?
+			std::clamp(dimension.first, size_t(width_min), size_t(width_max)):
+			dimension.first,
+
+		dimension.second?
+			std::clamp(dimension.second, size_t(height_min), size_t(height_max)):
+			dimension.second
+	};
+}
+
+bool
+thumbnail_permitted(const string_view &mime_type)
+{
+	return true
+
+	// If there's a blacklist, mime type must not in the blacklist.
+	&& (!mime_blacklist || !has(mime_blacklist, mime_type))
+
+	// If there's a whitelist, mime type must be in the whitelist.
+	&& (!mime_whitelist || has(mime_whitelist, mime_type));
+}
+
+bool
+thumbnail_cached(const m::room::id &room_id,
+                 const string_view &method,
+                 const pair<size_t> &dimension,
+                 const m::media::file::closure &closure)
+{
+	char key_buf[m::dbs::MEDIA_THUMBNAIL_KEY_MAX_SIZE];
+	const string_view key
+	{
+		m::dbs::media_thumbnail_key(key_buf, room_id, method.at(0), dimension)
+	};
+
+	if(!closure)
+		return db::has(m::dbs::media_thumbnail, key);
+
+	return m::dbs::media_thumbnail(key, std::nothrow, [&closure]
+	(const string_view &thumbnail)
+	{
+		closure(thumbnail);
+	});
+}
+
+/// Generate the thumbnail and store it in the cache before passing it to the
+/// closure. Any exception from the thumbnailer propagates to the caller.
+void
+thumbnail_generate(const m::room::id &room_id,
+                   const const_buffer &file,
+                   const string_view &method,
+                   const pair<size_t> &dimension,
+                   const m::media::file::closure &closure)
+{
+	const auto store{[&room_id, &method, &dimension, &closure]
+	(const const_buffer &thumbnail)
+	{
+		char key_buf[m::dbs::MEDIA_THUMBNAIL_KEY_MAX_SIZE];
+		if(cache_enable) try
+		{
+			db::write
+			(
+				m::dbs::media_thumbnail,
+				m::dbs::media_thumbnail_key(key_buf, room_id, method.at(0), dimension),
+				thumbnail
+			);
+		}
+		catch(const ctx::interrupted &)
+		{
+			throw;
+		}
+		catch(const std::exception &e)
+		{
+			log::derror
+			{
+				m::media::log, "Failed to store %s thumbnail %zux%zu for %s :%s",
+				method,
+				dimension.first,
+				dimension.second,
+				string_view{room_id},
+				e.what(),
+			};
+		}
+
+		closure(thumbnail);
 	}};
 
 	if(method == "crop")
 		magick::thumbcrop
 		{
-			buf, dimension, closure
+			file, dimension, store
 		};
 	else
 		magick::thumbnail
 		{
-			buf, dimension, closure
+			file, dimension, store
 		};
-
-	return {}; // responded from closure.
 }
@@ -64,13 +64,15 @@ post__upload(client &client,
 
 	create(room, request.user_id, "file");
 
-	const unique_buffer<mutable_buffer> buf
+	unique_buffer<mutable_buffer> buf
 	{
 		request.head.content_length
 	};
 
 	copy(buf, request.content);
-	client.content_consumed += read_all(*client.sock, buf + client.content_consumed);
+	if(client.content_consumed < request.head.content_length)
+		client.content_consumed += read_all(*client.sock, buf + client.content_consumed);
+
 	assert(client.content_consumed == request.head.content_length);
 
 	const size_t written
@@ -78,6 +80,10 @@ post__upload(client &client,
 		m::media::file::write(room, request.user_id, buf, content_type, filename)
 	};
 
+	// The content is handed off to generate the configured thumbnail sizes
+	// in the background; the buffer must not be used after this point.
+	m::media::thumbnail::pregenerate(room.room_id, content_type, std::move(buf));
+
 	char uribuf[256];
 	const string_view content_uri
 	{